@@ -5,14 +5,17 @@
 #include "decimal128.h"
 #include "ion.h"
 
-PyObject* ionc_init_module(void);
-iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp);
-PyObject* ionc_read(PyObject* self, PyObject *args, PyObject *kwds);
-
 enum ContainerType { LIST, MULTIMAP, STD_DICT };
 
-iERR ionc_read_all(hREADER hreader, PyObject* container, enum ContainerType parent_type, uint8_t value_model);
-iERR ionc_read_value(hREADER hreader, ION_TYPE t, PyObject* container, enum ContainerType parent_type, uint8_t value_model);
+typedef struct _ion_read_context _ION_READ_CONTEXT;
+typedef struct _ion_write_context _ION_WRITE_CONTEXT;
+
+int ionc_module_exec(PyObject* m);
+iERR ionc_write_value(hWRITER writer, PyObject* obj, _ION_WRITE_CONTEXT* context);
+PyObject* ionc_read(PyObject* self, PyObject *args, PyObject *kwds);
+
+iERR ionc_read_all(hREADER hreader, PyObject* container, enum ContainerType parent_type, _ION_READ_CONTEXT* context);
+iERR ionc_read_value(hREADER hreader, ION_TYPE t, PyObject* container, enum ContainerType parent_type, _ION_READ_CONTEXT* context);
 
 iERR _ion_writer_write_symbol_id_helper(ION_WRITER *pwriter, SID value);
 iERR _ion_writer_add_annotation_sid_helper(ION_WRITER *pwriter, SID sid);
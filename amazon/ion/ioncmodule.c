@@ -5,6 +5,27 @@
 #include "datetime.h"
 #include "_ioncmodule.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#ifdef IONC_WITH_ZLIB
+#include <zlib.h>
+#define IONC_ZLIB_SUPPORTED 1
+#else
+#define IONC_ZLIB_SUPPORTED 0
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define IONC_CYCLE_COUNTER_SUPPORTED 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define IONC_CYCLE_COUNTER_SUPPORTED 1
+#else
+#define IONC_CYCLE_COUNTER_SUPPORTED 0
+#endif
+
 #define cRETURN RETURN(__location_name__, __line__, __count__++, err)
 
 #define YEAR_PRECISION 0
@@ -22,97 +43,374 @@
 #define ANNOTATION_MAX_LEN 50
 
 #define IONC_STREAM_READ_BUFFER_SIZE 1024*32
-
-static char _err_msg[ERR_MSG_MAX_LEN];
+#define IONC_STREAM_MAX_READ_SIZE 1024*1024*1024
+#define IONC_STREAM_WRITE_BUFFER_SIZE 1024*64
+#define IONC_STREAM_COMPRESSED_READ_SIZE 1024*256
+#define IONC_STREAM_INFLATE_BUFFER_SIZE 1024*1024
+#define IONC_WRITE_FLUSH_VALUE_COUNT 256
+#define IONC_PRETTY_PRINT_BUFFER_SIZE 1024*4
+
+#define IONC_SYMBOL_CACHE_SIZE 256 // must be a power of two
+#define IONC_SYMBOL_CACHE_MAX_LEN 128
+#define IONC_FIELD_SID_CACHE_SIZE 256 // must be a power of two
+#define IONC_READ_TEMP_KEEP_SIZE 1024*64
+#define IONC_BIG_INT_STACK_BYTES 64 // enough for the magnitude of a 512 bit int
+
+#if defined(_MSC_VER)
+#define IONC_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define IONC_THREAD_LOCAL __thread
+#else
+#define IONC_THREAD_LOCAL _Thread_local
+#endif
+
+// Per thread: the GIL is released while ion-c reads and writes, so concurrent calls may fail at the same time.
+static IONC_THREAD_LOCAL char _err_msg[ERR_MSG_MAX_LEN];
+
+// Free-threaded builds have no GIL to serialize the changes to the module state and to the module's objects, so they
+// are made while holding a PyMutex. It is not released with the GIL, so it also covers the parts of a read or write
+// that run detached. With the GIL the locks compile to nothing.
+#ifdef Py_GIL_DISABLED
+typedef PyMutex _IONC_MUTEX;
+#define IONC_LOCK(mutex) PyMutex_Lock(&(mutex))
+#define IONC_UNLOCK(mutex) PyMutex_Unlock(&(mutex))
+#else
+typedef BYTE _IONC_MUTEX; // unused
+#define IONC_LOCK(mutex)
+#define IONC_UNLOCK(mutex)
+#endif
 
 #define _FAILWITHMSG(x, msg) { err = x; snprintf(_err_msg, ERR_MSG_MAX_LEN, msg); goto fail; }
 
 #define IONC_BYTES_FORMAT "y#"
-#define IONC_READ_ARGS_FORMAT "ObO"
-
-static PyObject* IONC_STREAM_BYTES_READ_SIZE;
-
-static PyObject* _decimal_module;
-static PyObject* _decimal_constructor;
-static PyObject* _decimal_zero;
-static PyObject* _py_timestamp_cls;
-static PyObject* _py_timestamp__new__;
-static PyObject* _simpletypes_module;
-static PyObject* _ionpynull_cls;
-static PyObject* _ionpybool_cls;
-static PyObject* _ionpyint_cls;
-static PyObject* _ionpyfloat_cls;
-static PyObject* _ionpydecimal_cls;
-static PyObject* _ionpytimestamp_cls;
-static PyObject* _ionpytext_cls;
-static PyObject* _ionpysymbol_cls;
-static PyObject* _ionpybytes_cls;
-static PyObject* _ionpylist_cls;
-static PyObject* _ionpydict_cls;
-static PyObject* _ionpystddict_cls;
-
-static PyObject* _ionpynull_fromvalue;
-static PyObject* _ionpybool_fromvalue;
-static PyObject* _ionpyint_fromvalue;
-static PyObject* _ionpyfloat_fromvalue;
-static PyObject* _ionpydecimal_fromvalue;
-static PyObject* _ionpytimestamp_fromvalue;
-static PyObject* _ionpytext_fromvalue;
-static PyObject* _ionpysymbol_fromvalue;
-static PyObject* _ionpybytes_fromvalue;
-static PyObject* _ionpylist_fromvalue;
-static PyObject* _ionpydict_factory;
-static PyObject* _ionpylist_factory;
-
-static PyObject* _ion_core_module;
-static PyObject* _py_ion_type;
-static PyObject* py_ion_type_table[14];
-static int  c_ion_type_table[14];
-static PyObject* _py_timestamp_precision;
-static PyObject* py_ion_timestamp_precision_table[7];
-static PyObject* _ion_symbols_module;
-static PyObject* _py_symboltoken_constructor;
-static PyObject* _exception_module;
-static PyObject* _ion_exception_cls;
-static decContext dec_context;
-static PyObject* ion_type_str;
-static PyObject* ion_annotations_str;
-static PyObject* text_str;
-static PyObject* sid_str;
-static PyObject* precision_str;
-static PyObject* fractional_seconds_str;
-static PyObject* exponent_str;
-static PyObject* digits_str;
-static PyObject* fractional_precision_str;
-static PyObject* store_str;
+#define IONC_READ_ARGS_FORMAT "ObO|OOnnz"
+#define IONC_CATALOG_CAPSULE_NAME "amazon.ion.ionc.catalog"
+
+#ifdef IONC_ENABLE_USDT
+// Build with -DIONC_ENABLE_USDT to add the static probes ionc:refill(bytes), ionc:flush(bytes) and
+// ionc:value(ion_type) for perf, bpftrace or dtrace, whether or not the counters are enabled.
+#include <sys/sdt.h>
+#define IONC_PROBE1(name, arg) DTRACE_PROBE1(ionc, name, arg)
+#else
+#define IONC_PROBE1(name, arg)
+#endif
+
+#define IONC_STATS_TYPE_COUNT 14 // one per ion type, indexed by the type's id >> 8
+
+// Counters of the reads and writes of every thread of an interpreter, only kept while enabled by ionc_stats_enable.
+// They are only updated while holding the GIL, and the stats_mutex of the module state. Build with
+// -DIONC_DISABLE_STATS to compile them out.
+typedef struct {
+    uint64_t refills; // calls made by ion_read_file_stream_handler to the python file
+    uint64_t refill_bytes;
+    uint64_t refill_nanos;
+    uint64_t flushes; // chunks passed to the python file's write method
+    uint64_t flush_bytes;
+    uint64_t flush_nanos;
+    uint64_t values[IONC_STATS_TYPE_COUNT]; // the python values built
+    uint64_t wrappers; // the IonPy objects built around them
+    uint64_t decimal_nanos; // converting decimals to python
+    uint64_t timestamp_nanos; // converting timestamps to python
+    uint64_t allocations; // heap allocations of read buffers and temporaries
+} _IONC_STATS;
+
+// Ion utc offsets are whole minutes in (-24h, 24h).
+#define IONC_TIMEZONE_CACHE_SIZE (2 * 24 * 60 - 1)
+
+// The state of one instance of the module, of which each interpreter that imports it has its own. The python objects
+// belong to that interpreter, so they are never shared with another. Reached through PyModule_GetState by the module's
+// functions, and through the contexts and stream handles of the reads and writes they start.
+typedef struct {
+    // The module's types, created from their specs by ionc_module_exec.
+    PyObject* writer_type;
+    PyObject* read_iterator_type;
+    PyObject* lazy_tape_type;
+    PyObject* column_type;
+    // The classes python values are read into and written from.
+    PyObject* decimal_constructor;
+    PyObject* decimal_zero;
+    PyObject* py_timestamp_cls;
+    PyObject* ionpynull_cls;
+    PyObject* ionpybool_cls;
+    PyObject* ionpyint_cls;
+    PyObject* ionpyfloat_cls;
+    PyObject* ionpydecimal_cls;
+    PyObject* ionpytimestamp_cls;
+    PyObject* ionpytext_cls;
+    PyObject* ionpysymbol_cls;
+    PyObject* ionpybytes_cls;
+    PyObject* ionpylist_cls;
+    PyObject* ionpydict_cls;
+    PyObject* ionpystddict_cls;
+    PyObject* ionpylazydict_cls;
+    PyObject* ionpylazylist_cls;
+    PyObject* ionpytimestamp_fromvalue;
+    PyObject* py_symboltoken_constructor;
+    PyObject* ion_exception_cls;
+    PyObject* py_ion_type_table[14];
+    PyObject* py_ion_timestamp_precision_table[7];
+    // The attribute names that are looked up per value.
+    PyObject* ion_type_str;
+    PyObject* ion_annotations_str;
+    PyObject* text_str;
+    PyObject* sid_str;
+    PyObject* precision_str;
+    PyObject* fractional_seconds_str;
+    PyObject* exponent_str;
+    PyObject* digits_str;
+    PyObject* fractional_precision_str;
+    PyObject* store_str;
+    PyObject* write_str;
+    PyObject* name_str;
+    PyObject* empty_tuple;
+    PyObject* version_str;
+    PyObject* ionc_catalog_str;
+    PyObject* tape_str;
+    PyObject* tape_index_str;
+    PyObject* readinto_str;
+    // The datetime.timezone of each utc offset read so far, see ionc_get_timezone.
+    PyObject* timezone_cache[IONC_TIMEZONE_CACHE_SIZE];
+    // Every field above is a strong reference, or NULL; ionc_module_traverse and ionc_module_clear walk them as one
+    // array, which ends here.
+    decContext dec_context; // the template of every reader's and writer's context; never modified after exec
+    _IONC_STATS stats;
+    BOOL stats_enabled;
+    // Bytes-like input longer than this is streamed to ion-c in chunks of this size. Only lowered by tests, through
+    // ionc_set_max_buffer_len, to cover the chunked reads without gigabytes of input.
+    Py_ssize_t max_buffer_len;
+    _IONC_MUTEX stats_mutex;
+    _IONC_MUTEX timezone_cache_mutex;
+} _IONC_MODULE_STATE;
+
+#define IONC_MODULE_STATE_OBJECT_COUNT (offsetof(_IONC_MODULE_STATE, dec_context) / sizeof(PyObject*))
+
+static _IONC_MODULE_STATE* ionc_module_state(PyObject* module) {
+    return (_IONC_MODULE_STATE*) PyModule_GetState(module);
+}
+
+#if PY_VERSION_HEX < 0x03090000
+// Before 3.9 a type can't find the module that created it, so there can only be one instance of the module at a time,
+// see ionc_module_exec. Borrowed; cleared again when the module is freed.
+static PyObject* _ionc_module;
+#endif
+
+/*
+ *  Returns the state of the module that created one of the module's types.
+ */
+static _IONC_MODULE_STATE* ionc_type_state(PyTypeObject* type) {
+#if PY_VERSION_HEX >= 0x03090000
+    return (_IONC_MODULE_STATE*) PyType_GetModuleState(type);
+#else
+    return ionc_module_state(_ionc_module);
+#endif
+}
+
+// Like the static types they replaced, the module's types can't be changed from python, and only the Writer can be
+// created from it.
+#ifdef Py_TPFLAGS_IMMUTABLETYPE
+#define IONC_TPFLAGS (Py_TPFLAGS_DEFAULT | Py_TPFLAGS_IMMUTABLETYPE)
+#else
+#define IONC_TPFLAGS Py_TPFLAGS_DEFAULT
+#endif
+#ifdef Py_TPFLAGS_DISALLOW_INSTANTIATION
+#define IONC_TPFLAGS_INTERNAL (IONC_TPFLAGS | Py_TPFLAGS_DISALLOW_INSTANTIATION)
+#else
+#define IONC_TPFLAGS_INTERNAL IONC_TPFLAGS
+#endif
+
+// The ion-c type of each amazon.ion.core.IonType, indexed by its value.
+static const int c_ion_type_table[14] = {
+    tid_NULL_INT, tid_BOOL_INT, tid_INT_INT, tid_FLOAT_INT, tid_DECIMAL_INT, tid_TIMESTAMP_INT, tid_SYMBOL_INT,
+    tid_STRING_INT, tid_CLOB_INT, tid_BLOB_INT, tid_LIST_INT, tid_SEXP_INT, tid_STRUCT_INT
+};
+
+/*
+ *  Returns a monotonic clock in nanoseconds.
+ */
+static uint64_t ionc_nanos(void) {
+#ifdef _WIN32
+    LARGE_INTEGER now, frequency;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// The counters are those of the module state 'state'.
+#ifdef IONC_DISABLE_STATS
+#define IONC_STAT_ADD(state, field, n)
+#define IONC_STAT_TIMER_START(state, started) uint64_t started = 0
+#define IONC_STAT_TIMER_STOP(state, field, started)
+#else
+#define IONC_STAT_ADD(state, field, n) { \
+    if ((state)->stats_enabled) { \
+        IONC_LOCK((state)->stats_mutex); \
+        (state)->stats.field += (n); \
+        IONC_UNLOCK((state)->stats_mutex); \
+    } \
+}
+// A timer started while the counters were disabled is never stopped, so enabling them mid-call adds no garbage.
+#define IONC_STAT_TIMER_START(state, started) uint64_t started = (state)->stats_enabled ? ionc_nanos() : 0
+#define IONC_STAT_TIMER_STOP(state, field, started) { \
+    if ((state)->stats_enabled && started) IONC_STAT_ADD(state, field, ionc_nanos() - started); \
+}
+#endif
+#define IONC_STAT_VALUE(state, ion_type) { \
+    IONC_PROBE1(value, ion_type); \
+    if (((ion_type) >> 8) < IONC_STATS_TYPE_COUNT) IONC_STAT_ADD(state, values[(ion_type) >> 8], 1); \
+}
 
 typedef struct {
+    _IONC_MODULE_STATE *state; // of the module whose read opened the stream
     PyObject *py_file; // a TextIOWrapper-like object
-    BYTE buffer[IONC_STREAM_READ_BUFFER_SIZE];
+    BOOL use_readinto; // a binary file, read straight into 'buffer'
+    BYTE *buffer; // allocated on the first read
+    Py_ssize_t buffer_capacity;
+    Py_ssize_t read_size; // the bytes, or for text the characters, asked for by each read
+    Py_ssize_t max_read_size; // while larger than read_size, read_size doubles as long as the throughput rises
+    double throughput; // bytes per second of the last full read, while the read size is adapting
+    // Compressed input only, read by ion_read_inflate_stream_handler.
+    struct z_stream_s *inflater; // NULL for uncompressed input
+    PyObject *compressed_chunk; // the bytes last read from py_file, which the inflater reads from
+    Py_buffer *compressed_source; // all of the compressed input, when it is a pinned buffer rather than py_file
+    Py_ssize_t compressed_offset; // how much of compressed_source has been handed to the inflater
+    BOOL compressed_eof; // all the compressed input has been handed to the inflater
+    BOOL at_member_end; // the inflater has finished a gzip member, or zlib stream, and has not started another
 } _ION_READ_STREAM_HANDLE;
 
+// A bytes-like input too long for ion_reader_open_buffer, whose length is a 32-bit SIZE. It is handed to ion-c in
+// place, a chunk at a time, by ion_read_pinned_stream_handler.
+typedef struct {
+    BYTE *next; // the start of the next chunk
+    Py_ssize_t remaining;
+    Py_ssize_t chunk_size;
+} _ION_PINNED_STREAM;
+
+// Re-indents the compact text ion-c writes the way the Python text writer pretty-prints, see ionc_pretty_print.
+typedef struct {
+    BYTE *indent; // the UTF-8 indent written once per level of nesting
+    SIZE indent_len;
+    BYTE *containers; // the open char of each container entered, innermost last
+    SIZE depth;
+    SIZE containers_capacity;
+    BOOL has_children; // the innermost container, or the top level, has had a value already
+    int state;
+    BYTE quote; // the quote that ends the quoted text being copied
+    int after_quote; // the state to return to after the quoted text
+    BYTE out[IONC_PRETTY_PRINT_BUFFER_SIZE];
+    SIZE out_len;
+} _IONC_PRETTY_PRINTER;
+
+typedef struct {
+    _IONC_MODULE_STATE *state; // of the module whose write opened the stream
+    PyObject *py_file; // an object with a write method, or NULL to accumulate the output in 'chunk'
+    PyObject *chunk; // the bytes object currently being filled
+    SIZE chunk_len; // the number of bytes of 'chunk' that have been filled
+    SIZE chunk_capacity; // the allocated size of 'chunk'
+    struct z_stream_s *deflater; // compresses the output on its way into the chunks, or NULL
+    _IONC_PRETTY_PRINTER *pretty_printer; // re-indents the text output on its way into the chunks, or NULL
+    BOOL discard; // the write failed: whatever ion-c still hands over while it closes is dropped
+} _ION_WRITE_STREAM_HANDLE;
+
+typedef struct {
+    PyObject *key; // the field name str, a strong reference
+    SID sid;
+} _ION_FIELD_SID_CACHE_ENTRY;
+
+// State shared by everything written through one writer.
+struct _ion_write_context {
+    _IONC_MODULE_STATE* state; // of the module whose write started the context
+    PyObject* tuple_as_sexp;
+    // Binary writers only: a direct-mapped cache, keyed by str identity, of the SIDs the writer has assigned to field
+    // names. The fields of repeated records are then written by SID without a symbol table lookup of their text.
+    BOOL cache_field_sids;
+    _ION_FIELD_SID_CACHE_ENTRY field_sids[IONC_FIELD_SID_CACHE_SIZE];
+    // The writer's own copy of the module's decimal context, whose status flags the decimal conversions change.
+    decContext dec_context;
+};
+
+typedef struct {
+    PyObject_HEAD
+    hWRITER writer;
+    ION_STREAM *ion_stream;
+    _ION_WRITE_CONTEXT context;
+    BOOL initialized; // __init__ has run, whether or not it succeeded
+    BOOL closed;
+    BOOL failed; // a write or flush failed, which closed the writer
+    _ION_WRITE_STREAM_HANDLE stream_handle;
+    _IONC_MUTEX mutex; // held by write, flush and close
+} ionc_Writer;
+
+typedef struct {
+    PyObject *text; // the str for the cached symbol text
+    PyObject *symbol_token; // SymbolToken(text, None), created on first use
+} _ION_SYMBOL_CACHE_ENTRY;
+
+// State shared by everything read through one reader.
+struct _ion_read_context {
+    _IONC_MODULE_STATE* state; // of the module whose read started the context
+    uint8_t value_model;
+    // Set, and borrowed, while building from a tape with IonPyValueModel.LAZY: containers are then built as proxies
+    // that decode their children from this tape on access.
+    PyObject* lazy_tape;
+    // The field projection of the struct being read, or NULL to read every field: a dict of each field to read to the
+    // projection of its value, where None reads the whole value. Borrowed; only changes while a field is being read.
+    PyObject* fields;
+    // Direct-mapped cache of field names, annotations and symbol values, keyed by their text.
+    _ION_SYMBOL_CACHE_ENTRY symbol_cache[IONC_SYMBOL_CACHE_SIZE];
+    // Memory for the temporaries of reading a value (annotation arrays, big int and wide decimal text), reused from
+    // value to value instead of a heap allocation each. See ionc_read_temp.
+    BYTE* temp;
+    size_t temp_capacity;
+    // The reader's own copy of the module's decimal context, used to convert its timestamps. Set by the read
+    // iterator; values built from a tape use the tape's instead.
+    decContext dec_context;
+};
+
 typedef struct {
     PyObject_HEAD
     hREADER reader;
     ION_READER_OPTIONS _reader_options;
     BOOL closed;
-    uint8_t value_model;
+    _ION_READ_CONTEXT context;
+    PyObject *catalog; // a capsule holding the ion-c catalog used by the reader, or NULL
+    PyObject *fields; // the field projection of the top-level values, or NULL
+    Py_buffer buffer; // the input when it is a bytes-like object, read in place; buffer.obj is NULL for a file
+    PyObject *scratch; // an empty list that next() reads each value into
     _ION_READ_STREAM_HANDLE file_handler_state;
+    _ION_PINNED_STREAM pinned_stream; // only used for a buffer longer than the module's max_buffer_len
+    _IONC_MUTEX mutex; // held by next and next_batch
 } ionc_read_Iterator;
 
 PyObject* ionc_read_iter(PyObject *self);
 PyObject* ionc_read_iter_next(PyObject *self);
+PyObject* ionc_read_iter_next_batch(PyObject *self, PyObject *arg);
 void ionc_read_iter_dealloc(PyObject *self);
 
-static PyTypeObject ionc_read_IteratorType = {
-    PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "ionc_read.Iterator",
-    .tp_basicsize = sizeof(ionc_read_Iterator),
-    .tp_flags = Py_TPFLAGS_DEFAULT,
-    .tp_doc = "Internal ION iterator object.",
-    .tp_iter = ionc_read_iter,
-    .tp_iternext = ionc_read_iter_next,
-    .tp_dealloc = ionc_read_iter_dealloc
+static PyMethodDef ionc_read_iter_methods[] = {
+    {"next_batch", (PyCFunction)ionc_read_iter_next_batch, METH_O,
+     "Returns a list of up to n of the next values, all the remaining values if n is negative, or [] at the end."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyType_Slot ionc_read_iterator_slots[] = {
+    {Py_tp_doc, "Internal ION iterator object."},
+    {Py_tp_iter, ionc_read_iter},
+    {Py_tp_iternext, ionc_read_iter_next},
+    {Py_tp_dealloc, ionc_read_iter_dealloc},
+    {Py_tp_methods, ionc_read_iter_methods},
+    {0, NULL}
+};
+
+static PyType_Spec ionc_read_iterator_spec = {
+    .name = "ionc_read.Iterator",
+    .basicsize = sizeof(ionc_read_Iterator),
+    .flags = IONC_TPFLAGS_INTERNAL,
+    .slots = ionc_read_iterator_slots
 };
 
 /******************************************************************************
@@ -140,27 +438,24 @@ static int int_attr_by_name(PyObject* obj, PyObject* attr_name) {
 }
 
 // an Alternative to calculate timedelta, see https://github.com/amazon-ion/ion-python/issues/225
+// Reads the normalized days and seconds of the timedelta directly; utc offsets never carry microseconds.
 static int offset_seconds(PyObject* timedelta) {
-    PyObject* py_seconds = PyObject_CallMethod(timedelta, "total_seconds", NULL);
-    PyObject* py_seconds_int = PyObject_CallMethod(py_seconds, "__int__", NULL);
-    int seconds = (int)PyLong_AsSsize_t(py_seconds_int);
-    Py_DECREF(py_seconds);
-    Py_DECREF(py_seconds_int);
-    return seconds;
+    return PyDateTime_DELTA_GET_DAYS(timedelta) * 86400 + PyDateTime_DELTA_GET_SECONDS(timedelta);
 }
 
 /*
  *  Returns the ion type of an object as an int
  *
  *  Args:
+ *      state: The state of the module
  *      obj: An object whose type will be returned
  *
  *  Returns:
  *      An int in 'c_ion_type_table' representing an ion type
  */
-static int ion_type_from_py(PyObject* obj) {
+static int ion_type_from_py(_IONC_MODULE_STATE* state, PyObject* obj) {
     PyObject* ion_type = NULL;
-    ion_type = PyObject_GetAttr(obj, ion_type_str);
+    ion_type = PyObject_GetAttr(obj, state->ion_type_str);
     if (ion_type == NULL) {
         PyErr_Clear();
         return tid_none_INT;
@@ -226,7 +521,7 @@ static PyObject* ion_build_py_string(ION_STRING* string_value) {
  *  Returns:
  *      A python symbol token
  */
-static PyObject* ion_string_to_py_symboltoken(ION_STRING* string_value) {
+static PyObject* ion_string_to_py_symboltoken(_IONC_MODULE_STATE* state, ION_STRING* string_value) {
     PyObject* py_string_value, *py_sid, *return_value;
     if (string_value->value) {
         py_string_value = ion_build_py_string(string_value);
@@ -237,7 +532,7 @@ static PyObject* ion_string_to_py_symboltoken(ION_STRING* string_value) {
         py_sid = PyLong_FromLong(0);
     }
     return_value = PyObject_CallFunctionObjArgs(
-        _py_symboltoken_constructor,
+        state->py_symboltoken_constructor,
         py_string_value,
         py_sid,
         NULL
@@ -247,6 +542,274 @@ static PyObject* ion_string_to_py_symboltoken(ION_STRING* string_value) {
     return return_value;
 }
 
+/*
+ *  Finds the symbol cache entry for a piece of text, replacing whatever the entry held before on a miss.
+ *
+ *  Args:
+ *      context:  The read context that owns the cache
+ *      string_value:  An ION_STRING with non-null text
+ *
+ *  Returns:
+ *      The entry, or NULL if the text is not cacheable
+ */
+static _ION_SYMBOL_CACHE_ENTRY* ionc_symbol_cache_lookup(_ION_READ_CONTEXT* context, ION_STRING* string_value) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    Py_ssize_t cached_len;
+    const char* cached_text;
+    int i;
+    if (string_value->length > IONC_SYMBOL_CACHE_MAX_LEN) {
+        return NULL;
+    }
+    for (i = 0; i < string_value->length; i++) {
+        hash = (hash ^ string_value->value[i]) * 16777619u;
+    }
+    _ION_SYMBOL_CACHE_ENTRY* entry = &context->symbol_cache[hash & (IONC_SYMBOL_CACHE_SIZE - 1)];
+    if (entry->text != NULL) {
+        // The UTF-8 form of a str is cached on it, and is its own data for ASCII text.
+        cached_text = PyUnicode_AsUTF8AndSize(entry->text, &cached_len);
+        if (cached_text != NULL && cached_len == string_value->length
+                && memcmp(cached_text, string_value->value, cached_len) == 0) {
+            return entry;
+        }
+        Py_CLEAR(entry->text);
+        Py_CLEAR(entry->symbol_token);
+    }
+    entry->text = PyUnicode_FromStringAndSize((char*)(string_value->value), string_value->length);
+    if (entry->text == NULL) {
+        // Let the uncached path raise the error.
+        PyErr_Clear();
+        return NULL;
+    }
+    return entry;
+}
+
+/*
+ *  Like ion_build_py_string, but reuses the str of recently read symbol text.
+ */
+static PyObject* ion_build_py_symbol_text(_ION_READ_CONTEXT* context, ION_STRING* string_value) {
+    if (!string_value->value) return Py_None;
+    _ION_SYMBOL_CACHE_ENTRY* entry = ionc_symbol_cache_lookup(context, string_value);
+    if (entry == NULL) {
+        return ion_build_py_string(string_value);
+    }
+    Py_INCREF(entry->text);
+    return entry->text;
+}
+
+/*
+ *  Like ion_string_to_py_symboltoken, but reuses the SymbolToken of recently read symbol text.
+ */
+static PyObject* ion_string_to_py_symboltoken_cached(_ION_READ_CONTEXT* context, ION_STRING* string_value) {
+    _ION_SYMBOL_CACHE_ENTRY* entry = NULL;
+    if (string_value->value) {
+        entry = ionc_symbol_cache_lookup(context, string_value);
+    }
+    if (entry == NULL) {
+        return ion_string_to_py_symboltoken(context->state, string_value);
+    }
+    if (entry->symbol_token == NULL) {
+        entry->symbol_token = PyObject_CallFunctionObjArgs(context->state->py_symboltoken_constructor, entry->text,
+                                                           Py_None, NULL);
+        if (entry->symbol_token == NULL) {
+            return NULL;
+        }
+    }
+    Py_INCREF(entry->symbol_token);
+    return entry->symbol_token;
+}
+
+/*
+ *  Releases everything held by the symbol cache of a read context.
+ */
+static void ionc_symbol_cache_clear(_ION_READ_CONTEXT* context) {
+    int i;
+    for (i = 0; i < IONC_SYMBOL_CACHE_SIZE; i++) {
+        Py_CLEAR(context->symbol_cache[i].text);
+        Py_CLEAR(context->symbol_cache[i].symbol_token);
+    }
+    PyMem_Free(context->temp);
+    context->temp = NULL;
+    context->temp_capacity = 0;
+}
+
+/*
+ *  Builds a python int from the big-endian bytes of its magnitude, in linear time.
+ */
+static PyObject* ionc_int_from_abs_bytes(const BYTE* bytes, SIZE len, BOOL is_negative) {
+#if PY_VERSION_HEX >= 0x030D0000
+    PyObject* magnitude = PyLong_FromUnsignedNativeBytes(bytes, len, Py_ASNATIVEBYTES_BIG_ENDIAN);
+#else
+    PyObject* magnitude = _PyLong_FromByteArray(bytes, (size_t)len, 0, 0);
+#endif
+    if (magnitude == NULL || !is_negative) {
+        return magnitude;
+    }
+    PyObject* value = PyNumber_Negative(magnitude);
+    Py_DECREF(magnitude);
+    return value;
+}
+
+/*
+ *  Returns the context's temporary memory, grown to at least 'size' bytes, or NULL when out of memory. It holds one
+ *  temporary at a time: its contents are only good until the next call.
+ */
+static void* ionc_read_temp(_ION_READ_CONTEXT* context, size_t size) {
+    if (size > context->temp_capacity) {
+        size_t capacity = context->temp_capacity ? context->temp_capacity * 2 : 256;
+        while (capacity < size) capacity *= 2;
+        // Nothing in it needs to survive, so there is no point in a realloc copying it.
+        PyMem_Free(context->temp);
+        context->temp = (BYTE*)PyMem_Malloc(capacity);
+        context->temp_capacity = context->temp ? capacity : 0;
+        IONC_STAT_ADD(context->state, allocations, 1);
+    }
+    return context->temp;
+}
+
+/*
+ *  Called after each top-level value. The temporary memory is kept for the next value unless an unusually large one
+ *  grew it past IONC_READ_TEMP_KEEP_SIZE.
+ */
+static void ionc_read_temp_reset(_ION_READ_CONTEXT* context) {
+    if (context->temp_capacity > IONC_READ_TEMP_KEEP_SIZE) {
+        PyMem_Free(context->temp);
+        context->temp = NULL;
+        context->temp_capacity = 0;
+    }
+}
+
+
+/*
+ *  Adds a shared symbol table to an ion-c catalog. The table's memory is owned by the catalog.
+ *
+ *  Args:
+ *      catalog:  An ion-c catalog
+ *      py_table:  A shared amazon.ion.symbols.SymbolTable
+ *      symtab_out:  The ion-c copy of the table
+ *
+ */
+static iERR ionc_catalog_add_py_table(_IONC_MODULE_STATE* state, hCATALOG catalog, PyObject* py_table,
+                                      hSYMTAB* symtab_out) {
+    iENTER;
+    hSYMTAB symtab = NULL;
+    PyObject *py_name = NULL, *py_version = NULL, *tokens = NULL, *token = NULL, *text = NULL;
+    ION_STRING string_value;
+    SID sid;
+
+    py_name = PyObject_GetAttr(py_table, state->name_str);
+    py_version = PyObject_GetAttr(py_table, state->version_str);
+    if (py_name == NULL || py_version == NULL || !PyUnicode_Check(py_name) || !PyLong_Check(py_version)) {
+        PyErr_Clear();
+        _FAILWITHMSG(IERR_INVALID_ARG, "Only shared symbol tables may be imported or registered in a catalog");
+    }
+
+    IONCHECK(ion_symbol_table_open_with_type(&symtab, catalog, ist_SHARED));
+    IONCHECK(ion_string_from_py(py_name, &string_value));
+    IONCHECK(ion_symbol_table_set_name(symtab, &string_value));
+    IONCHECK(ion_symbol_table_set_version(symtab, PyLong_AsLong(py_version)));
+
+    tokens = PyObject_GetIter(py_table);
+    if (tokens == NULL) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    while ((token = PyIter_Next(tokens)) != NULL) {
+        text = PyObject_GetAttr(token, state->text_str);
+        Py_CLEAR(token);
+        if (text == NULL) {
+            FAILWITH(IERR_INVALID_ARG);
+        }
+        if (text == Py_None) {
+            // A symbol with unknown text still occupies its SID.
+            ION_STRING_INIT(&string_value);
+        }
+        else {
+            IONCHECK(ion_string_from_py(text, &string_value));
+        }
+        IONCHECK(ion_symbol_table_add_symbol(symtab, &string_value, &sid));
+        Py_CLEAR(text);
+    }
+    if (PyErr_Occurred()) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    IONCHECK(ion_symbol_table_lock(symtab));
+    IONCHECK(ion_catalog_add_symbol_table(catalog, symtab));
+    if (symtab_out) {
+        *symtab_out = symtab;
+    }
+
+fail:
+    Py_XDECREF(py_name);
+    Py_XDECREF(py_version);
+    Py_XDECREF(tokens);
+    Py_XDECREF(token);
+    Py_XDECREF(text);
+    cRETURN;
+}
+
+static void ionc_catalog_capsule_destructor(PyObject* capsule) {
+    hCATALOG catalog = (hCATALOG) PyCapsule_GetPointer(capsule, IONC_CATALOG_CAPSULE_NAME);
+    if (catalog != NULL) {
+        ion_catalog_close(catalog);
+    }
+}
+
+/*
+ *  Gets the ion-c catalog for an amazon.ion.symbols.SymbolTableCatalog. It is built on first use and cached on the
+ *  catalog instance, which drops it again when another table is registered.
+ *
+ *  Args:
+ *      py_catalog:  A SymbolTableCatalog
+ *      capsule_out:  A new reference to a capsule holding the ion-c catalog
+ *
+ */
+static iERR ionc_catalog_from_py(_IONC_MODULE_STATE* state, PyObject* py_catalog, PyObject** capsule_out) {
+    iENTER;
+    hCATALOG catalog = NULL;
+    PyObject *capsule = NULL, *tables = NULL, *table = NULL;
+
+    capsule = PyObject_GetAttr(py_catalog, state->ionc_catalog_str);
+    if (capsule != NULL && PyCapsule_IsValid(capsule, IONC_CATALOG_CAPSULE_NAME)) {
+        *capsule_out = capsule;
+        capsule = NULL;
+        SUCCEED();
+    }
+    PyErr_Clear();
+    Py_CLEAR(capsule);
+
+    IONCHECK(ion_catalog_open(&catalog));
+    tables = PyObject_GetIter(py_catalog);
+    if (tables == NULL) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    while ((table = PyIter_Next(tables)) != NULL) {
+        IONCHECK(ionc_catalog_add_py_table(state, catalog, table, NULL));
+        Py_CLEAR(table);
+    }
+    if (PyErr_Occurred()) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+
+    capsule = PyCapsule_New(catalog, IONC_CATALOG_CAPSULE_NAME, ionc_catalog_capsule_destructor);
+    if (capsule == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    catalog = NULL; // now owned by the capsule
+    if (PyObject_SetAttr(py_catalog, state->ionc_catalog_str, capsule) < 0) {
+        // Not cacheable, e.g. a catalog-like object with __slots__; it is simply rebuilt next time.
+        PyErr_Clear();
+    }
+    *capsule_out = capsule;
+    capsule = NULL;
+
+fail:
+    if (catalog != NULL) {
+        ion_catalog_close(catalog);
+    }
+    Py_XDECREF(capsule);
+    Py_XDECREF(tables);
+    Py_XDECREF(table);
+    cRETURN;
+}
 
 /******************************************************************************
 *       Write/Dump APIs                                                       *
@@ -260,13 +823,14 @@ static PyObject* ion_string_to_py_symboltoken(ION_STRING* string_value) {
  *      writer:  An ion writer
  *      symboltoken: A python symbol token
  *      is_value: Writes a symbol token value if is_value is TRUE, otherwise writes an annotation
+ *      context: The state of the writer
  *
  */
-static iERR ionc_write_symboltoken(hWRITER writer, PyObject* symboltoken, BOOL is_value) {
+static iERR ionc_write_symboltoken(hWRITER writer, PyObject* symboltoken, BOOL is_value, _ION_WRITE_CONTEXT* context) {
     iENTER;
-    PyObject* symbol_text = PyObject_GetAttr(symboltoken, text_str);
+    PyObject* symbol_text = PyObject_GetAttr(symboltoken, context->state->text_str);
     if (symbol_text == Py_None) {
-        PyObject* py_sid = PyObject_GetAttr(symboltoken, sid_str);
+        PyObject* py_sid = PyObject_GetAttr(symboltoken, context->state->sid_str);
         SID sid = PyLong_AsSsize_t(py_sid);
         if (is_value) {
             err = _ion_writer_write_symbol_id_helper(writer, sid);
@@ -297,12 +861,13 @@ static iERR ionc_write_symboltoken(hWRITER writer, PyObject* symboltoken, BOOL i
  *  Args:
  *      writer:  An ion writer
  *      obj: A sequence of ion python annotations
+ *      context: The state of the writer
  *
  */
-static iERR ionc_write_annotations(hWRITER writer, PyObject* obj) {
+static iERR ionc_write_annotations(hWRITER writer, PyObject* obj, _ION_WRITE_CONTEXT* context) {
     iENTER;
     PyObject* annotations = NULL;
-    annotations = PyObject_GetAttr(obj, ion_annotations_str);
+    annotations = PyObject_GetAttr(obj, context->state->ion_annotations_str);
     if (annotations == NULL || PyObject_Not(annotations)) {
         PyErr_Clear();
         // Proceed as if the attribute is not there.
@@ -321,8 +886,8 @@ static iERR ionc_write_annotations(hWRITER writer, PyObject* obj) {
             ion_string_from_py(pyAnnotation, &annotation);
             err = ion_writer_add_annotation(writer, &annotation);
         }
-        else if (PyObject_TypeCheck(pyAnnotation, (PyTypeObject*)_py_symboltoken_constructor)){
-            err = ionc_write_symboltoken(writer, pyAnnotation, /*is_value=*/FALSE);
+        else if (PyObject_TypeCheck(pyAnnotation, (PyTypeObject*)context->state->py_symboltoken_constructor)){
+            err = ionc_write_symboltoken(writer, pyAnnotation, /*is_value=*/FALSE, context);
         }
         Py_DECREF(pyAnnotation);
         if (err) break;
@@ -333,16 +898,51 @@ fail:
     cRETURN;
 }
 
+static void ionc_write_context_init(_ION_WRITE_CONTEXT* context, _IONC_MODULE_STATE* state, PyObject* tuple_as_sexp,
+                                    BOOL binary) {
+    memset(context, 0, sizeof(_ION_WRITE_CONTEXT));
+    context->state = state;
+    context->tuple_as_sexp = tuple_as_sexp;
+    context->cache_field_sids = binary;
+    context->dec_context = state->dec_context;
+}
+
+static void ionc_write_context_clear(_ION_WRITE_CONTEXT* context) {
+    for (int i = 0; i < IONC_FIELD_SID_CACHE_SIZE; i++) {
+        Py_CLEAR(context->field_sids[i].key);
+    }
+}
+
+/*
+ *  Records in the cache entry the SID the writer assigned to a field name it has just written.
+ */
+static iERR ionc_field_sid_cache_put(hWRITER writer, _ION_FIELD_SID_CACHE_ENTRY* entry, PyObject* key) {
+    iENTER;
+    hSYMTAB symtab;
+    ION_STRING field_name;
+    SID sid = UNKNOWN_SID;
+    IONCHECK(ion_string_from_py(key, &field_name));
+    IONCHECK(ion_writer_get_symbol_table(writer, &symtab));
+    IONCHECK(ion_symbol_table_find_by_name(symtab, &field_name, &sid));
+    if (sid > 0) {
+        Py_INCREF(key);
+        Py_XDECREF(entry->key);
+        entry->key = key;
+        entry->sid = sid;
+    }
+    iRETURN;
+}
+
 /*
  *  Writes a list or a sexp
  *
  *  Args:
  *      writer:  An ion writer
  *      sequence: An ion python list or sexp
- *      tuple_as_sexp: Decides if a tuple is treated as sexp
+ *      context: The state of the writer
  *
  */
-static iERR ionc_write_sequence(hWRITER writer, PyObject* sequence, PyObject* tuple_as_sexp) {
+static iERR ionc_write_sequence(hWRITER writer, PyObject* sequence, _ION_WRITE_CONTEXT* context) {
     iENTER;
     PyObject* child_obj = NULL;
     sequence = PySequence_Fast(sequence, "expected sequence");
@@ -354,7 +954,7 @@ static iERR ionc_write_sequence(hWRITER writer, PyObject* sequence, PyObject* tu
         Py_INCREF(child_obj);
 
         IONCHECK(Py_EnterRecursiveCall(" while writing an Ion sequence"));
-        err = ionc_write_value(writer, child_obj, tuple_as_sexp);
+        err = ionc_write_value(writer, child_obj, context);
         Py_LeaveRecursiveCall();
         IONCHECK(err);
 
@@ -372,22 +972,34 @@ fail:
  *      writer:  An ion writer
  *      key: The key of IonStruct item
  *      val: The value of IonStruct item
- *      tuple_as_sexp: Decides if a tuple is treated as sexp
+ *      context: The state of the writer
  */
 
-static iERR write_struct_field(hWRITER writer, PyObject* key, PyObject* val, PyObject* tuple_as_sexp) {
+static iERR write_struct_field(hWRITER writer, PyObject* key, PyObject* val, _ION_WRITE_CONTEXT* context) {
     iERR err;
+    _ION_FIELD_SID_CACHE_ENTRY* uncached = NULL;
     if (PyUnicode_Check(key)) {
-        ION_STRING field_name;
-        ion_string_from_py(key, &field_name);
-        IONCHECK(ion_writer_write_field_name(writer, &field_name));
+        _ION_FIELD_SID_CACHE_ENTRY* entry = context->cache_field_sids
+            ? &context->field_sids[((uintptr_t)key >> 4) & (IONC_FIELD_SID_CACHE_SIZE - 1)] : NULL;
+        if (entry != NULL && entry->key == key) {
+            IONCHECK(ion_writer_write_field_sid(writer, entry->sid));
+        } else {
+            ION_STRING field_name;
+            ion_string_from_py(key, &field_name);
+            IONCHECK(ion_writer_write_field_name(writer, &field_name));
+            uncached = entry;
+        }
     } else if (key == Py_None) {
         IONCHECK(_ion_writer_write_field_sid_helper(writer, 0));
     }
     IONCHECK(Py_EnterRecursiveCall(" while writing an Ion struct"));
-    err = ionc_write_value(writer, val, tuple_as_sexp);
+    err = ionc_write_value(writer, val, context);
     Py_LeaveRecursiveCall();
     IONCHECK(err);
+    if (uncached != NULL) {
+        // The writer has assigned the field name its SID by now.
+        IONCHECK(ionc_field_sid_cache_put(writer, uncached, key));
+    }
 
     iRETURN;
 }
@@ -398,19 +1010,28 @@ static iERR write_struct_field(hWRITER writer, PyObject* key, PyObject* val, PyO
  *  Args:
  *      writer:  An ion writer
  *      map: An ion python struct
- *      tuple_as_sexp: Decides if a tuple is treated as sexp
+ *      context: The state of the writer
  *
  */
-static iERR ionc_write_struct(hWRITER writer, PyObject* map, PyObject* tuple_as_sexp) {
+static iERR ionc_write_struct(hWRITER writer, PyObject* map, _ION_WRITE_CONTEXT* context) {
     iENTER;
-    PyObject *store = NULL, *key = NULL, *val_list = NULL, *val = NULL;
-    Py_ssize_t pos = 0, i, list_len;
+    PyObject *store = NULL, *key = NULL, *val_list = NULL, *val = NULL, *instance_dict = NULL;
+    Py_ssize_t pos = 0, i;
     if (PyDict_Check(map)) {
         while (PyDict_Next(map, &pos, &key, &val)) {
-            IONCHECK(write_struct_field(writer, key, val, tuple_as_sexp));
+            IONCHECK(write_struct_field(writer, key, val, context));
         }
     } else {
-        store = PyObject_GetAttr(map, store_str);
+        if (Py_TYPE(map) == (PyTypeObject*)context->state->ionpydict_cls) {
+            // An exact IonPyDict keeps its store in the instance dict, so skip the attribute lookup through the type.
+            // Subclasses may not: IonPyLazyDict makes it a property that decodes the struct.
+            instance_dict = PyObject_GenericGetDict(map, NULL);
+            store = instance_dict == NULL ? NULL : PyDict_GetItemWithError(instance_dict, context->state->store_str);
+            Py_XINCREF(store);
+        }
+        else {
+            store = PyObject_GetAttr(map, context->state->store_str);
+        }
         if (store == NULL || !PyDict_Check(store)) {
             _FAILWITHMSG(IERR_INVALID_ARG, "Failed to retrieve 'store': Object is either NULL or not a Python dictionary.");
         }
@@ -419,16 +1040,16 @@ static iERR ionc_write_struct(hWRITER writer, PyObject* map, PyObject* tuple_as_
             if (!PyList_Check(val_list)) {
                 _FAILWITHMSG(IERR_INVALID_ARG, "Invalid value type for the key: Expected a list, but found a different type.");
             }
-            list_len = PyList_Size(val_list);
-            for (i = 0; i < list_len; i++) {
-                val = PyList_GetItem(val_list, i); // Borrowed reference
-                IONCHECK(write_struct_field(writer, key, val, tuple_as_sexp));
+            for (i = 0; i < PyList_GET_SIZE(val_list); i++) {
+                val = PyList_GET_ITEM(val_list, i); // Borrowed reference
+                IONCHECK(write_struct_field(writer, key, val, context));
             }
         }
-        Py_DECREF(store);
     }
 
 fail:
+    Py_XDECREF(store);
+    Py_XDECREF(instance_dict);
     cRETURN;
 }
 
@@ -442,7 +1063,9 @@ fail:
  */
 static iERR ionc_write_big_int(hWRITER writer, PyObject *obj) {
     iENTER;
-    PyObject* int_str = NULL;
+    PyObject* magnitude = NULL;
+    BYTE stack_bytes[IONC_BIG_INT_STACK_BYTES];
+    BYTE* bytes = stack_bytes;
     int overflow;
     long long int_value = PyLong_AsLongLongAndOverflow(obj, &overflow);
 
@@ -450,39 +1073,121 @@ static iERR ionc_write_big_int(hWRITER writer, PyObject *obj) {
         // Value fits within int64, write it as int64
         IONCHECK(ion_writer_write_int64(writer, int_value));
     } else {
+        // Copy the magnitude out as big-endian bytes, which takes linear time where formatting it as decimal text
+        // would take quadratic time in its number of digits.
         PyErr_Clear();
-        int_str = PyObject_Str(obj);
-        ION_STRING string_value;
-        ion_string_from_py(int_str, &string_value);
+        magnitude = overflow < 0 ? PyNumber_Negative(obj) : obj;
+        if (magnitude == NULL) {
+            FAILWITH(IERR_INTERNAL_ERROR);
+        }
+        if (magnitude == obj) Py_INCREF(magnitude);
+#if PY_VERSION_HEX >= 0x030D0000
+        int flags = Py_ASNATIVEBYTES_BIG_ENDIAN | Py_ASNATIVEBYTES_UNSIGNED_BUFFER;
+        Py_ssize_t len = PyLong_AsNativeBytes(magnitude, NULL, 0, flags);
+#else
+        Py_ssize_t len = (Py_ssize_t)((_PyLong_NumBits(magnitude) + 7) / 8);
+#endif
+        if (len <= 0 || len > INT32_MAX) {
+            FAILWITH(IERR_NUMERIC_OVERFLOW);
+        }
+        if (len > IONC_BIG_INT_STACK_BYTES) {
+            bytes = (BYTE*)PyMem_Malloc(len);
+            if (bytes == NULL) {
+                FAILWITH(IERR_NO_MEMORY);
+            }
+        }
+#if PY_VERSION_HEX >= 0x030D0000
+        if (PyLong_AsNativeBytes(magnitude, bytes, len, flags) < 0) {
+#else
+        if (_PyLong_AsByteArray((PyLongObject*)magnitude, bytes, (size_t)len, 0, 0) < 0) {
+#endif
+            FAILWITH(IERR_INTERNAL_ERROR);
+        }
         ION_INT ion_int_value;
         IONCHECK(ion_int_init(&ion_int_value, NULL));
-        IONCHECK(ion_int_from_string(&ion_int_value, &string_value));
+        IONCHECK(ion_int_from_abs_bytes(&ion_int_value, bytes, (SIZE)len, overflow < 0));
         IONCHECK(ion_writer_write_ion_int(writer, &ion_int_value));
     }
 fail:
-    Py_XDECREF(int_str);
+    if (bytes != stack_bytes) PyMem_Free(bytes);
+    Py_XDECREF(magnitude);
     cRETURN;
 }
 
+/*
+ *  Whether the object is exactly one of the builtin types that are written without an IonPy wrapper. Their instances
+ *  can't carry ion_type or ion_annotations attributes, so there is no need to look those up.
+ */
+static BOOL ionc_is_plain_python_value(_IONC_MODULE_STATE* state, PyObject* obj) {
+    PyTypeObject* type = Py_TYPE(obj);
+    return type == &PyUnicode_Type || type == &PyLong_Type || type == &PyBool_Type || type == &PyFloat_Type
+           || type == &PyDict_Type || type == &PyList_Type || type == &PyTuple_Type || type == &PyBytes_Type
+           || type == (PyTypeObject*)state->decimal_constructor || PyDateTime_CheckExact(obj);
+}
+
+/*
+ *  Fills a decQuad backed ion decimal from Decimal.as_tuple(), skipping the str() and ion_decimal_from_string round
+ *  trip. Returns FALSE, with no python error set, when the value has to take the string path instead: a special value,
+ *  a coefficient wider than a decQuad, or an exponent a decQuad can't encode.
+ */
+static BOOL ionc_decimal_from_py_tuple(PyObject* obj, ION_DECIMAL* decimal_value) {
+    PyObject* decimal_tuple = PyObject_CallMethod(obj, "as_tuple", NULL);
+    if (!decimal_tuple) {
+        PyErr_Clear();
+        return FALSE;
+    }
+    BOOL converted = FALSE;
+    // DecimalTuple(sign, digits, exponent); the exponent is a str ('n', 'N' or 'F') for special values.
+    PyObject* py_sign = PyTuple_GET_ITEM(decimal_tuple, 0);
+    PyObject* py_digits = PyTuple_GET_ITEM(decimal_tuple, 1);
+    PyObject* py_exponent = PyTuple_GET_ITEM(decimal_tuple, 2);
+    Py_ssize_t digit_count = PyTuple_GET_SIZE(py_digits);
+    if (PyLong_Check(py_exponent) && digit_count <= DECQUAD_Pmax) {
+        long exponent = PyLong_AsLong(py_exponent);
+        if (exponent == -1 && PyErr_Occurred()) {
+            PyErr_Clear();
+        }
+        else if (exponent >= DECQUAD_Emin - (DECQUAD_Pmax - 1) && exponent <= DECQUAD_Emax - (DECQUAD_Pmax - 1)) {
+            uint8_t bcd[DECQUAD_Pmax];
+            Py_ssize_t pad = DECQUAD_Pmax - digit_count;
+            memset(bcd, 0, pad);
+            for (Py_ssize_t i = 0; i < digit_count; i++) {
+                bcd[pad + i] = (uint8_t)PyLong_AsLong(PyTuple_GET_ITEM(py_digits, i));
+            }
+            decQuadFromBCD(&decimal_value->value.quad_value, (int32_t)exponent, bcd,
+                           PyObject_IsTrue(py_sign) ? DECFLOAT_Sign : 0);
+            decimal_value->type = ION_DECIMAL_TYPE_QUAD;
+            converted = TRUE;
+        }
+    }
+    Py_DECREF(decimal_tuple);
+    return converted;
+}
+
 /*
  *  Writes a value
  *
  *  Args:
  *      writer:  An ion writer
  *      obj: An ion python value
- *      tuple_as_sexp: Decides if a tuple is treated as sexp
+ *      context: The state of the writer
  *
  */
-iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
+iERR ionc_write_value(hWRITER writer, PyObject* obj, _ION_WRITE_CONTEXT* context) {
     iENTER;
+    _IONC_MODULE_STATE* state = context->state;
 
     if (obj == Py_None) {
         IONCHECK(ion_writer_write_null(writer));
         SUCCEED();
     }
-    int ion_type = ion_type_from_py(obj);
-
-    IONCHECK(ionc_write_annotations(writer, obj));
+    int ion_type = tid_none_INT;
+    // Only IonPy values and other subclasses are probed for their Ion type and annotations; for plain values the
+    // failed attribute lookups would raise and clear two exceptions per value.
+    if (!ionc_is_plain_python_value(state, obj)) {
+        ion_type = ion_type_from_py(state, obj);
+        IONCHECK(ionc_write_annotations(writer, obj, context));
+    }
 
     if (PyUnicode_Check(obj)) {
         if (ion_type == tid_none_INT) {
@@ -539,13 +1244,13 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
         }
         IONCHECK(ion_writer_write_double(writer, PyFloat_AsDouble(obj)));
     }
-    else if (PyObject_TypeCheck(obj, (PyTypeObject*)_ionpynull_cls)) {
+    else if (PyObject_TypeCheck(obj, (PyTypeObject*)state->ionpynull_cls)) {
         if (ion_type == tid_none_INT) {
             ion_type = tid_NULL_INT;
         }
         IONCHECK(ion_writer_write_typed_null(writer, (ION_TYPE)ion_type));
     }
-    else if (PyObject_TypeCheck(obj, (PyTypeObject*)_decimal_constructor)) {
+    else if (PyObject_TypeCheck(obj, (PyTypeObject*)state->decimal_constructor)) {
         if (ion_type == tid_none_INT) {
             ion_type = tid_DECIMAL_INT;
         }
@@ -553,14 +1258,17 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
             _FAILWITHMSG(IERR_INVALID_ARG, "Found Decimal; expected DECIMAL Ion type.");
         }
 
-        PyObject* decimal_str = PyObject_CallMethod(obj, "__str__", NULL);
-        char* decimal_c_str = NULL;
-        Py_ssize_t decimal_c_str_len;
-        c_string_from_py(decimal_str, &decimal_c_str, &decimal_c_str_len);
-
         ION_DECIMAL decimal_value;
-        IONCHECK(ion_decimal_from_string(&decimal_value, decimal_c_str, &dec_context));
-        Py_DECREF(decimal_str);
+        if (!ionc_decimal_from_py_tuple(obj, &decimal_value)) {
+            PyObject* decimal_str = PyObject_CallMethod(obj, "__str__", NULL);
+            char* decimal_c_str = NULL;
+            Py_ssize_t decimal_c_str_len;
+            c_string_from_py(decimal_str, &decimal_c_str, &decimal_c_str_len);
+
+            err = ion_decimal_from_string(&decimal_value, decimal_c_str, &context->dec_context);
+            Py_DECREF(decimal_str);
+            IONCHECK(err);
+        }
 
         IONCHECK(ion_writer_write_ion_decimal(writer, &decimal_value));
     }
@@ -594,16 +1302,16 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
         int year, month, day, hour, minute, second;
         short precision, fractional_precision;
         int final_fractional_precision, final_fractional_seconds;
-        precision_attr = PyObject_GetAttr(obj, precision_str);
+        precision_attr = PyObject_GetAttr(obj, state->precision_str);
         if (precision_attr != NULL && precision_attr != Py_None) {
             // This is a Timestamp.
-            precision = int_attr_by_name(obj, precision_str);
-            fractional_precision = int_attr_by_name(obj, fractional_precision_str);
-            fractional_seconds = PyObject_GetAttr(obj, fractional_seconds_str);
+            precision = int_attr_by_name(obj, state->precision_str);
+            fractional_precision = int_attr_by_name(obj, state->fractional_precision_str);
+            fractional_seconds = PyObject_GetAttr(obj, state->fractional_seconds_str);
             if (fractional_seconds != NULL) {
                 fractional_decimal_tuple = PyObject_CallMethod(fractional_seconds, "as_tuple", NULL);
-                py_exponent = PyObject_GetAttr(fractional_decimal_tuple, exponent_str);
-                py_digits = PyObject_GetAttr(fractional_decimal_tuple, digits_str);
+                py_exponent = PyObject_GetAttr(fractional_decimal_tuple, state->exponent_str);
+                py_digits = PyObject_GetAttr(fractional_decimal_tuple, state->digits_str);
                 int exp = PyLong_AsLong(py_exponent) * -1;
                 if (exp > MAX_TIMESTAMP_PRECISION) {
                     final_fractional_precision = MAX_TIMESTAMP_PRECISION;
@@ -652,17 +1360,17 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
                 decNumber helper, dec_number_precision;
                 decQuadFromInt32(&fraction, (int32_t)final_fractional_seconds);
                 decQuad tmp;
-                decQuadScaleB(&fraction, &fraction, decQuadFromInt32(&tmp, -final_fractional_precision), &dec_context);
+                decQuadScaleB(&fraction, &fraction, decQuadFromInt32(&tmp, -final_fractional_precision), &context->dec_context);
                 decQuadToNumber(&fraction, &helper);
-                decContextClearStatus(&dec_context, DEC_Inexact); // TODO consider saving, clearing, and resetting the status flag
-                decNumberRescale(&helper, &helper, decNumberFromInt32(&dec_number_precision, -final_fractional_precision), &dec_context);
-                if (decContextTestStatus(&dec_context, DEC_Inexact)) {
+                decContextClearStatus(&context->dec_context, DEC_Inexact); // TODO consider saving, clearing, and resetting the status flag
+                decNumberRescale(&helper, &helper, decNumberFromInt32(&dec_number_precision, -final_fractional_precision), &context->dec_context);
+                if (decContextTestStatus(&context->dec_context, DEC_Inexact)) {
                     // This means the fractional component is not [0, 1) or has more than microsecond precision.
-                    decContextClearStatus(&dec_context, DEC_Inexact);
+                    decContextClearStatus(&context->dec_context, DEC_Inexact);
                     _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Requested fractional timestamp precision results in data loss.");
                 }
-                decQuadFromNumber(&fraction, &helper, &dec_context);
-                IONCHECK(ion_timestamp_for_fraction(&timestamp_value, year, month, day, hour, minute, second, &fraction, &dec_context));
+                decQuadFromNumber(&fraction, &helper, &context->dec_context);
+                IONCHECK(ion_timestamp_for_fraction(&timestamp_value, year, month, day, hour, minute, second, &fraction, &context->dec_context));
             }
             else if (final_fractional_seconds > 0) {
                 _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Not enough fractional precision for timestamp.");
@@ -705,7 +1413,7 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
 
         IONCHECK(ion_writer_write_timestamp(writer, &timestamp_value));
     }
-    else if (PyDict_Check(obj) || PyObject_TypeCheck(obj, (PyTypeObject *)_ionpydict_cls)) {
+    else if (PyDict_Check(obj) || PyObject_TypeCheck(obj, (PyTypeObject *)state->ionpydict_cls)) {
         if (ion_type == tid_none_INT) {
             ion_type = tid_STRUCT_INT;
         }
@@ -713,17 +1421,17 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
             _FAILWITHMSG(IERR_INVALID_ARG, "Found dict; expected STRUCT Ion type.");
         }
         IONCHECK(ion_writer_start_container(writer, (ION_TYPE)ion_type));
-        IONCHECK(ionc_write_struct(writer, obj, tuple_as_sexp));
+        IONCHECK(ionc_write_struct(writer, obj, context));
         IONCHECK(ion_writer_finish_container(writer));
     }
-    else if (PyObject_TypeCheck(obj, (PyTypeObject*)_py_symboltoken_constructor)) {
+    else if (PyObject_TypeCheck(obj, (PyTypeObject*)state->py_symboltoken_constructor)) {
         if (ion_type == tid_none_INT) {
             ion_type = tid_SYMBOL_INT;
         }
         if (tid_SYMBOL_INT != ion_type) {
             _FAILWITHMSG(IERR_INVALID_ARG, "Found SymbolToken; expected SYMBOL Ion type.");
         }
-        IONCHECK(ionc_write_symboltoken(writer, obj, /*is_value=*/TRUE));
+        IONCHECK(ionc_write_symboltoken(writer, obj, /*is_value=*/TRUE, context));
     }
     else if (PyList_Check(obj) || PyTuple_Check(obj)) {
         if (ion_type == tid_none_INT) {
@@ -733,13 +1441,13 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
             _FAILWITHMSG(IERR_INVALID_ARG, "Found sequence; expected LIST or SEXP Ion type.");
         }
 
-        if (PyTuple_Check(obj) && PyObject_IsTrue(tuple_as_sexp)) {
+        if (PyTuple_Check(obj) && PyObject_IsTrue(context->tuple_as_sexp)) {
             IONCHECK(ion_writer_start_container(writer, (ION_TYPE)tid_SEXP_INT));
         }
         else {
             IONCHECK(ion_writer_start_container(writer, (ION_TYPE)ion_type));
         }
-        IONCHECK(ionc_write_sequence(writer, obj, tuple_as_sexp));
+        IONCHECK(ionc_write_sequence(writer, obj, context));
         IONCHECK(ion_writer_finish_container(writer));
     }
     else {
@@ -754,775 +1462,5284 @@ iERR ionc_write_value(hWRITER writer, PyObject* obj, PyObject* tuple_as_sexp) {
  *  Args:
  *      writer:  An ion writer
  *      objs:  A sequence of ion values
- *      tuple_as_sexp: Decides if a tuple is treated as sexp
+ *      context: The state of the writer
  *      int i: The i-th value of 'objs' that is going to be written
  *
  */
-static iERR _ionc_write(hWRITER writer, PyObject* objs, PyObject* tuple_as_sexp, int i) {
+static iERR _ionc_write(hWRITER writer, PyObject* objs, _ION_WRITE_CONTEXT* context, int i) {
     iENTER;
     PyObject* pyObj = PySequence_Fast_GET_ITEM(objs, i);
     Py_INCREF(pyObj);
-    err = ionc_write_value(writer, pyObj, tuple_as_sexp);
+    err = ionc_write_value(writer, pyObj, context);
     Py_DECREF(pyObj);
     iRETURN;
 }
 
 /*
- *  Entry point of write/dump functions
+ *  Converts an error from one of the write APIs into a Python exception and returns NULL.
  */
-static PyObject* ionc_write(PyObject *self, PyObject *args, PyObject *kwds) {
+static PyObject* ionc_write_error(_IONC_MODULE_STATE* state, iERR err) {
+    PyObject* exception = NULL;
+    if (err == IERR_WRITE_ERROR && PyErr_Occurred()) {
+        // Propagate the exception raised by fp.write as is.
+        _err_msg[0] = '\0';
+        return NULL;
+    }
+    if (err == IERR_INVALID_STATE) {
+        exception = PyErr_Format(PyExc_TypeError, "%s", _err_msg);
+    }
+    else {
+        exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+    }
+
+    _err_msg[0] = '\0';
+    return exception;
+}
+
+/*
+ *  Flushes a binary writer every IONC_WRITE_FLUSH_VALUE_COUNT top-level values.
+ *
+ *  The text writer emits into its stream as it goes, but the binary writer holds all values until the local symbol
+ *  table can be written ahead of them. Flushing periodically lets output that goes to a file leave memory early.
+ *
+ *  Args:
+ *      writer:  An ion writer
+ *      flush_enabled: Whether periodic flushing applies to this writer
+ *      values_written: The number of top-level values written so far
+ *
+ */
+static iERR _ionc_write_maybe_flush(hWRITER writer, BOOL flush_enabled, Py_ssize_t values_written) {
     iENTER;
-    PyObject *obj, *binary, *sequence_as_stream, *tuple_as_sexp;
-    ION_STREAM  *ion_stream = NULL;
-    BYTE* buf = NULL;
-    static char *kwlist[] = {"obj", "binary", "sequence_as_stream", "tuple_as_sexp", NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO", kwlist, &obj, &binary, &sequence_as_stream, &tuple_as_sexp)) {
-        FAILWITH(IERR_INVALID_ARG);
+    SIZE bytes_flushed;
+    if (flush_enabled && values_written % IONC_WRITE_FLUSH_VALUE_COUNT == 0) {
+        IONCHECK(ion_writer_flush(writer, &bytes_flushed));
     }
-    Py_INCREF(obj);
-    Py_INCREF(binary);
-    Py_INCREF(sequence_as_stream);
-    Py_INCREF(tuple_as_sexp);
-    IONCHECK(ion_stream_open_memory_only(&ion_stream));
+    iRETURN;
+}
 
-    //Create a writer here to avoid re-create writers for each element when sequence_as_stream is True.
-    hWRITER writer;
-    ION_WRITER_OPTIONS options;
-    memset(&options, 0, sizeof(options));
-    options.output_as_binary = PyObject_IsTrue(binary);
-    options.max_annotation_count = ANNOTATION_MAX_LEN;
-    IONCHECK(ion_writer_open(&writer, ion_stream, &options));
+/*
+ *  Copies the contents of a memory ION_STREAM into a new python bytes object
+ *
+ *  The bytes object is allocated at its final size and the stream pages are read straight into it, so the
+ *  serialized output is copied exactly once. Reads are issued in chunks of at most IONC_STREAM_MAX_READ_SIZE
+ *  because ion_stream_read takes a 32-bit SIZE, which allows outputs larger than 2GB.
+ *
+ *  Args:
+ *      ion_stream:  A memory ION_STREAM that a writer has been closed over
+ *      bytes_out:  A new reference to the resulting bytes object
+ *
+ */
+static iERR ionc_stream_to_bytes(ION_STREAM* ion_stream, PyObject** bytes_out) {
+    iENTER;
+    PyObject* py_bytes = NULL;
+    POSITION len = ion_stream_get_position(ion_stream);
+    IONCHECK(ion_stream_seek(ion_stream, 0));
 
-    if (Py_TYPE(obj) == &ionc_read_IteratorType) {
-        PyObject *item;
-        while (item = PyIter_Next(obj)) {
-            err = ionc_write_value(writer, item, tuple_as_sexp);
-            Py_DECREF(item);
-            if (err) break;
-        }
-        IONCHECK(err);
-        if (PyErr_Occurred()) {
-            _FAILWITHMSG(IERR_INTERNAL_ERROR, "unexpected error occurred while iterating the input");
+    py_bytes = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)len);
+    if (py_bytes == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    BYTE* dst = (BYTE*)PyBytes_AS_STRING(py_bytes);
+    POSITION remaining = len;
+    // The bytes object is not shared with anything yet, so it can be filled without the GIL.
+    Py_BEGIN_ALLOW_THREADS
+    while (!err && remaining > 0) {
+        SIZE chunk_len = (remaining > IONC_STREAM_MAX_READ_SIZE) ? IONC_STREAM_MAX_READ_SIZE : (SIZE)remaining;
+        SIZE bytes_read;
+        err = ion_stream_read(ion_stream, dst, chunk_len, &bytes_read);
+        if (!err && bytes_read != chunk_len) {
+            err = IERR_EOF;
         }
+        dst += bytes_read;
+        remaining -= bytes_read;
     }
-    else if (sequence_as_stream == Py_True && (PyList_Check(obj) || PyTuple_Check(obj))) {
-        PyObject* objs = PySequence_Fast(obj, "expected sequence");
-        Py_ssize_t len = PySequence_Size(objs);
-        Py_ssize_t i;
-        BOOL last_element = FALSE;
+    Py_END_ALLOW_THREADS
+    IONCHECK(err);
+    *bytes_out = py_bytes;
+    py_bytes = NULL;
 
-        for (i = 0; i < len; i++) {
-            err = _ionc_write(writer, objs, tuple_as_sexp, i);
-            if (err) break;
-        }
+fail:
+    Py_XDECREF(py_bytes);
+    cRETURN;
+}
 
-        Py_DECREF(objs);
-        IONCHECK(err);
+/*
+ *  Writes the chunk that is being filled to the target file. The next call to the stream handler starts a new chunk.
+ *
+ *  Args:
+ *      stream_handle:  The state of a stream opened over ion_write_file_stream_handler
+ *
+ */
+static iERR ion_write_file_stream_flush_chunk(_ION_WRITE_STREAM_HANDLE *stream_handle) {
+    iENTER;
+    PyObject *py_result = NULL;
+    if (stream_handle->chunk == NULL) {
+        SUCCEED();
     }
-    else {
-        IONCHECK(ionc_write_value(writer, obj, tuple_as_sexp));
+    if (stream_handle->chunk_len < stream_handle->chunk_capacity) {
+        // Shrinking a bytes object that has not been shared yet happens in place.
+        if (_PyBytes_Resize(&stream_handle->chunk, stream_handle->chunk_len) < 0) {
+            stream_handle->chunk = NULL;
+            FAILWITH(IERR_NO_MEMORY);
+        }
+    }
+    IONC_PROBE1(flush, stream_handle->chunk_len);
+    IONC_STAT_ADD(stream_handle->state, flushes, 1);
+    IONC_STAT_ADD(stream_handle->state, flush_bytes, stream_handle->chunk_len);
+    IONC_STAT_TIMER_START(stream_handle->state, flush_started);
+    py_result = PyObject_CallMethodObjArgs(stream_handle->py_file, stream_handle->state->write_str,
+                                           stream_handle->chunk, NULL);
+    IONC_STAT_TIMER_STOP(stream_handle->state, flush_nanos, flush_started);
+    Py_CLEAR(stream_handle->chunk);
+    stream_handle->chunk_len = 0;
+    stream_handle->chunk_capacity = 0;
+    if (py_result == NULL) {
+        FAILWITH(IERR_WRITE_ERROR);
     }
-    IONCHECK(ion_writer_close(writer));
-    writer = 0;
-
-    POSITION len = ion_stream_get_position(ion_stream);
-    IONCHECK(ion_stream_seek(ion_stream, 0));
-    // TODO if len > max int32, need to return more than one page...
-    buf = (BYTE*)(PyMem_Malloc((size_t)len));
-    SIZE bytes_read;
-    IONCHECK(ion_stream_read(ion_stream, buf, (SIZE)len, &bytes_read));
-
-    IONCHECK(ion_stream_close(ion_stream));
-    ion_stream = NULL;
-    if (bytes_read != (SIZE)len) {
-        FAILWITH(IERR_EOF);
-    }
-    // TODO Py_BuildValue copies all bytes... Can a memoryview over the original bytes be returned, avoiding the copy?
-    PyObject* written = Py_BuildValue(IONC_BYTES_FORMAT, (char*)buf, bytes_read);
-    PyMem_Free(buf);
-    Py_DECREF(obj);
-    Py_DECREF(binary);
-    Py_DECREF(sequence_as_stream);
-    Py_DECREF(tuple_as_sexp);
-    return written;
 
 fail:
-    if (writer) {
-        ion_writer_close(writer);
+    Py_XDECREF(py_result);
+    cRETURN;
+}
+
+/*
+ *  Makes sure there is a chunk with space left to fill, passing a full one to the python file first when there is one.
+ */
+static iERR ion_write_file_stream_reserve_chunk(_ION_WRITE_STREAM_HANDLE *stream_handle) {
+    iENTER;
+    if (stream_handle->py_file != NULL && stream_handle->chunk != NULL
+            && stream_handle->chunk_len == stream_handle->chunk_capacity) {
+        IONCHECK(ion_write_file_stream_flush_chunk(stream_handle));
     }
-    if (ion_stream != NULL) {
-        ion_stream_close(ion_stream);
+    if (stream_handle->chunk == NULL) {
+        stream_handle->chunk = PyBytes_FromStringAndSize(NULL, IONC_STREAM_WRITE_BUFFER_SIZE);
+        if (stream_handle->chunk == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        stream_handle->chunk_len = 0;
+        stream_handle->chunk_capacity = IONC_STREAM_WRITE_BUFFER_SIZE;
     }
-    PyMem_Free(buf);
-    Py_DECREF(obj);
-    Py_DECREF(binary);
-    Py_DECREF(sequence_as_stream);
-    Py_DECREF(tuple_as_sexp);
+    else if (stream_handle->chunk_len == stream_handle->chunk_capacity) {
+        // Only reachable without a py_file: the whole output is accumulated, so grow the chunk.
+        if (_PyBytes_Resize(&stream_handle->chunk, stream_handle->chunk_capacity * 2) < 0) {
+            stream_handle->chunk = NULL;
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        stream_handle->chunk_capacity *= 2;
+    }
+    iRETURN;
+}
 
-    PyObject* exception = NULL;
-    if (err == IERR_INVALID_STATE) {
-        exception = PyErr_Format(PyExc_TypeError, "%s", _err_msg);
+/*
+ *  Copies 'len' bytes into the chunks, passing each one that fills up to the python file.
+ */
+static iERR ion_write_file_stream_append(_ION_WRITE_STREAM_HANDLE *stream_handle, BYTE* data, SIZE len) {
+    iENTER;
+    SIZE remaining = len;
+
+    while (remaining > 0) {
+        IONCHECK(ion_write_file_stream_reserve_chunk(stream_handle));
+        SIZE space = stream_handle->chunk_capacity - stream_handle->chunk_len;
+        SIZE copy_len = (remaining < space) ? remaining : space;
+        memcpy(PyBytes_AS_STRING(stream_handle->chunk) + stream_handle->chunk_len, data, copy_len);
+        stream_handle->chunk_len += copy_len;
+        data += copy_len;
+        remaining -= copy_len;
     }
-    else {
-        exception = PyErr_Format(_ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+    if (stream_handle->py_file != NULL && stream_handle->chunk != NULL
+            && stream_handle->chunk_len == stream_handle->chunk_capacity) {
+        IONCHECK(ion_write_file_stream_flush_chunk(stream_handle));
     }
 
-    _err_msg[0] = '\0';
-    return exception;
+fail:
+    cRETURN;
 }
 
+/*
+ *  The output twin of ion_read_file_stream_handler. Copies the bytes ion-c hands over (between curr and limit) into
+ *  fixed-size chunks and passes each filled chunk to the python file's write method, so the serialized output never
+ *  needs to be held in memory in full.
+ */
+iERR ion_write_file_stream_handler(struct _ion_user_stream *pstream) {
+    _ION_WRITE_STREAM_HANDLE *stream_handle = (_ION_WRITE_STREAM_HANDLE *) pstream->handler_state;
+    BYTE *data = pstream->curr;
+    SIZE len = (data == NULL || pstream->limit == NULL) ? 0 : (SIZE)(pstream->limit - data);
+    if (stream_handle->discard) {
+        return IERR_OK;
+    }
+    return ion_write_file_stream_append(stream_handle, data, len);
+}
 
-/******************************************************************************
-*       Read/Load APIs                                                        *
-******************************************************************************/
 /*
- *  Converts an ion decimal string to a python-decimal-accept string.
- *
- *  Args:
- *      dec_str:  A C string representing a decimal number
- *
+ *  Takes the accumulated output of a stream without a py_file, leaving the stream empty.
  */
-static void c_decstr_to_py_decstr(char* dec_str, int dec_len) {
-    for (int i = 0; i < dec_len; i++) {
-        if (dec_str[i] == 'd' || dec_str[i] == 'D') {
-            dec_str[i] = 'e';
+static iERR ion_write_file_stream_take_bytes(_ION_WRITE_STREAM_HANDLE *stream_handle, PyObject** bytes_out) {
+    iENTER;
+    if (stream_handle->chunk == NULL) {
+        *bytes_out = PyBytes_FromStringAndSize(NULL, 0);
+    }
+    else {
+        if (stream_handle->chunk_len < stream_handle->chunk_capacity) {
+            if (_PyBytes_Resize(&stream_handle->chunk, stream_handle->chunk_len) < 0) {
+                stream_handle->chunk = NULL;
+                FAILWITH(IERR_NO_MEMORY);
+            }
         }
+        *bytes_out = stream_handle->chunk;
+        stream_handle->chunk = NULL;
+    }
+    stream_handle->chunk_len = 0;
+    stream_handle->chunk_capacity = 0;
+    if (*bytes_out == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
     }
+
+fail:
+    cRETURN;
 }
 
-static PyObject* ionc_get_timestamp_precision(int precision) {
-    int precision_index = -1;
-    while (precision) {
-        precision_index++;
-        precision = precision >> 1;
+/*
+ *  Starts compressing the output of the stream: 'compression' is "gzip" or "zlib".
+ */
+static iERR ion_write_file_stream_open_deflater(_ION_WRITE_STREAM_HANDLE *stream_handle, const char* compression) {
+    iENTER;
+#ifdef IONC_WITH_ZLIB
+    int window_bits;
+    if (strcmp(compression, "gzip") == 0) {
+        window_bits = MAX_WBITS + 16;
     }
-    return py_ion_timestamp_precision_table[precision_index];
+    else if (strcmp(compression, "zlib") == 0) {
+        window_bits = MAX_WBITS;
+    }
+    else {
+        _FAILWITHMSG(IERR_INVALID_ARG, "compression must be None, 'gzip' or 'zlib'.");
+    }
+    stream_handle->deflater = (z_stream*)PyMem_Calloc(1, sizeof(z_stream));
+    if (stream_handle->deflater == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    if (deflateInit2(stream_handle->deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        PyMem_Free(stream_handle->deflater);
+        stream_handle->deflater = NULL;
+        FAILWITH(IERR_NO_MEMORY);
+    }
+#else
+    _FAILWITHMSG(IERR_INVALID_ARG, "The C extension was built without zlib.");
+#endif
+    iRETURN;
+}
+
+static void ion_write_file_stream_close_deflater(_ION_WRITE_STREAM_HANDLE *stream_handle) {
+#ifdef IONC_WITH_ZLIB
+    if (stream_handle->deflater != NULL) {
+        deflateEnd(stream_handle->deflater);
+        PyMem_Free(stream_handle->deflater);
+        stream_handle->deflater = NULL;
+    }
+#endif
 }
 
-static iERR ionc_read_timestamp(hREADER hreader, PyObject** timestamp_out) {
+#ifdef IONC_WITH_ZLIB
+/*
+ *  Compresses 'len' bytes into the chunks, all the way to the end of the compressed stream when 'flush' is Z_FINISH.
+ */
+static iERR ion_write_file_stream_deflate(_ION_WRITE_STREAM_HANDLE *stream_handle, BYTE* data, SIZE len, int flush) {
     iENTER;
-    ION_TIMESTAMP timestamp_value;
-    PyObject* py_fractional_seconds = _decimal_zero;
-    PyObject* tzinfo = Py_None;
+    z_stream *deflater = stream_handle->deflater;
+    int status;
+    deflater->next_in = data;
+    deflater->avail_in = (uInt)len;
+    for (;;) {
+        IONCHECK(ion_write_file_stream_reserve_chunk(stream_handle));
+        SIZE space = stream_handle->chunk_capacity - stream_handle->chunk_len;
+        deflater->next_out = (BYTE*)PyBytes_AS_STRING(stream_handle->chunk) + stream_handle->chunk_len;
+        deflater->avail_out = (uInt)space;
+        status = deflate(deflater, flush);
+        if (status == Z_STREAM_ERROR) {
+            _FAILWITHMSG(IERR_WRITE_ERROR, "Failed to compress the output.");
+        }
+        stream_handle->chunk_len += space - (SIZE)deflater->avail_out;
+        // There is more output pending while deflate fills all the space it is given.
+        if (flush == Z_FINISH ? status == Z_STREAM_END : (deflater->avail_in == 0 && deflater->avail_out > 0)) {
+            break;
+        }
+    }
+    iRETURN;
+}
 
-    IONCHECK(ion_reader_read_timestamp(hreader, &timestamp_value));
-    int year, month = 1, day = 1, hours = 0, minutes = 0, seconds = 0, precision, fractional_precision = 0;
-    IONCHECK(ion_timestamp_get_precision(&timestamp_value, &precision));
-    if (precision < ION_TS_YEAR) {
-        _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Found a timestamp with less than year precision.");
+/*
+ *  The compressing twin of ion_write_file_stream_handler.
+ */
+iERR ion_write_deflate_stream_handler(struct _ion_user_stream *pstream) {
+    iENTER;
+    _ION_WRITE_STREAM_HANDLE *stream_handle = (_ION_WRITE_STREAM_HANDLE *) pstream->handler_state;
+    BYTE *data = pstream->curr;
+    SIZE len = (data == NULL || pstream->limit == NULL) ? 0 : (SIZE)(pstream->limit - data);
+    if (len > 0 && !stream_handle->discard) {
+        IONCHECK(ion_write_file_stream_deflate(stream_handle, data, len, Z_NO_FLUSH));
     }
-    PyObject* py_precision = ionc_get_timestamp_precision(precision);
+    iRETURN;
+}
+#endif
 
-    BOOL has_local_offset;
-    IONCHECK(ion_timestamp_has_local_offset(&timestamp_value, &has_local_offset));
-    if (has_local_offset) {
-        int off_minutes;
-        IONCHECK(ion_timestamp_get_local_offset(&timestamp_value, &off_minutes));
-        PyObject *offset = PyDelta_FromDSU(0, off_minutes * 60, 0);
-        tzinfo = PyTimeZone_FromOffset(offset);
-        Py_DECREF(offset);
+/*
+ *  Passes output on to the deflater when the stream is compressed, otherwise straight into the chunks.
+ */
+static iERR ion_write_file_stream_put(_ION_WRITE_STREAM_HANDLE *stream_handle, BYTE* data, SIZE len) {
+#ifdef IONC_WITH_ZLIB
+    if (stream_handle->deflater != NULL) {
+        return len > 0 ? ion_write_file_stream_deflate(stream_handle, data, len, Z_NO_FLUSH) : IERR_OK;
     }
+#endif
+    return ion_write_file_stream_append(stream_handle, data, len);
+}
 
-    switch (precision) {
-        case ION_TS_FRAC:
-        {
-            decQuad fraction = timestamp_value.fraction;
-            decQuad tmp;
+#define IONC_PRETTY_GAP 0 // between values, where ion-c's separators are dropped
+#define IONC_PRETTY_FIELD_NAME 1 // in a struct field name, up to its ':'
+#define IONC_PRETTY_FIELD_VALUE 2 // after the ':' of a field name
+#define IONC_PRETTY_VALUE 3 // in a scalar, or the annotations of a value
+#define IONC_PRETTY_BRACE 4 // after a '{', which begins either a struct or a lob
+#define IONC_PRETTY_LOB 5
+#define IONC_PRETTY_LOB_END 6 // after the first '}' of the two that end a lob
+#define IONC_PRETTY_QUOTED 7
+#define IONC_PRETTY_QUOTED_ESCAPE 8
 
-            fractional_precision = decQuadGetExponent(&fraction);
-            if (fractional_precision > 0) {
-                _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Timestamp fractional precision cannot be a positive number.");
-            }
-            fractional_precision = fractional_precision * -1;
+/*
+ *  Starts re-indenting the text output of the stream with 'indent', a str of whitespace, per level of nesting.
+ */
+static iERR ion_write_file_stream_open_pretty_printer(_ION_WRITE_STREAM_HANDLE *stream_handle, PyObject* indent) {
+    iENTER;
+    _IONC_PRETTY_PRINTER *printer;
+    const char* indent_utf8;
+    Py_ssize_t indent_len;
+    if (!PyUnicode_Check(indent) || (indent_utf8 = PyUnicode_AsUTF8AndSize(indent, &indent_len)) == NULL) {
+        PyErr_Clear();
+        _FAILWITHMSG(IERR_INVALID_ARG, "indent must be None or a string containing only whitespace.");
+    }
+    printer = (_IONC_PRETTY_PRINTER*)PyMem_Calloc(1, sizeof(_IONC_PRETTY_PRINTER));
+    if (printer == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    stream_handle->pretty_printer = printer;
+    printer->indent = (BYTE*)PyMem_Malloc(indent_len > 0 ? indent_len : 1);
+    if (printer->indent == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    memcpy(printer->indent, indent_utf8, indent_len);
+    printer->indent_len = (SIZE)indent_len;
+    printer->state = IONC_PRETTY_GAP;
+    iRETURN;
+}
 
-            decQuadScaleB(&fraction, &fraction, decQuadFromInt32(&tmp, fractional_precision), &dec_context);
-            int dec = decQuadToInt32Exact(&fraction, &dec_context, DEC_ROUND_DOWN);
-            if (fractional_precision > MAX_TIMESTAMP_PRECISION) fractional_precision = MAX_TIMESTAMP_PRECISION;
-            if (decContextTestStatus(&dec_context, DEC_Inexact)) {
-                // This means the fractional component is not [0, 1) or has more than microsecond precision.
-                decContextClearStatus(&dec_context, DEC_Inexact);
-            }
+static void ion_write_file_stream_close_pretty_printer(_ION_WRITE_STREAM_HANDLE *stream_handle) {
+    if (stream_handle->pretty_printer != NULL) {
+        PyMem_Free(stream_handle->pretty_printer->indent);
+        PyMem_Free(stream_handle->pretty_printer->containers);
+        PyMem_Free(stream_handle->pretty_printer);
+        stream_handle->pretty_printer = NULL;
+    }
+}
 
-            char dec_num[DECQUAD_String];
-            decQuad d;
-            decQuadFromInt32(&d, dec);
-            decQuadScaleB(&d, &d, decQuadFromInt32(&tmp, -fractional_precision), &dec_context);
-            decQuadToString(&d, dec_num);
+static iERR ionc_pretty_print_flush(_ION_WRITE_STREAM_HANDLE *stream_handle) {
+    iENTER;
+    _IONC_PRETTY_PRINTER *printer = stream_handle->pretty_printer;
+    if (printer->out_len > 0) {
+        IONCHECK(ion_write_file_stream_put(stream_handle, printer->out, printer->out_len));
+        printer->out_len = 0;
+    }
+    iRETURN;
+}
 
-            if (fractional_precision > MICROSECOND_DIGITS) fractional_precision = MICROSECOND_DIGITS;
-            py_fractional_seconds = PyObject_CallFunction(_decimal_constructor, "s", dec_num, NULL);
-        }
-        case ION_TS_SEC:
-        {
-            seconds = timestamp_value.seconds;
-        }
-        case ION_TS_MIN:
-        {
-            minutes = timestamp_value.minutes;
-            hours = timestamp_value.hours;
-        }
-        case ION_TS_DAY:
-        {
-            day = timestamp_value.day;
-        }
-        case ION_TS_MONTH:
-        {
-            month = timestamp_value.month;
-        }
-        case ION_TS_YEAR:
-        {
-            year = timestamp_value.year;
-            break;
+static iERR ionc_pretty_print_emit(_ION_WRITE_STREAM_HANDLE *stream_handle, BYTE* data, SIZE len) {
+    iENTER;
+    _IONC_PRETTY_PRINTER *printer = stream_handle->pretty_printer;
+    while (len > 0) {
+        if (printer->out_len == IONC_PRETTY_PRINT_BUFFER_SIZE) {
+            IONCHECK(ionc_pretty_print_flush(stream_handle));
         }
-        default:
-            _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Illegal Timestamp Precision!")
+        SIZE space = IONC_PRETTY_PRINT_BUFFER_SIZE - printer->out_len;
+        SIZE copy_len = (len < space) ? len : space;
+        memcpy(printer->out + printer->out_len, data, copy_len);
+        printer->out_len += copy_len;
+        data += copy_len;
+        len -= copy_len;
     }
-    *timestamp_out = PyObject_CallFunction(_py_timestamp__new__, "OiiiiiiOOOiO",
-        _py_timestamp_cls, year, month, day, hours, minutes, seconds, Py_None, // we assume that microseconds will be assigned in __new__
-        tzinfo, py_precision, fractional_precision, py_fractional_seconds, NULL);
+    iRETURN;
+}
 
-fail:
-    if (py_fractional_seconds != _decimal_zero) Py_DECREF(py_fractional_seconds);
-    if (tzinfo != Py_None) Py_DECREF(tzinfo);
+/*
+ *  Starts a new line, indented to 'depth' levels of nesting.
+ */
+static iERR ionc_pretty_print_newline(_ION_WRITE_STREAM_HANDLE *stream_handle, SIZE depth) {
+    iENTER;
+    _IONC_PRETTY_PRINTER *printer = stream_handle->pretty_printer;
+    SIZE i;
+    IONCHECK(ionc_pretty_print_emit(stream_handle, (BYTE*)"\n", 1));
+    for (i = 0; i < depth; i++) {
+        IONCHECK(ionc_pretty_print_emit(stream_handle, printer->indent, printer->indent_len));
+    }
+    iRETURN;
+}
 
-    cRETURN;
+static iERR ionc_pretty_print_enter(_ION_WRITE_STREAM_HANDLE *stream_handle, BYTE open) {
+    iENTER;
+    _IONC_PRETTY_PRINTER *printer = stream_handle->pretty_printer;
+    if (printer->depth == printer->containers_capacity) {
+        SIZE capacity = printer->containers_capacity ? printer->containers_capacity * 2 : 16;
+        BYTE *containers = (BYTE*)PyMem_Realloc(printer->containers, capacity);
+        if (containers == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        printer->containers = containers;
+        printer->containers_capacity = capacity;
+    }
+    printer->containers[printer->depth++] = open;
+    printer->has_children = FALSE;
+    IONCHECK(ionc_pretty_print_emit(stream_handle, &open, 1));
+    printer->state = IONC_PRETTY_GAP;
+    iRETURN;
 }
 
 /*
- *  Reads values from a container
- *
- *  Args:
- *      hreader:  An ion reader
- *      container: A container that elements are read into
- *      parent_type: Type of container to add to.
- *      value_model: Flags to control how Ion values map to Python types
+ *  Re-indents 'len' bytes of the compact text ion-c writes, which may end anywhere in a value.
  *
+ *  The layout is the Python text writer's: top-level values go on lines of their own, each child of a container on its
+ *  own line, indented once per level of nesting and preceded by a ',' in lists and structs, and a container ends on
+ *  a line of its own at the indentation of its parent. Struct fields are written as 'name: value'. Text in quotes and
+ *  lobs is copied as it is.
  */
-static iERR ionc_read_into_container(hREADER hreader, PyObject* container, enum ContainerType parent_type, uint8_t value_model) {
+static iERR ionc_pretty_print(_ION_WRITE_STREAM_HANDLE *stream_handle, BYTE* data, SIZE len) {
     iENTER;
-    IONCHECK(ion_reader_step_in(hreader));
-    IONCHECK(Py_EnterRecursiveCall(" while reading an Ion container"));
-    err = ionc_read_all(hreader, container, parent_type, value_model);
-    Py_LeaveRecursiveCall();
-    IONCHECK(err);
-    IONCHECK(ion_reader_step_out(hreader));
+    _IONC_PRETTY_PRINTER *printer = stream_handle->pretty_printer;
+    SIZE i = 0;
+    while (i < len) {
+        BYTE c = data[i];
+        switch (printer->state) {
+            case IONC_PRETTY_GAP:
+                if (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',') {
+                    break;
+                }
+                if (c == ')' || c == ']' || c == '}') {
+                    if (printer->depth == 0) {
+                        _FAILWITHMSG(IERR_INTERNAL_ERROR, "Unbalanced container end in the text output.");
+                    }
+                    IONCHECK(ionc_pretty_print_newline(stream_handle, printer->depth - 1));
+                    IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                    printer->depth--;
+                    printer->has_children = TRUE;
+                    break;
+                }
+                if (printer->depth == 0) {
+                    if (printer->has_children) {
+                        IONCHECK(ionc_pretty_print_emit(stream_handle, (BYTE*)"\n", 1));
+                    }
+                }
+                else {
+                    if (printer->has_children && printer->containers[printer->depth - 1] != '(') {
+                        IONCHECK(ionc_pretty_print_emit(stream_handle, (BYTE*)",", 1));
+                    }
+                    IONCHECK(ionc_pretty_print_newline(stream_handle, printer->depth));
+                }
+                printer->has_children = TRUE;
+                printer->state = (printer->depth > 0 && printer->containers[printer->depth - 1] == '{')
+                        ? IONC_PRETTY_FIELD_NAME : IONC_PRETTY_VALUE;
+                continue; // the value starts with this byte
+            case IONC_PRETTY_FIELD_NAME:
+                if (c == ':') {
+                    IONCHECK(ionc_pretty_print_emit(stream_handle, (BYTE*)": ", 2));
+                    printer->state = IONC_PRETTY_FIELD_VALUE;
+                    break;
+                }
+                if (c == '\'' || c == '"') {
+                    printer->quote = c;
+                    printer->after_quote = IONC_PRETTY_FIELD_NAME;
+                    printer->state = IONC_PRETTY_QUOTED;
+                }
+                IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                break;
+            case IONC_PRETTY_FIELD_VALUE:
+                if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+                    break;
+                }
+                printer->state = IONC_PRETTY_VALUE;
+                continue;
+            case IONC_PRETTY_VALUE:
+                if (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',' || c == ')' || c == ']' || c == '}') {
+                    printer->state = IONC_PRETTY_GAP;
+                    continue; // the value ended before this byte
+                }
+                if (c == '(' || c == '[') {
+                    IONCHECK(ionc_pretty_print_enter(stream_handle, c));
+                    break;
+                }
+                if (c == '{') {
+                    printer->state = IONC_PRETTY_BRACE;
+                    break;
+                }
+                if (c == '\'' || c == '"') {
+                    printer->quote = c;
+                    printer->after_quote = IONC_PRETTY_VALUE;
+                    printer->state = IONC_PRETTY_QUOTED;
+                }
+                IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                break;
+            case IONC_PRETTY_BRACE:
+                if (c == '{') {
+                    IONCHECK(ionc_pretty_print_emit(stream_handle, (BYTE*)"{{", 2));
+                    printer->state = IONC_PRETTY_LOB;
+                    break;
+                }
+                IONCHECK(ionc_pretty_print_enter(stream_handle, '{'));
+                continue; // the struct's first field, or its end, starts with this byte
+            case IONC_PRETTY_LOB:
+                if (c == '"' || c == '\'') {
+                    printer->quote = c;
+                    printer->after_quote = IONC_PRETTY_LOB;
+                    printer->state = IONC_PRETTY_QUOTED;
+                }
+                else if (c == '}') {
+                    printer->state = IONC_PRETTY_LOB_END;
+                }
+                IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                break;
+            case IONC_PRETTY_LOB_END:
+                printer->state = (c == '}') ? IONC_PRETTY_VALUE : IONC_PRETTY_LOB;
+                IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                break;
+            case IONC_PRETTY_QUOTED:
+                if (c == '\\') {
+                    printer->state = IONC_PRETTY_QUOTED_ESCAPE;
+                }
+                else if (c == printer->quote) {
+                    printer->state = printer->after_quote;
+                }
+                IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                break;
+            case IONC_PRETTY_QUOTED_ESCAPE:
+                printer->state = IONC_PRETTY_QUOTED;
+                IONCHECK(ionc_pretty_print_emit(stream_handle, &c, 1));
+                break;
+        }
+        i++;
+    }
     iRETURN;
 }
 
 /*
- *  Adds an element to a List or struct
- *
- *  Args:
- *      pyContainer:  A container that the element is added to
- *      element:  The element to be added to the container
- *      container_type: Type of container to add to.
- *      field_name:  The field name of the element if it is inside a struct
+ *  The pretty-printing twin of ion_write_file_stream_handler, which puts the re-indented text in the chunks, or on
+ *  to the deflater.
  */
-static void ionc_add_to_container(PyObject* pyContainer, PyObject* element, enum ContainerType container_type, PyObject* field_name) {
-    switch (container_type) {
-        case MULTIMAP:
-        {
-            // this builds the "hash-map of lists" structure that the IonPyDict object
-            // expects for its __store
-            PyObject* empty = PyList_New(0);
-            // SetDefault performs get|set with a single hash of the key
-            PyObject* found = PyDict_SetDefault(pyContainer, field_name, empty);
-            PyList_Append(found, element);
+iERR ion_write_pretty_stream_handler(struct _ion_user_stream *pstream) {
+    _ION_WRITE_STREAM_HANDLE *stream_handle = (_ION_WRITE_STREAM_HANDLE *) pstream->handler_state;
+    BYTE *data = pstream->curr;
+    SIZE len = (data == NULL || pstream->limit == NULL) ? 0 : (SIZE)(pstream->limit - data);
+    if (stream_handle->discard) {
+        return IERR_OK;
+    }
+    return ionc_pretty_print(stream_handle, data, len);
+}
 
-            Py_DECREF(empty);
-            break;
-        }
-        case STD_DICT:
-        {
-            PyDict_SetItem(pyContainer, field_name, element);
-            break;
-        }
-        case LIST:
-        {
-            PyList_Append(pyContainer, (PyObject*)element);
-            break;
-        }
+/*
+ *  Puts what is left of the pretty-printed output in the chunks and ends the compressed stream, after ion-c's stream
+ *  has been closed, so that its trailer is put in the chunks.
+ */
+static iERR ion_write_file_stream_finish(_ION_WRITE_STREAM_HANDLE *stream_handle) {
+    iENTER;
+    if (stream_handle->pretty_printer != NULL) {
+        IONCHECK(ionc_pretty_print_flush(stream_handle));
     }
-    Py_XDECREF(element);
+#ifdef IONC_WITH_ZLIB
+    if (stream_handle->deflater != NULL) {
+        IONCHECK(ion_write_file_stream_deflate(stream_handle, NULL, 0, Z_FINISH));
+    }
+#endif
+    iRETURN;
 }
 
 /*
- *  Helper function for 'ionc_read_all', reads an ion value
- *
- *  Args:
- *      hreader:  An ion reader
- *      ION_TYPE:  The ion type of the reading value as an int
- *      parent_type: Type of the parent container.
- *      value_model: Flags to control how Ion values map to Python types
+ *  Pretty-prints the whole of the compact text in 'bytes', replacing it.
  */
-iERR ionc_read_value(hREADER hreader, ION_TYPE t, PyObject* container, enum ContainerType parent_type, uint8_t value_model) {
+static iERR ionc_pretty_print_bytes(PyObject* indent, PyObject** bytes) {
     iENTER;
+    _ION_WRITE_STREAM_HANDLE stream_handle;
+    PyObject *pretty = NULL;
+    memset(&stream_handle, 0, sizeof(stream_handle));
+    IONCHECK(ion_write_file_stream_open_pretty_printer(&stream_handle, indent));
+    IONCHECK(ionc_pretty_print(&stream_handle, (BYTE*)PyBytes_AS_STRING(*bytes), (SIZE)PyBytes_GET_SIZE(*bytes)));
+    IONCHECK(ion_write_file_stream_finish(&stream_handle));
+    IONCHECK(ion_write_file_stream_take_bytes(&stream_handle, &pretty));
+    Py_DECREF(*bytes);
+    *bytes = pretty;
 
-    BOOL        wrap_py_value = !(value_model & 1);
-    BOOL        symbol_as_text = value_model & 2;
-    BOOL        use_std_dict   = value_model & 4;
+fail:
+    ion_write_file_stream_close_pretty_printer(&stream_handle);
+    Py_XDECREF(stream_handle.chunk);
+    cRETURN;
+}
+
+/*
+ *  The text writer starts without a version marker, so it is written into the stream ahead of the values.
+ */
+static iERR ionc_write_text_version_marker(ION_STREAM* ion_stream) {
+    iENTER;
+    SIZE marker_written;
+    char* marker = "$ion_1_0 ";
+    IONCHECK(ion_stream_write(ion_stream, (BYTE*)marker, (SIZE)strlen(marker), &marker_written));
+    iRETURN;
+}
+
+/*
+ *  Entry point of write/dump functions
+ *
+ *  When 'fp' is given the output is streamed to fp.write in chunks of IONC_STREAM_WRITE_BUFFER_SIZE bytes
+ *  and None is returned, otherwise the output is returned as a bytes object. With a 'compression' of "gzip" or
+ *  "zlib" the output is compressed on its way into the chunks, and text with an 'indent' is pretty-printed on its way
+ *  there.
+ */
+static PyObject* ionc_write(PyObject *self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    PyObject *obj, *binary, *sequence_as_stream, *tuple_as_sexp, *py_file = Py_None, *imports = Py_None;
+    PyObject *indent = Py_None;
+    int omit_version_marker = 0;
+    const char *compression = NULL;
+    ION_STREAM  *ion_stream = NULL;
+    PyObject* written = NULL;
+    hWRITER writer = NULL;
+    hCATALOG catalog = NULL;
+    ION_WRITER_OPTIONS options;
+    BOOL imports_initialized = FALSE;
+    _ION_WRITE_STREAM_HANDLE stream_handle;
+    _ION_WRITE_CONTEXT context;
+    BOOL to_file, pretty, to_chunks;
+    Py_ssize_t values_written = 0;
+    static char *kwlist[] = {"obj", "binary", "sequence_as_stream", "tuple_as_sexp", "fp", "imports", "indent",
+                             "omit_version_marker", "compression", NULL};
+    memset(&stream_handle, 0, sizeof(stream_handle));
+    memset(&options, 0, sizeof(options));
+    memset(&context, 0, sizeof(context));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OOOpz", kwlist, &obj, &binary, &sequence_as_stream,
+                                     &tuple_as_sexp, &py_file, &imports, &indent, &omit_version_marker,
+                                     &compression)) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    Py_INCREF(obj);
+    Py_INCREF(binary);
+    Py_INCREF(sequence_as_stream);
+    Py_INCREF(tuple_as_sexp);
+    Py_INCREF(py_file);
+    to_file = (py_file != Py_None);
+    options.output_as_binary = PyObject_IsTrue(binary);
+    pretty = !options.output_as_binary && indent != Py_None;
+    // Compressed and pretty-printed output always goes through the chunks, which accumulate it all without a file.
+    to_chunks = to_file || compression != NULL || pretty;
+    stream_handle.state = state;
+    stream_handle.py_file = to_file ? py_file : NULL;
+    if (compression != NULL) {
+        IONCHECK(ion_write_file_stream_open_deflater(&stream_handle, compression));
+    }
+    if (pretty) {
+        IONCHECK(ion_write_file_stream_open_pretty_printer(&stream_handle, indent));
+        IONCHECK(ion_stream_open_handler_out(ion_write_pretty_stream_handler, &stream_handle, &ion_stream));
+    }
+    else if (compression != NULL) {
+#ifdef IONC_WITH_ZLIB
+        IONCHECK(ion_stream_open_handler_out(ion_write_deflate_stream_handler, &stream_handle, &ion_stream));
+#endif
+    }
+    else if (to_file) {
+        IONCHECK(ion_stream_open_handler_out(ion_write_file_stream_handler, &stream_handle, &ion_stream));
+    }
+    else {
+        IONCHECK(ion_stream_open_memory_only(&ion_stream));
+    }
+
+    //Create a writer here to avoid re-create writers for each element when sequence_as_stream is True.
+    options.max_annotation_count = ANNOTATION_MAX_LEN;
+    if (!options.output_as_binary && !omit_version_marker) {
+        IONCHECK(ionc_write_text_version_marker(ion_stream));
+    }
+    ionc_write_context_init(&context, state, tuple_as_sexp, options.output_as_binary);
+    if (imports != Py_None) {
+        // The writer resolves its imports through the catalog, so it must stay open as long as the writer.
+        PyObject *imports_seq = PySequence_Fast(imports, "expected a sequence of shared symbol tables");
+        if (imports_seq == NULL) {
+            FAILWITH(IERR_INVALID_ARG);
+        }
+        err = ion_catalog_open(&catalog);
+        if (!err) {
+            options.pcatalog = catalog;
+            err = ion_writer_options_initialize_shared_imports(&options);
+        }
+        if (!err) {
+            imports_initialized = TRUE;
+        }
+        Py_ssize_t i;
+        for (i = 0; !err && i < PySequence_Fast_GET_SIZE(imports_seq); i++) {
+            hSYMTAB symtab;
+            err = ionc_catalog_add_py_table(state, catalog, PySequence_Fast_GET_ITEM(imports_seq, i), &symtab);
+            if (!err) {
+                err = ion_writer_options_add_shared_imports_symbol_tables(&options, &symtab, 1);
+            }
+        }
+        Py_DECREF(imports_seq);
+        IONCHECK(err);
+    }
+    IONCHECK(ion_writer_open(&writer, ion_stream, &options));
+
+    if (Py_TYPE(obj) == (PyTypeObject*)state->read_iterator_type) {
+        PyObject *item;
+        while (item = PyIter_Next(obj)) {
+            err = ionc_write_value(writer, item, &context);
+            Py_DECREF(item);
+            if (err) break;
+            err = _ionc_write_maybe_flush(writer, to_file && options.output_as_binary, ++values_written);
+            if (err) break;
+        }
+        IONCHECK(err);
+        if (PyErr_Occurred()) {
+            _FAILWITHMSG(IERR_INTERNAL_ERROR, "unexpected error occurred while iterating the input");
+        }
+    }
+    else if (sequence_as_stream == Py_True && (PyList_Check(obj) || PyTuple_Check(obj))) {
+        PyObject* objs = PySequence_Fast(obj, "expected sequence");
+        Py_ssize_t len = PySequence_Size(objs);
+        Py_ssize_t i;
+        BOOL last_element = FALSE;
+
+        for (i = 0; i < len; i++) {
+            err = _ionc_write(writer, objs, &context, i);
+            if (err) break;
+            err = _ionc_write_maybe_flush(writer, to_file && options.output_as_binary, i + 1);
+            if (err) break;
+        }
+
+        Py_DECREF(objs);
+        IONCHECK(err);
+    }
+    else {
+        IONCHECK(ionc_write_value(writer, obj, &context));
+    }
+    ionc_write_context_clear(&context);
+    if (to_chunks) {
+        // The stream handler fills python bytes objects, so it needs the GIL.
+        IONCHECK(ion_writer_close(writer));
+    }
+    else {
+        // A memory stream touches no Python object, so the encoding the binary writer defers to close (symbol table
+        // and length prefixes) runs without the GIL.
+        Py_BEGIN_ALLOW_THREADS
+        err = ion_writer_close(writer);
+        Py_END_ALLOW_THREADS
+        IONCHECK(err);
+    }
+    writer = 0;
+    if (imports_initialized) {
+        ion_writer_options_close_shared_imports(&options);
+        imports_initialized = FALSE;
+    }
+    if (catalog != NULL) {
+        ion_catalog_close(catalog);
+        catalog = NULL;
+    }
+
+    if (to_chunks) {
+        IONCHECK(ion_stream_flush(ion_stream));
+        IONCHECK(ion_stream_close(ion_stream));
+        ion_stream = NULL;
+        IONCHECK(ion_write_file_stream_finish(&stream_handle));
+        ion_write_file_stream_close_deflater(&stream_handle);
+        ion_write_file_stream_close_pretty_printer(&stream_handle);
+        if (to_file) {
+            IONCHECK(ion_write_file_stream_flush_chunk(&stream_handle));
+            written = Py_None;
+            Py_INCREF(written);
+        }
+        else {
+            IONCHECK(ion_write_file_stream_take_bytes(&stream_handle, &written));
+        }
+    }
+    else {
+        IONCHECK(ionc_stream_to_bytes(ion_stream, &written));
+        IONCHECK(ion_stream_close(ion_stream));
+        ion_stream = NULL;
+    }
+
+    Py_DECREF(obj);
+    Py_DECREF(binary);
+    Py_DECREF(sequence_as_stream);
+    Py_DECREF(tuple_as_sexp);
+    Py_DECREF(py_file);
+    return written;
+
+fail:
+    // Closing flushes what ion-c still buffers. With an exception pending none of it may reach fp.write, and a
+    // partial value is of no use to anyone, so it is all dropped.
+    stream_handle.discard = TRUE;
+    if (writer) {
+        ion_writer_close(writer);
+    }
+    if (ion_stream != NULL) {
+        ion_stream_close(ion_stream);
+    }
+    if (imports_initialized) {
+        ion_writer_options_close_shared_imports(&options);
+    }
+    if (catalog != NULL) {
+        ion_catalog_close(catalog);
+    }
+    ionc_write_context_clear(&context);
+    ion_write_file_stream_close_deflater(&stream_handle);
+    ion_write_file_stream_close_pretty_printer(&stream_handle);
+    Py_XDECREF(written);
+    Py_XDECREF(stream_handle.chunk);
+    Py_DECREF(obj);
+    Py_DECREF(binary);
+    Py_DECREF(sequence_as_stream);
+    Py_DECREF(tuple_as_sexp);
+    Py_DECREF(py_file);
+
+    return ionc_write_error(state, err);
+}
+
+/*
+ *  Opens the writer and output stream of an ionc.Writer. They stay open until close() so that the local symbol
+ *  table, and the cost of setting them up, is shared by every value written.
+ *
+ *  Args:
+ *      binary:  Write binary Ion if True, text Ion otherwise
+ *      tuple_as_sexp:  Decides if a tuple is treated as sexp
+ *
+ */
+static int ionc_writer_init(PyObject *self_obj, PyObject *args, PyObject *kwds) {
+    iENTER;
+    ionc_Writer *self = (ionc_Writer*) self_obj;
+    _IONC_MODULE_STATE* state = ionc_type_state(Py_TYPE(self_obj));
+    PyObject *binary = Py_True, *tuple_as_sexp = Py_False;
+    ION_WRITER_OPTIONS options;
+    static char *kwlist[] = {"binary", "tuple_as_sexp", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OO", kwlist, &binary, &tuple_as_sexp)) {
+        return -1;
+    }
+    if (self->initialized) {
+        // Opening a second writer would leak the state of the first, which may hold buffered output.
+        PyErr_SetString(PyExc_TypeError, "Writer is already initialized");
+        return -1;
+    }
+    self->initialized = TRUE;
+    Py_INCREF(tuple_as_sexp);
+    self->closed = FALSE;
+    memset(&self->stream_handle, 0, sizeof(self->stream_handle));
+    self->stream_handle.state = state;
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = PyObject_IsTrue(binary);
+    ionc_write_context_init(&self->context, state, tuple_as_sexp, options.output_as_binary);
+
+    IONCHECK(ion_stream_open_handler_out(ion_write_file_stream_handler, &self->stream_handle, &self->ion_stream));
+    options.max_annotation_count = ANNOTATION_MAX_LEN;
+    IONCHECK(ion_writer_open(&self->writer, self->ion_stream, &options));
+    return 0;
+
+fail:
+    if (self->ion_stream != NULL) {
+        ion_stream_close(self->ion_stream);
+        self->ion_stream = NULL;
+    }
+    self->closed = TRUE;
+    ionc_write_error(state, err);
+    return -1;
+}
+
+/*
+ *  Closes a writer whose write or flush failed, dropping its output. ion-c may have been left inside a container of
+ *  the value that failed, so nothing more can be written to it.
+ */
+static void ionc_writer_fail(ionc_Writer *self) {
+    self->stream_handle.discard = TRUE;
+    if (self->writer != NULL) {
+        ion_writer_close(self->writer);
+        self->writer = NULL;
+    }
+    if (self->ion_stream != NULL) {
+        ion_stream_close(self->ion_stream);
+        self->ion_stream = NULL;
+    }
+    Py_CLEAR(self->stream_handle.chunk);
+    ionc_write_context_clear(&self->context);
+    self->closed = TRUE;
+    self->failed = TRUE;
+}
+
+/*
+ *  Raises the ValueError of a call to a closed writer, and returns whether the writer is closed.
+ */
+static BOOL ionc_writer_check_closed(ionc_Writer *self, const char* action) {
+    if (self->failed) {
+        PyErr_Format(PyExc_ValueError, "%s of a Writer whose write failed", action);
+    }
+    else if (self->closed) {
+        PyErr_Format(PyExc_ValueError, "%s of a closed Writer", action);
+    }
+    return self->closed;
+}
+
+/*
+ *  Writes a single top-level value. The output becomes available from the next flush() or close(). When the write
+ *  fails the writer is closed, and later writes and flushes raise ValueError.
+ */
+static PyObject* _ionc_writer_write(PyObject *self_obj, PyObject *obj) {
+    iENTER;
+    ionc_Writer *self = (ionc_Writer*) self_obj;
+    _IONC_MODULE_STATE* state = ionc_type_state(Py_TYPE(self_obj));
+    if (ionc_writer_check_closed(self, "write")) {
+        return NULL;
+    }
+    IONCHECK(ionc_write_value(self->writer, obj, &self->context));
+    Py_RETURN_NONE;
+
+fail:
+    ionc_write_error(state, err);
+    ionc_writer_fail(self);
+    return NULL;
+}
+
+static PyObject* ionc_writer_write(PyObject *self_obj, PyObject *obj) {
+    PyObject* result;
+    IONC_LOCK(((ionc_Writer*) self_obj)->mutex);
+    result = _ionc_writer_write(self_obj, obj);
+    IONC_UNLOCK(((ionc_Writer*) self_obj)->mutex);
+    return result;
+}
+
+/*
+ *  Returns the bytes written since the last flush(). The symbol table context is kept, so the output of successive
+ *  calls concatenates into a single Ion stream.
+ */
+static PyObject* _ionc_writer_flush(PyObject *self_obj, PyObject *Py_UNUSED(ignored)) {
+    iENTER;
+    ionc_Writer *self = (ionc_Writer*) self_obj;
+    _IONC_MODULE_STATE* state = ionc_type_state(Py_TYPE(self_obj));
+    PyObject *written = NULL;
+    SIZE bytes_flushed;
+    if (ionc_writer_check_closed(self, "flush")) {
+        return NULL;
+    }
+    IONCHECK(ion_writer_flush(self->writer, &bytes_flushed));
+    IONCHECK(ion_stream_flush(self->ion_stream));
+    IONCHECK(ion_write_file_stream_take_bytes(&self->stream_handle, &written));
+    return written;
+
+fail:
+    ionc_write_error(state, err);
+    ionc_writer_fail(self);
+    return NULL;
+}
+
+static PyObject* ionc_writer_flush(PyObject *self_obj, PyObject *ignored) {
+    PyObject* result;
+    IONC_LOCK(((ionc_Writer*) self_obj)->mutex);
+    result = _ionc_writer_flush(self_obj, ignored);
+    IONC_UNLOCK(((ionc_Writer*) self_obj)->mutex);
+    return result;
+}
+
+/*
+ *  Closes the writer and returns any output not yet returned by flush(). Further calls return empty bytes, as does
+ *  closing a writer whose write failed.
+ */
+static PyObject* _ionc_writer_close(PyObject *self_obj, PyObject *Py_UNUSED(ignored)) {
+    iENTER;
+    ionc_Writer *self = (ionc_Writer*) self_obj;
+    _IONC_MODULE_STATE* state = ionc_type_state(Py_TYPE(self_obj));
+    PyObject *written = NULL;
+    if (self->closed) {
+        return PyBytes_FromStringAndSize(NULL, 0);
+    }
+    self->closed = TRUE;
+    ionc_write_context_clear(&self->context);
+    err = ion_writer_close(self->writer);
+    self->writer = NULL;
+    if (!err) {
+        err = ion_stream_flush(self->ion_stream);
+    }
+    if (!err) {
+        err = ion_stream_close(self->ion_stream);
+    }
+    else {
+        ion_stream_close(self->ion_stream);
+    }
+    self->ion_stream = NULL;
+    IONCHECK(err);
+    IONCHECK(ion_write_file_stream_take_bytes(&self->stream_handle, &written));
+    return written;
+
+fail:
+    Py_CLEAR(self->stream_handle.chunk);
+    return ionc_write_error(state, err);
+}
+
+static PyObject* ionc_writer_close(PyObject *self_obj, PyObject *ignored) {
+    PyObject* result;
+    IONC_LOCK(((ionc_Writer*) self_obj)->mutex);
+    result = _ionc_writer_close(self_obj, ignored);
+    IONC_UNLOCK(((ionc_Writer*) self_obj)->mutex);
+    return result;
+}
+
+static void ionc_writer_dealloc(PyObject *self_obj) {
+    ionc_Writer *self = (ionc_Writer*) self_obj;
+    if (self->writer != NULL) {
+        ion_writer_close(self->writer);
+    }
+    if (self->ion_stream != NULL) {
+        ion_stream_close(self->ion_stream);
+    }
+    Py_XDECREF(self->stream_handle.chunk);
+    ionc_write_context_clear(&self->context);
+    Py_XDECREF(self->context.tuple_as_sexp);
+    PyTypeObject* type = Py_TYPE(self_obj);
+    type->tp_free(self_obj);
+    Py_DECREF(type);
+}
+
+static PyMethodDef ionc_writer_methods[] = {
+    {"write", (PyCFunction)ionc_writer_write, METH_O, "Writes a single top-level value."},
+    {"flush", (PyCFunction)ionc_writer_flush, METH_NOARGS, "Returns the bytes written since the last flush."},
+    {"close", (PyCFunction)ionc_writer_close, METH_NOARGS, "Closes the writer and returns the remaining bytes."},
+    {NULL}
+};
+
+static PyType_Slot ionc_writer_slots[] = {
+    {Py_tp_doc, "Ion writer that is kept open across values."},
+    {Py_tp_new, PyType_GenericNew},
+    {Py_tp_init, ionc_writer_init},
+    {Py_tp_dealloc, ionc_writer_dealloc},
+    {Py_tp_methods, ionc_writer_methods},
+    {0, NULL}
+};
+
+static PyType_Spec ionc_writer_spec = {
+    .name = "ionc.Writer",
+    .basicsize = sizeof(ionc_Writer),
+    .flags = IONC_TPFLAGS,
+    .slots = ionc_writer_slots
+};
+
+
+/******************************************************************************
+*       Read/Load APIs                                                        *
+******************************************************************************/
+/*
+ *  Upper bound of the characters, excluding the NUL, that ionc_decimal_to_py_decstr writes for a decimal: a sign, the
+ *  coefficient digits, then 'E' and an int32 exponent.
+ */
+static SIZE ionc_decimal_py_decstr_len(ION_DECIMAL* value) {
+    SIZE digits = DECQUAD_Pmax;
+    if (value->type != ION_DECIMAL_TYPE_QUAD && value->value.num_value->digits > digits) {
+        digits = value->value.num_value->digits;
+    }
+    return digits + 13;
+}
+
+/*
+ *  Converts an ion decimal to a "[-]<coefficient>E<exponent>" string that decimal.Decimal parses exactly. The
+ *  coefficient is copied as BCD straight out of the decQuad or decNumber, which skips ion_decimal_to_string's
+ *  formatting and the 'd' exponent rewrite. Doesn't touch python, so it is safe without the GIL.
+ *
+ *  Args:
+ *      value:  An ion decimal
+ *      dec_str:  Output buffer of at least ionc_decimal_py_decstr_len(value) + 1 chars
+ *
+ *  Returns:
+ *      The length of the NUL terminated string written to dec_str
+ */
+static SIZE ionc_decimal_to_py_decstr(ION_DECIMAL* value, char* dec_str) {
+    // The BCD digits are written one char in, then turned into text in place, front to back.
+    uint8_t* bcd = (uint8_t*)dec_str + 1;
+    int32_t digits, exponent;
+    BOOL negative;
+    if (value->type == ION_DECIMAL_TYPE_QUAD) {
+        negative = decQuadGetCoefficient(&value->value.quad_value, bcd) != 0;
+        exponent = decQuadGetExponent(&value->value.quad_value);
+        digits = DECQUAD_Pmax;
+    } else {
+        decNumber* number = value->value.num_value;
+        decNumberGetBCD(number, bcd);
+        negative = decNumberIsNegative(number);
+        exponent = number->exponent;
+        digits = number->digits;
+    }
+    // A decQuad coefficient is always DECQUAD_Pmax digits wide; drop its leading zeros but keep at least one digit.
+    int32_t start = 0;
+    while (start < digits - 1 && bcd[start] == 0) {
+        start++;
+    }
+    SIZE len = 0;
+    if (negative) {
+        dec_str[len++] = '-';
+    }
+    for (int32_t i = start; i < digits; i++) {
+        dec_str[len++] = (char)('0' + bcd[i]);
+    }
+    len += sprintf(dec_str + len, "E%d", exponent);
+    return len;
+}
+
+/*
+ *  Returns a new reference to the datetime.timezone for a utc offset in minutes. Ion offsets are limited to
+ *  (-24h, 24h) and a stream tends to share a handful of them, so each timezone is created once and kept in
+ *  the timezone_cache of the module state for the life of the module.
+ */
+static PyObject* ionc_get_timezone(_IONC_MODULE_STATE* state, int off_minutes) {
+    int index = off_minutes + IONC_TIMEZONE_CACHE_SIZE / 2;
+    BOOL cacheable = index >= 0 && index < IONC_TIMEZONE_CACHE_SIZE;
+    PyObject* tzinfo = NULL;
+    if (cacheable) {
+        IONC_LOCK(state->timezone_cache_mutex);
+        tzinfo = state->timezone_cache[index];
+        Py_XINCREF(tzinfo);
+        IONC_UNLOCK(state->timezone_cache_mutex);
+    }
+    if (!tzinfo) {
+        PyObject* offset = PyDelta_FromDSU(0, off_minutes * 60, 0);
+        if (!offset) return NULL;
+        tzinfo = PyTimeZone_FromOffset(offset);
+        Py_DECREF(offset);
+        if (!tzinfo) return NULL;
+        if (!cacheable) return tzinfo;
+        // Without the GIL another thread may have cached the same offset in the meantime, whose timezone is kept.
+        IONC_LOCK(state->timezone_cache_mutex);
+        if (state->timezone_cache[index] == NULL) {
+            Py_INCREF(tzinfo);
+            state->timezone_cache[index] = tzinfo;
+        }
+        IONC_UNLOCK(state->timezone_cache_mutex);
+    }
+    return tzinfo;
+}
+
+static PyObject* ionc_get_timestamp_precision(_IONC_MODULE_STATE* state, int precision) {
+    int precision_index = -1;
+    while (precision) {
+        precision_index++;
+        precision = precision >> 1;
+    }
+    return state->py_ion_timestamp_precision_table[precision_index];
+}
+
+/*
+ *  Reads the fraction of a timestamp with fractional seconds precision: the fractional seconds are
+ *  digits * 10^-fractional_precision, and truncate to the given microseconds.
+ */
+static iERR ionc_timestamp_fraction(ION_TIMESTAMP* timestamp, decContext* context, int* digits_out,
+                                    int* fractional_precision_out, int* microseconds_out) {
+    iENTER;
+    decQuad fraction = timestamp->fraction;
+    decQuad tmp;
+    int fractional_precision = decQuadGetExponent(&fraction);
+    if (fractional_precision > 0) {
+        _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Timestamp fractional precision cannot be a positive number.");
+    }
+    fractional_precision = fractional_precision * -1;
+
+    decQuadScaleB(&fraction, &fraction, decQuadFromInt32(&tmp, fractional_precision), context);
+    int dec = decQuadToInt32Exact(&fraction, context, DEC_ROUND_DOWN);
+    if (fractional_precision > MAX_TIMESTAMP_PRECISION) fractional_precision = MAX_TIMESTAMP_PRECISION;
+    if (decContextTestStatus(context, DEC_Inexact)) {
+        // This means the fractional component is not [0, 1) or has more than microsecond precision.
+        decContextClearStatus(context, DEC_Inexact);
+    }
+
+    // Microseconds keeps the first six digits of the fractional seconds.
+    int64_t micros = dec;
+    for (int i = fractional_precision; i < MICROSECOND_DIGITS; i++) micros *= 10;
+    for (int i = MICROSECOND_DIGITS; i < fractional_precision; i++) micros /= 10;
+    *digits_out = dec;
+    *fractional_precision_out = fractional_precision;
+    *microseconds_out = (int)micros;
+    iRETURN;
+}
+
+/*
+ *  Returns a new Decimal of the non-negative 'digits' * 10^'exponent', built from its (sign, digits, exponent) tuple
+ *  rather than from text.
+ */
+static PyObject* ionc_decimal_from_digits(_IONC_MODULE_STATE* state, int digits, int exponent) {
+    BYTE digit_values[10];
+    int count = 0, i;
+    PyObject* py_digits;
+    do {
+        digit_values[count++] = (BYTE)(digits % 10);
+        digits /= 10;
+    } while (digits > 0);
+    py_digits = PyTuple_New(count);
+    if (py_digits == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        // Small ints are cached by the interpreter, so this doesn't allocate.
+        PyTuple_SET_ITEM(py_digits, i, PyLong_FromLong(digit_values[count - 1 - i]));
+    }
+    return PyObject_CallFunction(state->decimal_constructor, "((iNi))", 0, py_digits, exponent);
+}
+
+static iERR ionc_timestamp_to_py(_IONC_MODULE_STATE* state, ION_TIMESTAMP* timestamp, decContext* context,
+                                 PyObject** timestamp_out) {
+    iENTER;
+    IONC_STAT_TIMER_START(state, started);
+    ION_TIMESTAMP timestamp_value = *timestamp;
+    PyObject* py_fractional_seconds = state->decimal_zero;
+    PyObject* py_fractional_precision = NULL;
+    PyObject* tzinfo = Py_None;
+
+    int year, month = 1, day = 1, hours = 0, minutes = 0, seconds = 0, microseconds = 0, precision,
+        fractional_precision = 0;
+    IONCHECK(ion_timestamp_get_precision(&timestamp_value, &precision));
+    if (precision < ION_TS_YEAR) {
+        _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Found a timestamp with less than year precision.");
+    }
+    PyObject* py_precision = ionc_get_timestamp_precision(state, precision);
+
+    BOOL has_local_offset;
+    IONCHECK(ion_timestamp_has_local_offset(&timestamp_value, &has_local_offset));
+    if (has_local_offset) {
+        int off_minutes;
+        IONCHECK(ion_timestamp_get_local_offset(&timestamp_value, &off_minutes));
+        tzinfo = ionc_get_timezone(state, off_minutes);
+        if (!tzinfo) {
+            tzinfo = Py_None;
+            FAILWITH(IERR_INTERNAL_ERROR);
+        }
+    }
+
+    switch (precision) {
+        case ION_TS_FRAC:
+        {
+            int dec;
+            IONCHECK(ionc_timestamp_fraction(&timestamp_value, context, &dec, &fractional_precision, &microseconds));
+
+            py_fractional_seconds = ionc_decimal_from_digits(state, dec, -fractional_precision);
+            if (fractional_precision > MICROSECOND_DIGITS) fractional_precision = MICROSECOND_DIGITS;
+            if (!py_fractional_seconds) {
+                py_fractional_seconds = state->decimal_zero;
+                FAILWITH(IERR_INTERNAL_ERROR);
+            }
+        }
+        case ION_TS_SEC:
+        {
+            seconds = timestamp_value.seconds;
+        }
+        case ION_TS_MIN:
+        {
+            minutes = timestamp_value.minutes;
+            hours = timestamp_value.hours;
+        }
+        case ION_TS_DAY:
+        {
+            day = timestamp_value.day;
+        }
+        case ION_TS_MONTH:
+        {
+            month = timestamp_value.month;
+        }
+        case ION_TS_YEAR:
+        {
+            year = timestamp_value.year;
+            break;
+        }
+        default:
+            _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Illegal Timestamp Precision!")
+    }
+    // Allocate the Timestamp through the datetime C API rather than calling Timestamp.__new__, which would parse
+    // keyword arguments and recompute microseconds from the Decimal. Its extended attributes are set directly.
+    *timestamp_out = PyDateTimeAPI->DateTime_FromDateAndTime(year, month, day, hours, minutes, seconds, microseconds,
+                                                             tzinfo, (PyTypeObject*)state->py_timestamp_cls);
+    if (*timestamp_out) {
+        py_fractional_precision = PyLong_FromLong(fractional_precision);
+        if (!py_fractional_precision
+                || PyObject_SetAttr(*timestamp_out, state->precision_str, py_precision)
+                || PyObject_SetAttr(*timestamp_out, state->fractional_precision_str, py_fractional_precision)
+                || PyObject_SetAttr(*timestamp_out, state->fractional_seconds_str, py_fractional_seconds)) {
+            Py_CLEAR(*timestamp_out);
+        }
+    }
+
+fail:
+    if (py_fractional_seconds != state->decimal_zero) Py_DECREF(py_fractional_seconds);
+    Py_XDECREF(py_fractional_precision);
+    if (tzinfo != Py_None) Py_DECREF(tzinfo);
+    IONC_STAT_TIMER_STOP(state, timestamp_nanos, started);
+
+    cRETURN;
+}
+
+static iERR ionc_read_timestamp(hREADER hreader, _ION_READ_CONTEXT* context, PyObject** timestamp_out) {
+    iENTER;
+    ION_TIMESTAMP timestamp_value;
+    IONCHECK(ion_reader_read_timestamp(hreader, &timestamp_value));
+    IONCHECK(ionc_timestamp_to_py(context->state, &timestamp_value, &context->dec_context, timestamp_out));
+    iRETURN;
+}
+
+/*
+ *  Reads values from a container
+ *
+ *  Args:
+ *      hreader:  An ion reader
+ *      container: A container that elements are read into
+ *      parent_type: Type of container to add to.
+ *      context: The read context, holding the value model flags and the symbol cache
+ *
+ */
+static iERR ionc_read_into_container(hREADER hreader, PyObject* container, enum ContainerType parent_type, _ION_READ_CONTEXT* context) {
+    iENTER;
+    IONCHECK(ion_reader_step_in(hreader));
+    IONCHECK(Py_EnterRecursiveCall(" while reading an Ion container"));
+    err = ionc_read_all(hreader, container, parent_type, context);
+    Py_LeaveRecursiveCall();
+    IONCHECK(err);
+    IONCHECK(ion_reader_step_out(hreader));
+    iRETURN;
+}
+
+/*
+ *  Adds an element to a List or struct
+ *
+ *  Args:
+ *      pyContainer:  A container that the element is added to
+ *      element:  The element to be added to the container
+ *      container_type: Type of container to add to.
+ *      field_name:  The field name of the element if it is inside a struct
+ */
+static void ionc_add_to_container(PyObject* pyContainer, PyObject* element, enum ContainerType container_type, PyObject* field_name) {
+    switch (container_type) {
+        case MULTIMAP:
+        {
+            // this builds the "hash-map of lists" structure that the IonPyDict object
+            // expects for its __store
+            PyObject* empty = PyList_New(0);
+            // SetDefault performs get|set with a single hash of the key
+            PyObject* found = PyDict_SetDefault(pyContainer, field_name, empty);
+            PyList_Append(found, element);
+
+            Py_DECREF(empty);
+            break;
+        }
+        case STD_DICT:
+        {
+            PyDict_SetItem(pyContainer, field_name, element);
+            break;
+        }
+        case LIST:
+        {
+            PyList_Append(pyContainer, (PyObject*)element);
+            break;
+        }
+    }
+    Py_XDECREF(element);
+}
+
+/*
+ *  Builds an IonPy value without calling into its Python constructor or from_value. The builtin base type allocates
+ *  the instance of the IonPy subclass, then the Ion attributes are set on it, the same as from_value does.
+ *
+ *  Args:
+ *      state:  The state of the module
+ *      base_type:  The builtin type the IonPy class derives from, e.g. PyLong_Type for IonPyInt
+ *      ionpy_cls:  The IonPy class
+ *      value:  The single argument to the base type's constructor, or NULL for none
+ *      py_ion_type:  The IonType to set, or NULL to keep the class default
+ *      py_annotations:  A tuple of annotations, or NULL for none
+ *
+ *  Returns:
+ *      A new reference to the IonPy value, or NULL with a Python exception set
+ */
+static PyObject* ionc_new_ionpy_value(_IONC_MODULE_STATE* state, PyTypeObject* base_type, PyObject* ionpy_cls,
+                                      PyObject* value, PyObject* py_ion_type, PyObject* py_annotations) {
+    PyObject* args = state->empty_tuple;
+    PyObject* ionpy_value;
+    if (value != NULL) {
+        args = PyTuple_Pack(1, value);
+        if (args == NULL) return NULL;
+    }
+    ionpy_value = base_type->tp_new((PyTypeObject*)ionpy_cls, args, NULL);
+    if (value != NULL) Py_DECREF(args);
+    if (ionpy_value == NULL) return NULL;
+
+    if ((py_ion_type != NULL && PyObject_SetAttr(ionpy_value, state->ion_type_str, py_ion_type) < 0)
+            || PyObject_SetAttr(ionpy_value, state->ion_annotations_str,
+                                py_annotations ? py_annotations : state->empty_tuple) < 0) {
+        Py_DECREF(ionpy_value);
+        return NULL;
+    }
+    return ionpy_value;
+}
+
+/*
+ *  Helper function for 'ionc_read_all', reads an ion value
+ *
+ *  Args:
+ *      hreader:  An ion reader
+ *      ION_TYPE:  The ion type of the reading value as an int
+ *      parent_type: Type of the parent container.
+ *      context: The read context, holding the value model flags and the symbol cache
+ */
+iERR ionc_read_value(hREADER hreader, ION_TYPE t, PyObject* container, enum ContainerType parent_type, _ION_READ_CONTEXT* context) {
+    iENTER;
+
+    _IONC_MODULE_STATE* state = context->state;
+    uint8_t     value_model = context->value_model;
+    BOOL        wrap_py_value = !(value_model & 1);
+    BOOL        symbol_as_text = value_model & 2;
+    BOOL        use_std_dict   = value_model & 4;
+
+    BOOL        is_null;
+    ION_STRING  field_name;
+    SIZE        annotation_count;
+    PyObject*   py_annotations = NULL;
+    PyObject*   py_value = NULL;
+    PyObject*   ion_nature_constructor = NULL; // a from_value, for types without a native constructor
+    PyObject*   ion_nature_cls = NULL;
+    PyTypeObject* ion_nature_base = NULL;
+    PyObject*   py_field_name = NULL;
+    PyObject*   fields = context->fields;
+
+    if (parent_type > LIST) {
+        IONCHECK(ion_reader_get_field_name(hreader, &field_name));
+        py_field_name = ion_build_py_symbol_text(context, &field_name);
+        if (fields != NULL) {
+            PyObject* field_projection = py_field_name == Py_None ? NULL : PyDict_GetItem(fields, py_field_name);
+            if (field_projection == NULL) {
+                // Not projected: the next ion_reader_next skips it without its value being read or stepped into.
+                SUCCEED();
+            }
+            context->fields = field_projection == Py_None ? NULL : field_projection;
+        }
+    }
+
+    IONCHECK(ion_reader_get_annotation_count(hreader, &annotation_count));
+    if (annotation_count > 0) {
+        wrap_py_value = TRUE;
+        ION_STRING* annotations = (ION_STRING*)ionc_read_temp(context, annotation_count * sizeof(ION_STRING));
+        if (annotations == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        IONCHECK(ion_reader_get_annotations(hreader, annotations, annotation_count, &annotation_count));
+        py_annotations = PyTuple_New(annotation_count);
+        int i;
+        for (i = 0; i < annotation_count; i++) {
+            PyTuple_SetItem(py_annotations, i, ion_string_to_py_symboltoken_cached(context, &annotations[i]));
+        }
+    }
+    ION_TYPE original_t = t;
+    IONCHECK(ion_reader_is_null(hreader, &is_null));
+    if (is_null) {
+        t = tid_NULL;
+    }
+    int ion_type = ION_TYPE_INT(t);
+
+    switch (ion_type) {
+        case tid_EOF_INT:
+            SUCCEED();
+        case tid_NULL_INT:
+        {
+            // TODO double check the real null type, now it's initialized to IonType.NULL by default
+            ION_TYPE null_type;
+            // Hack for ion-c issue https://github.com/amazon-ion/ion-c/issues/223
+            if (original_t != tid_SYMBOL_INT) {
+                IONCHECK(ion_reader_read_null(hreader, &null_type));
+            }
+            else {
+                null_type = tid_SYMBOL;
+            }
+
+            ion_type = ION_TYPE_INT(null_type);
+            py_value = Py_None;
+            // you wouldn't think you need to incref Py_None, and in
+            // newer C API versions you won't, but for now you do.
+            // see https://github.com/python/cpython/issues/103906 for more
+            Py_INCREF(py_value);
+            wrap_py_value = wrap_py_value || (ion_type != tid_NULL_INT);
+            ion_nature_cls = state->ionpynull_cls;
+            ion_nature_base = &PyBaseObject_Type;
+            break;
+        }
+        case tid_BOOL_INT:
+        {
+            BOOL bool_value;
+            IONCHECK(ion_reader_read_bool(hreader, &bool_value));
+            py_value = PyBool_FromLong(bool_value);
+            ion_nature_cls = state->ionpybool_cls;
+            ion_nature_base = &PyLong_Type;
+            break;
+        }
+        case tid_INT_INT:
+        {
+            int64_t int64_value;
+            err = ion_reader_read_int64(hreader, &int64_value);
+            if (err == IERR_OK) {
+                py_value = PyLong_FromLongLong(int64_value);
+            } else if (err == IERR_NUMERIC_OVERFLOW) {
+                ION_INT ion_int_value;
+                SIZE int_len, int_written;
+                BOOL is_negative;
+                IONCHECK(ion_int_init(&ion_int_value, hreader));
+                IONCHECK(ion_reader_read_ion_int(hreader, &ion_int_value));
+                IONCHECK(ion_int_abs_bytes_length(&ion_int_value, &int_len));
+                BYTE* int_bytes = (BYTE*)ionc_read_temp(context, int_len);
+                if (int_bytes == NULL) {
+                    FAILWITH(IERR_NO_MEMORY);
+                }
+                IONCHECK(ion_int_to_abs_bytes(&ion_int_value, 0, int_bytes, int_len, &int_written));
+                IONCHECK(ion_int_is_negative(&ion_int_value, &is_negative));
+                py_value = ionc_int_from_abs_bytes(int_bytes, int_written, is_negative);
+            } else {
+                FAILWITH(err)
+            }
+
+            ion_nature_cls = state->ionpyint_cls;
+            ion_nature_base = &PyLong_Type;
+            break;
+        }
+        case tid_FLOAT_INT:
+        {
+            double double_value;
+            IONCHECK(ion_reader_read_double(hreader, &double_value));
+            py_value = Py_BuildValue("d", double_value);
+            ion_nature_cls = state->ionpyfloat_cls;
+            ion_nature_base = &PyFloat_Type;
+            break;
+        }
+        case tid_DECIMAL_INT:
+        {
+            ION_DECIMAL decimal_value;
+            IONC_STAT_TIMER_START(state, started);
+            IONCHECK(ion_reader_read_ion_decimal(hreader, &decimal_value));
+            // Only decimals wider than a decQuad need more than the stack.
+            char dec_buffer[DECQUAD_Pmax + 14];
+            SIZE dec_len = ionc_decimal_py_decstr_len(&decimal_value);
+            char* dec_str = dec_len < sizeof(dec_buffer) ? dec_buffer : (char*)ionc_read_temp(context, dec_len + 1);
+            if (!dec_str) {
+                ion_decimal_free(&decimal_value);
+                FAILWITH(IERR_NO_MEMORY);
+            }
+            dec_len = ionc_decimal_to_py_decstr(&decimal_value, dec_str);
+
+            if (wrap_py_value) {
+                py_value = PyUnicode_FromStringAndSize(dec_str, dec_len);
+            } else {
+                py_value = PyObject_CallFunction(state->decimal_constructor, "s#", dec_str, (Py_ssize_t)dec_len, NULL);
+            }
+            ion_decimal_free(&decimal_value);
+            IONC_STAT_TIMER_STOP(state, decimal_nanos, started);
+
+            ion_nature_cls = state->ionpydecimal_cls;
+            ion_nature_base = (PyTypeObject*)state->decimal_constructor;
+            break;
+        }
+        case tid_TIMESTAMP_INT:
+        {
+            IONCHECK(ionc_read_timestamp(hreader, context, &py_value));
+            ion_nature_constructor = state->ionpytimestamp_fromvalue;
+            break;
+        }
+        case tid_SYMBOL_INT:
+        {
+            ION_STRING string_value;
+            IONCHECK(ion_reader_read_string(hreader, &string_value));
+            if (!symbol_as_text) {
+                py_value = ion_string_to_py_symboltoken_cached(context, &string_value);
+                ion_nature_cls = state->ionpysymbol_cls;
+                ion_nature_base = &PyTuple_Type;
+            } else if (ion_string_is_null(&string_value)) {
+                _FAILWITHMSG(IERR_INVALID_STATE, "Cannot emit symbol with undefined text when SYMBOL_AS_TEXT is set.");
+            } else {
+                py_value = ion_build_py_symbol_text(context, &string_value);
+                ion_nature_cls = state->ionpytext_cls;
+                ion_nature_base = &PyUnicode_Type;
+            }
+            break;
+        }
+        case tid_STRING_INT:
+        {
+            ION_STRING string_value;
+            IONCHECK(ion_reader_read_string(hreader, &string_value));
+            py_value = ion_build_py_string(&string_value);
+            ion_nature_cls = state->ionpytext_cls;
+            ion_nature_base = &PyUnicode_Type;
+            break;
+        }
+        case tid_CLOB_INT:
+        {
+            // Clob values must always be emitted as IonPyBytes, to avoid ambiguity with blob.
+            wrap_py_value = TRUE;
+            // intentional fall-through
+        }
+        case tid_BLOB_INT:
+        {
+            SIZE length, bytes_read;
+            IONCHECK(ion_reader_get_lob_size(hreader, &length));
+            // The lob is read straight into the bytes object rather than copied in from a temporary buffer.
+            py_value = PyBytes_FromStringAndSize(NULL, length);
+            if (py_value == NULL) {
+                FAILWITH(IERR_NO_MEMORY);
+            }
+            if (length) {
+                IONCHECK(ion_reader_read_lob_bytes(hreader, (BYTE*)PyBytes_AS_STRING(py_value), length, &bytes_read));
+                if (length != bytes_read) {
+                    FAILWITH(IERR_EOF);
+                }
+            }
+            ion_nature_cls = state->ionpybytes_cls;
+            ion_nature_base = &PyBytes_Type;
+            break;
+        }
+        case tid_STRUCT_INT:
+        {
+            enum ContainerType container_type;
+
+            if (use_std_dict) {
+                if (wrap_py_value) {
+                    // we construct an empty IonPyStdDict and don't wrap later to avoid
+                    // copying the values when wrapping or needing to delegate in the impl
+                    py_value = ionc_new_ionpy_value(state, &PyDict_Type, state->ionpystddict_cls, NULL, NULL,
+                                                    py_annotations);
+                    if (py_value == NULL) {
+                        FAILWITH(IERR_INTERNAL_ERROR);
+                    }
+                    wrap_py_value = FALSE;
+                } else {
+                    py_value = PyDict_New();
+                }
+                container_type = STD_DICT;
+            } else {
+                py_value = PyDict_New();
+                container_type = MULTIMAP;
+            }
+
+            IONCHECK(ionc_read_into_container(hreader, py_value, container_type, context));
+            if (container_type == MULTIMAP) {
+                // there is no non-IonPy multimap so we always wrap, handing the store over as IonPyDict._factory does
+                PyObject* store = py_value;
+                py_value = ionc_new_ionpy_value(state, &PyBaseObject_Type, state->ionpydict_cls, NULL, NULL,
+                                                py_annotations);
+                if (py_value != NULL && PyObject_SetAttr(py_value, state->store_str, store) < 0) {
+                    Py_CLEAR(py_value);
+                }
+                Py_DECREF(store);
+                if (py_value == NULL) {
+                    FAILWITH(IERR_INTERNAL_ERROR);
+                }
+                wrap_py_value = FALSE;
+            }
+            break;
+        }
+        case tid_SEXP_INT:
+        {
+            // Sexp values must always be emitted as IonPyList to avoid ambiguity with list.
+            wrap_py_value = TRUE;
+            // intentional fall-through
+        }
+        case tid_LIST_INT:
+        {
+            // instead of creating a std Python list and "wrapping" it
+            // which would copy the elements, create the IonPyList now
+            if (wrap_py_value) {
+                py_value = ionc_new_ionpy_value(state, &PyList_Type, state->ionpylist_cls, NULL,
+                                                state->py_ion_type_table[ion_type >> 8], py_annotations);
+                if (py_value == NULL) {
+                    FAILWITH(IERR_INTERNAL_ERROR);
+                }
+                wrap_py_value = FALSE;
+            } else {
+                py_value = PyList_New(0);
+            }
+            IONCHECK(ionc_read_into_container(hreader, py_value, LIST, context));
+            break;
+        }
+        case tid_DATAGRAM_INT:
+        default:
+            FAILWITH(IERR_INVALID_STATE);
+        }
+
+    IONC_STAT_VALUE(state, ion_type);
+    PyObject* final_py_value = py_value;
+    if (wrap_py_value) {
+        IONC_STAT_ADD(state, wrappers, 1);
+        if (ion_nature_base != NULL) {
+            // IonPyNull takes no value: from_value only keeps the type and annotations of a null.
+            final_py_value = ionc_new_ionpy_value(
+                state,
+                ion_nature_base,
+                ion_nature_cls,
+                ion_nature_base == &PyBaseObject_Type ? NULL : py_value,
+                state->py_ion_type_table[ion_type >> 8],
+                py_annotations
+            );
+        }
+        else {
+            final_py_value = PyObject_CallFunctionObjArgs(
+                ion_nature_constructor,
+                state->py_ion_type_table[ion_type >> 8],
+                py_value,
+                py_annotations,
+                NULL
+            );
+        }
+        Py_CLEAR(py_value);
+        if (final_py_value == NULL) {
+            FAILWITH(IERR_INTERNAL_ERROR);
+        }
+    }
+
+    ionc_add_to_container(container, final_py_value, parent_type, py_field_name);
+
+fail:
+    context->fields = fields;
+    Py_XDECREF(py_annotations);
+    // note: we're not actually increffing None when we have a field name that has
+    // no text, which we technically _should_ be doing.
+    // todo: consider increffing Py_None in ion_build_py_string
+    if (py_field_name && py_field_name != Py_None) Py_DECREF(py_field_name);
+    if (err) {
+        Py_XDECREF(py_value);
+    }
+    cRETURN;
+}
+
+/*
+ *  Reads ion values
+ *
+ *  Args:
+ *      hreader:  An ion reader
+ *      container:  A container that elements are read from
+ *      parent_type: the type of the container to add to.
+ *      context: The read context, holding the value model flags and the symbol cache
+ *
+ */
+iERR ionc_read_all(hREADER hreader, PyObject* container, enum ContainerType parent_type, _ION_READ_CONTEXT* context) {
+    iENTER;
+    ION_TYPE t;
+    for (;;) {
+        IONCHECK(ion_reader_next(hreader, &t));
+        if (t == tid_EOF) {
+            assert(t == tid_EOF && "next() at end");
+            break;
+        }
+        IONCHECK(ionc_read_value(hreader, t, container, parent_type, context));
+    }
+    iRETURN;
+}
+
+/*
+ *  Makes room for 'size' bytes in the stream handle's buffer. The buffer only holds the bytes of the last read, which
+ *  ion-c has consumed by the time it asks for more, so it is not copied when it grows.
+ */
+static iERR ionc_read_stream_reserve(_ION_READ_STREAM_HANDLE *stream_handle, Py_ssize_t size) {
+    iENTER;
+    if (size > stream_handle->buffer_capacity) {
+        PyMem_Free(stream_handle->buffer);
+        stream_handle->buffer = (BYTE*)PyMem_Malloc(size);
+        stream_handle->buffer_capacity = stream_handle->buffer ? size : 0;
+        IONC_STAT_ADD(stream_handle->state, allocations, 1);
+        if (stream_handle->buffer == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+    }
+    iRETURN;
+}
+
+/*
+ *  Doubles the read size after a full read that was faster than the previous one, e.g. from a source with a high
+ *  per-call latency, and settles on the current size once the throughput stops rising.
+ */
+static void ionc_read_stream_adapt(_ION_READ_STREAM_HANDLE *stream_handle, Py_ssize_t size, double elapsed) {
+    if (size < stream_handle->read_size) {
+        return; // a short read, e.g. the end of the stream, says nothing about larger reads
+    }
+    double throughput = elapsed > 0 ? size / elapsed : 0;
+    if (throughput > stream_handle->throughput) {
+        stream_handle->throughput = throughput;
+        stream_handle->read_size = (stream_handle->read_size > stream_handle->max_read_size / 2)
+                                   ? stream_handle->max_read_size : stream_handle->read_size * 2;
+    }
+    else {
+        stream_handle->max_read_size = stream_handle->read_size;
+    }
+}
+
+iERR ion_read_file_stream_handler(struct _ion_user_stream *pstream) {
+    iENTER;
+    char *char_buffer = NULL;
+    Py_ssize_t size;
+    _ION_READ_STREAM_HANDLE *stream_handle = (_ION_READ_STREAM_HANDLE *) pstream->handler_state;
+    PyObject *py_buffer_as_bytes = NULL;
+    PyObject *py_buffer = NULL;
+    PyObject *view = NULL;
+    BOOL adapting = stream_handle->max_read_size > stream_handle->read_size;
+    uint64_t started = adapting ? ionc_nanos() : 0;
+    IONC_STAT_TIMER_START(stream_handle->state, refill_started);
+
+    pstream->limit = NULL;
+    if (stream_handle->use_readinto) {
+        // Fill the buffer in place rather than copying out of a new bytes object for each read.
+        IONCHECK(ionc_read_stream_reserve(stream_handle, stream_handle->read_size));
+        view = PyMemoryView_FromMemory((char *)stream_handle->buffer, stream_handle->read_size, PyBUF_WRITE);
+        if (view == NULL) {
+            FAILWITH(IERR_READ_ERROR);
+        }
+        py_buffer = PyObject_CallMethodObjArgs(stream_handle->py_file, stream_handle->state->readinto_str, view, NULL);
+        if (py_buffer == NULL || py_buffer == Py_None) {
+            FAILWITH(IERR_READ_ERROR);
+        }
+        size = PyLong_AsSsize_t(py_buffer);
+        // safe-guarding the size variable, which bounds what ion-c reads from the buffer
+        if (size < 0 || size > stream_handle->read_size) {
+            FAILWITH(IERR_READ_ERROR);
+        }
+    }
+    else {
+        py_buffer = PyObject_CallMethod(stream_handle->py_file, "read", "n", stream_handle->read_size);
+        if (py_buffer == NULL) {
+            FAILWITH(IERR_READ_ERROR);
+        }
+
+        if (PyBytes_Check(py_buffer)) {
+            // stream is binary
+            if (PyBytes_AsStringAndSize(py_buffer, &char_buffer, &size) < 0) {
+                FAILWITH(IERR_READ_ERROR);
+            }
+        } else {
+            // convert str to unicode
+            py_buffer_as_bytes = PyUnicode_AsUTF8String(py_buffer);
+            if (py_buffer_as_bytes == NULL || py_buffer_as_bytes == Py_None) {
+                FAILWITH(IERR_READ_ERROR);
+            }
+            if (PyBytes_AsStringAndSize(py_buffer_as_bytes, &char_buffer, &size) < 0) {
+                FAILWITH(IERR_READ_ERROR);
+            }
+        }
+
+        // the UTF-8 encoding of text may be larger than the number of characters read
+        if (size < 0 || size > INT32_MAX) {
+            FAILWITH(IERR_READ_ERROR);
+        }
+        IONCHECK(ionc_read_stream_reserve(stream_handle, size));
+        memcpy(stream_handle->buffer, char_buffer, size);
+    }
+    if (adapting) {
+        ionc_read_stream_adapt(stream_handle, size, (ionc_nanos() - started) / 1e9);
+    }
+    IONC_PROBE1(refill, size);
+    IONC_STAT_ADD(stream_handle->state, refills, 1);
+    IONC_STAT_ADD(stream_handle->state, refill_bytes, size);
+    IONC_STAT_TIMER_STOP(stream_handle->state, refill_nanos, refill_started);
+
+    pstream->curr = stream_handle->buffer;
+    if (size < 1) {
+        pstream->limit = NULL;
+        DONTFAILWITH(IERR_EOF);
+    }
+    pstream->limit = pstream->curr + size;
+
+fail:
+    Py_XDECREF(view);
+    Py_XDECREF(py_buffer_as_bytes);
+    Py_XDECREF(py_buffer);
+    cRETURN;
+}
+
+/*
+ *  Hands ion-c the next chunk of a pinned buffer. The chunks are read in place and never change, so nothing is
+ *  copied, and since it does not call into python it can run without the GIL.
+ */
+iERR ion_read_pinned_stream_handler(struct _ion_user_stream *pstream) {
+    iENTER;
+    _ION_PINNED_STREAM *pinned_stream = (_ION_PINNED_STREAM *) pstream->handler_state;
+    Py_ssize_t size = pinned_stream->remaining < pinned_stream->chunk_size
+                      ? pinned_stream->remaining : pinned_stream->chunk_size;
+
+    pstream->curr = pinned_stream->next;
+    if (size < 1) {
+        pstream->limit = NULL;
+        DONTFAILWITH(IERR_EOF);
+    }
+    pstream->limit = pstream->curr + size;
+    pinned_stream->next += size;
+    pinned_stream->remaining -= size;
+    iRETURN;
+}
+
+/*
+ *  Opens a reader over a pinned bytes-like buffer. A buffer ion_reader_open_buffer can't take at once is read through
+ *  'pinned_stream' instead, which must outlive the reader. Like the handler, this can run without the GIL.
+ */
+static iERR ionc_reader_open_pinned(_IONC_MODULE_STATE* state, hREADER *reader, Py_buffer *buffer,
+                                    _ION_PINNED_STREAM *pinned_stream, ION_READER_OPTIONS *options) {
+    iENTER;
+    Py_ssize_t max_len = state->max_buffer_len;
+    if (buffer->len <= max_len) {
+        IONCHECK(ion_reader_open_buffer(reader, (BYTE*)buffer->buf, (SIZE)buffer->len, options));
+        SUCCEED();
+    }
+    pinned_stream->next = (BYTE*)buffer->buf;
+    pinned_stream->remaining = buffer->len;
+    pinned_stream->chunk_size = max_len < IONC_STREAM_MAX_READ_SIZE ? max_len : IONC_STREAM_MAX_READ_SIZE;
+    IONCHECK(ion_reader_open_stream(reader, pinned_stream, ion_read_pinned_stream_handler, options));
+    iRETURN;
+}
+
+/*
+ *  Sets the length above which bytes-like input is streamed to ion-c in chunks, for tests of the chunked reads.
+ *  Returns the previous length.
+ */
+PyObject* ionc_set_max_buffer_len(PyObject* self, PyObject *args, PyObject *kwds) {
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_ssize_t max_len = INT32_MAX, previous = state->max_buffer_len;
+    static char *kwlist[] = {"max_len", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n", kwlist, &max_len)) {
+        return NULL;
+    }
+    if (max_len < 1 || max_len > INT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "max_len must be between 1 and 2**31 - 1.");
+        return NULL;
+    }
+    state->max_buffer_len = max_len;
+    return PyLong_FromSsize_t(previous);
+}
+
+/*
+ *  Starts decompressing the stream, which may be gzip or zlib: 'compression' only says that it is compressed. When
+ *  'source' is given it holds all of the compressed input, which must stay pinned until the read is done, otherwise
+ *  it is read from the handle's py_file.
+ */
+static iERR ionc_read_stream_open_inflater(_ION_READ_STREAM_HANDLE *stream_handle, const char* compression,
+                                           Py_buffer* source) {
+    iENTER;
+#ifdef IONC_WITH_ZLIB
+    if (strcmp(compression, "gzip") != 0 && strcmp(compression, "zlib") != 0) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "compression must be None, 'gzip' or 'zlib'.");
+    }
+    stream_handle->inflater = (z_stream*)PyMem_Calloc(1, sizeof(z_stream));
+    if (stream_handle->inflater == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    // 32 enables the detection of the gzip or zlib header.
+    if (inflateInit2(stream_handle->inflater, MAX_WBITS + 32) != Z_OK) {
+        PyMem_Free(stream_handle->inflater);
+        stream_handle->inflater = NULL;
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    // Empty input is an empty stream.
+    stream_handle->at_member_end = TRUE;
+    stream_handle->compressed_source = source;
+    stream_handle->compressed_offset = 0;
+#else
+    _FAILWITHMSG(IERR_INVALID_ARG, "The C extension was built without zlib.");
+#endif
+    iRETURN;
+}
+
+static void ionc_read_stream_close_inflater(_ION_READ_STREAM_HANDLE *stream_handle) {
+#ifdef IONC_WITH_ZLIB
+    if (stream_handle->inflater != NULL) {
+        inflateEnd(stream_handle->inflater);
+        PyMem_Free(stream_handle->inflater);
+        stream_handle->inflater = NULL;
+    }
+#endif
+    Py_CLEAR(stream_handle->compressed_chunk);
+}
+
+#ifdef IONC_WITH_ZLIB
+/*
+ *  Hands the inflater the next read_size bytes of the compressed file. They are decompressed straight out of the
+ *  bytes object returned by read, which is kept until they have all been used.
+ */
+static iERR ionc_read_stream_read_compressed(_ION_READ_STREAM_HANDLE *stream_handle) {
+    iENTER;
+    char *data;
+    Py_ssize_t size;
+    if (stream_handle->compressed_source != NULL) {
+        // The inflater counts its input in a uInt, so a large buffer is handed over a chunk at a time.
+        size = stream_handle->compressed_source->len - stream_handle->compressed_offset;
+        if (size > IONC_STREAM_MAX_READ_SIZE) {
+            size = IONC_STREAM_MAX_READ_SIZE;
+        }
+        stream_handle->inflater->next_in = (BYTE*)stream_handle->compressed_source->buf
+                                           + stream_handle->compressed_offset;
+        stream_handle->inflater->avail_in = (uInt)size;
+        stream_handle->compressed_offset += size;
+        stream_handle->compressed_eof = stream_handle->compressed_offset == stream_handle->compressed_source->len;
+        SUCCEED();
+    }
+    Py_CLEAR(stream_handle->compressed_chunk);
+    stream_handle->compressed_chunk = PyObject_CallMethod(stream_handle->py_file, "read", "n",
+                                                          stream_handle->read_size);
+    if (stream_handle->compressed_chunk == NULL) {
+        FAILWITH(IERR_READ_ERROR);
+    }
+    if (!PyBytes_Check(stream_handle->compressed_chunk)) {
+        _FAILWITHMSG(IERR_READ_ERROR, "Compressed input must be read from a binary file.");
+    }
+    if (PyBytes_AsStringAndSize(stream_handle->compressed_chunk, &data, &size) < 0 || size > INT32_MAX) {
+        FAILWITH(IERR_READ_ERROR);
+    }
+    stream_handle->inflater->next_in = (BYTE*)data;
+    stream_handle->inflater->avail_in = (uInt)size;
+    stream_handle->compressed_eof = size == 0;
+    IONC_PROBE1(refill, size);
+    IONC_STAT_ADD(stream_handle->state, refills, 1);
+    IONC_STAT_ADD(stream_handle->state, refill_bytes, size);
+    iRETURN;
+}
+
+/*
+ *  The decompressing twin of ion_read_file_stream_handler. Fills blocks of IONC_STREAM_INFLATE_BUFFER_SIZE bytes
+ *  for ion-c, so a block is decompressed per call and the file is only called for every read_size compressed bytes.
+ *  Concatenated gzip members, as written by appending to a .gz file, are read one after another.
+ */
+iERR ion_read_inflate_stream_handler(struct _ion_user_stream *pstream) {
+    iENTER;
+    _ION_READ_STREAM_HANDLE *stream_handle = (_ION_READ_STREAM_HANDLE *) pstream->handler_state;
+    z_stream *inflater = stream_handle->inflater;
+    int status;
+    IONC_STAT_TIMER_START(stream_handle->state, refill_started);
+
+    pstream->limit = NULL;
+    IONCHECK(ionc_read_stream_reserve(stream_handle, IONC_STREAM_INFLATE_BUFFER_SIZE));
+    inflater->next_out = stream_handle->buffer;
+    inflater->avail_out = IONC_STREAM_INFLATE_BUFFER_SIZE;
+    while (inflater->avail_out > 0) {
+        if (inflater->avail_in == 0 && !stream_handle->compressed_eof) {
+            IONCHECK(ionc_read_stream_read_compressed(stream_handle));
+        }
+        if (inflater->avail_in == 0 && stream_handle->compressed_eof && stream_handle->at_member_end) {
+            break;
+        }
+        if (inflater->avail_in > 0) {
+            stream_handle->at_member_end = FALSE;
+        }
+        status = inflate(inflater, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            stream_handle->at_member_end = TRUE;
+            if (inflateReset(inflater) != Z_OK) {
+                FAILWITH(IERR_READ_ERROR);
+            }
+        }
+        else if (status == Z_BUF_ERROR && stream_handle->compressed_eof) {
+            _FAILWITHMSG(IERR_UNEXPECTED_EOF, "The compressed input is truncated.");
+        }
+        else if (status != Z_OK && status != Z_BUF_ERROR) {
+            _FAILWITHMSG(IERR_READ_ERROR, "The compressed input is invalid.");
+        }
+    }
+
+    SIZE size = IONC_STREAM_INFLATE_BUFFER_SIZE - (SIZE)inflater->avail_out;
+    IONC_STAT_TIMER_STOP(stream_handle->state, refill_nanos, refill_started);
+    pstream->curr = stream_handle->buffer;
+    if (size < 1) {
+        pstream->limit = NULL;
+        DONTFAILWITH(IERR_EOF);
+    }
+    pstream->limit = pstream->curr + size;
+
+fail:
+    cRETURN;
+}
+#endif
+
+/*
+ *  Reads up to 'max_count' top-level values into the container, or all of them if 'max_count' is negative, and closes
+ *  the reader at the end of the stream.
+ */
+static iERR ionc_read_iter_fill(ionc_read_Iterator *iterator, PyObject* container, Py_ssize_t max_count) {
+    iENTER;
+    ION_TYPE t;
+    Py_ssize_t count;
+
+    for (count = 0; !iterator->closed && (max_count < 0 || count < max_count); count++) {
+        IONCHECK(ion_reader_next(iterator->reader, &t));
+        if (t == tid_EOF) {
+            iterator->closed = TRUE;
+            IONCHECK(ion_reader_close(iterator->reader));
+            break;
+        }
+        err = ionc_read_value(iterator->reader, t, container, LIST, &iterator->context);
+        ionc_read_temp_reset(&iterator->context);
+        IONCHECK(err);
+    }
+    iRETURN;
+}
+
+PyObject* _ionc_read_iter_next(PyObject *self) {
+    iENTER;
+    ionc_read_Iterator *iterator = (ionc_read_Iterator*) self;
+    PyObject* container = iterator->scratch;
+
+    if (iterator->closed) {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+    if (container == NULL) {
+        container = iterator->scratch = PyList_New(0);
+        if (container == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+    }
+    IONCHECK(ionc_read_iter_fill(iterator, container, 1));
+    Py_ssize_t len = PyList_GET_SIZE(container);
+    if (len == 0 && iterator->closed) {
+        PyErr_SetNone(PyExc_StopIteration);
+        return NULL;
+    }
+    if (len != 1) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "assertion failed: len == 1");
+    }
+
+    // The value is taken out of the scratch list, which is reused rather than allocating a container per value.
+    PyObject* value = PyList_GET_ITEM(container, 0);
+    Py_INCREF(value);
+    PyList_SetSlice(container, 0, 1, NULL);
+
+    return value;
+
+fail:
+    if (container != NULL) {
+        PyList_SetSlice(container, 0, PyList_GET_SIZE(container), NULL);
+    }
+    PyObject* exception = PyErr_Format(iterator->context.state->ion_exception_cls, "%s %s", ion_error_to_str(err),
+                                       _err_msg);
+    _err_msg[0] = '\0';
+    return exception;
+}
+
+PyObject* ionc_read_iter_next(PyObject *self_obj) {
+    PyObject* result;
+    IONC_LOCK(((ionc_read_Iterator*) self_obj)->mutex);
+    result = _ionc_read_iter_next(self_obj);
+    IONC_UNLOCK(((ionc_read_Iterator*) self_obj)->mutex);
+    return result;
+}
+
+/*
+ *  Returns a list of up to n of the next top-level values, filled by one call into the reader loop.
+ */
+PyObject* _ionc_read_iter_next_batch(PyObject *self, PyObject *arg) {
+    iENTER;
+    ionc_read_Iterator *iterator = (ionc_read_Iterator*) self;
+    PyObject* values = NULL;
+    Py_ssize_t max_count = PyLong_AsSsize_t(arg);
+
+    if (max_count == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    values = PyList_New(0);
+    if (values == NULL) {
+        return NULL;
+    }
+    IONCHECK(ionc_read_iter_fill(iterator, values, max_count));
+    return values;
+
+fail:
+    Py_DECREF(values);
+    PyObject* exception = PyErr_Format(iterator->context.state->ion_exception_cls, "%s %s", ion_error_to_str(err),
+                                       _err_msg);
+    _err_msg[0] = '\0';
+    return exception;
+}
+
+PyObject* ionc_read_iter_next_batch(PyObject *self_obj, PyObject *arg) {
+    PyObject* result;
+    IONC_LOCK(((ionc_read_Iterator*) self_obj)->mutex);
+    result = _ionc_read_iter_next_batch(self_obj, arg);
+    IONC_UNLOCK(((ionc_read_Iterator*) self_obj)->mutex);
+    return result;
+}
+
+PyObject* ionc_read_iter(PyObject *self) {
+    Py_INCREF(self);
+    return self;
+}
+
+void ionc_read_iter_dealloc(PyObject *self) {
+    ionc_read_Iterator *iterator = (ionc_read_Iterator*) self;
+    if (!iterator->closed) {
+        ion_reader_close(iterator->reader);
+        iterator->closed = TRUE;
+    }
+    Py_DECREF(iterator->file_handler_state.py_file);
+    ionc_read_stream_close_inflater(&iterator->file_handler_state);
+    PyMem_Free(iterator->file_handler_state.buffer);
+    Py_XDECREF(iterator->catalog);
+    Py_XDECREF(iterator->fields);
+    Py_XDECREF(iterator->scratch);
+    if (iterator->buffer.obj != NULL) {
+        PyBuffer_Release(&iterator->buffer);
+    }
+    ionc_symbol_cache_clear(&iterator->context);
+    PyTypeObject* type = Py_TYPE(self);
+    PyObject_Del(self);
+    Py_DECREF(type);
+}
+
+/*
+ *  Entry point of read/load functions. 'file' is a file-like object, or any bytes-like object, which is read in place.
+ */
+PyObject* ionc_read(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    PyObject *py_file = NULL; // TextIOWrapper
+    uint8_t value_model = 0;
+    PyObject *text_buffer_size_limit;
+    PyObject *py_catalog = Py_None;
+    PyObject *py_fields = Py_None;
+    Py_ssize_t read_size = 0, max_read_size = 0;
+    const char *compression = NULL;
+    ionc_read_Iterator *iterator = NULL;
+    static char *kwlist[] = {"file", "value_model", "text_buffer_size_limit", "catalog", "fields", "read_size",
+                             "max_read_size", "compression", NULL};
+    // todo: this could be simpler and likely faster by converting to c types here.
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, IONC_READ_ARGS_FORMAT, kwlist, &py_file,
+                                     &value_model, &text_buffer_size_limit, &py_catalog, &py_fields,
+                                     &read_size, &max_read_size, &compression)) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
+    if (read_size <= 0) {
+        read_size = compression != NULL ? IONC_STREAM_COMPRESSED_READ_SIZE : IONC_STREAM_READ_BUFFER_SIZE;
+    }
+    if (compression != NULL) {
+        // The compressed reads are decompressed into blocks of a fixed size instead.
+        max_read_size = 0;
+    }
+    if (read_size > IONC_STREAM_MAX_READ_SIZE || max_read_size > IONC_STREAM_MAX_READ_SIZE) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "read_size and max_read_size must be at most 1 GiB.");
+    }
+    if (py_fields != Py_None && !PyDict_Check(py_fields)) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "fields must be a dict or None.");
+    }
+    iterator = PyObject_New(ionc_read_Iterator, (PyTypeObject*)state->read_iterator_type);
+    if (!iterator) {
+        FAILWITH(IERR_INTERNAL_ERROR);
+    }
+    Py_INCREF(py_file);
+    iterator->closed = FALSE;
+    memset(&iterator->mutex, 0, sizeof(iterator->mutex));
+    memset(&iterator->file_handler_state, 0, sizeof(iterator->file_handler_state));
+    iterator->file_handler_state.state = state;
+    iterator->file_handler_state.py_file = py_file;
+    iterator->file_handler_state.read_size = read_size;
+    iterator->file_handler_state.max_read_size = max_read_size;
+    memset(&iterator->context, 0, sizeof(iterator->context));
+    iterator->context.state = state;
+    iterator->context.value_model = value_model;
+    iterator->catalog = NULL;
+    iterator->fields = py_fields == Py_None ? NULL : py_fields;
+    Py_XINCREF(iterator->fields);
+    iterator->context.fields = iterator->fields;
+    iterator->buffer.obj = NULL;
+    iterator->scratch = NULL;
+
+    memset(&iterator->reader, 0, sizeof(iterator->reader));
+    memset(&iterator->_reader_options, 0, sizeof(iterator->_reader_options));
+    iterator->context.dec_context = state->dec_context;
+    iterator->_reader_options.decimal_context = &iterator->context.dec_context;
+    if (text_buffer_size_limit != Py_None) {
+        int symbol_threshold = PyLong_AsLong(text_buffer_size_limit);
+        iterator->_reader_options.symbol_threshold = symbol_threshold;
+    }
+    if (py_catalog != Py_None) {
+        IONCHECK(ionc_catalog_from_py(state, py_catalog, &iterator->catalog));
+        iterator->_reader_options.pcatalog = (hCATALOG) PyCapsule_GetPointer(iterator->catalog,
+                                                                             IONC_CATALOG_CAPSULE_NAME);
+    }
+
+    if (PyObject_CheckBuffer(py_file)) {
+        // A bytes-like object, e.g. bytes, bytearray, memoryview or mmap, is kept pinned and read in place.
+        if (PyObject_GetBuffer(py_file, &iterator->buffer, PyBUF_SIMPLE) < 0) {
+            iterator->buffer.obj = NULL;
+            FAILWITH(IERR_INVALID_ARG);
+        }
+        if (compression != NULL) {
+            IONCHECK(ionc_read_stream_open_inflater(&iterator->file_handler_state, compression, &iterator->buffer));
+#ifdef IONC_WITH_ZLIB
+            IONCHECK(ion_reader_open_stream(&iterator->reader, &iterator->file_handler_state,
+                                            ion_read_inflate_stream_handler, &iterator->_reader_options));
+#endif
+            return iterator;
+        }
+        IONCHECK(ionc_reader_open_pinned(state, &iterator->reader, &iterator->buffer, &iterator->pinned_stream,
+                                         &iterator->_reader_options));
+        return iterator;
+    }
+
+    if (compression != NULL) {
+        IONCHECK(ionc_read_stream_open_inflater(&iterator->file_handler_state, compression, NULL));
+#ifdef IONC_WITH_ZLIB
+        IONCHECK(ion_reader_open_stream(&iterator->reader, &iterator->file_handler_state,
+                                        ion_read_inflate_stream_handler, &iterator->_reader_options));
+#endif
+        return iterator;
+    }
+    iterator->file_handler_state.use_readinto = PyObject_HasAttr(py_file, state->readinto_str);
+    IONCHECK(ion_reader_open_stream(
+        &iterator->reader,
+        &iterator->file_handler_state,
+        ion_read_file_stream_handler,
+        &iterator->_reader_options)); // NULL represents default reader options
+    return iterator;
+
+fail:
+    if (iterator != NULL) {
+        // The reader was not opened; the dealloc releases py_file and the catalog.
+        iterator->closed = TRUE;
+        Py_DECREF(iterator);
+    }
+    PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+    _err_msg[0] = '\0';
+    return exception;
+}
+
+/******************************************************************************
+*       Buffer read, parsed without the GIL                                  *
+******************************************************************************/
+
+/*
+ *  A buffer is read in two phases. The first runs ion-c over the whole buffer with the GIL released and records every
+ *  value in a tape: a flat array of nodes in document order, with strings and lob bytes copied into an arena. The
+ *  second holds the GIL only to turn the tape into Python objects, which no longer involves ion-c at all.
+ */
+
+typedef struct {
+    Py_ssize_t offset; // into the tape's arena
+    Py_ssize_t length; // -1 for text that is unknown, e.g. a symbol with an undefined SID
+} _ION_TAPE_TEXT;
+
+typedef struct {
+    int ion_type; // ION_TYPE_INT of the value's type; for a typed null, the type of the null
+    BOOL is_null;
+    int big_int_sign; // 1 or -1 for an int that did not fit int64_t, recorded as the big-endian bytes of its magnitude
+    _ION_TAPE_TEXT field_name;
+    Py_ssize_t annotations; // index of the first annotation in the tape's annotations
+    SIZE annotation_count;
+    union {
+        BOOL bool_value;
+        int64_t int_value;
+        double double_value;
+        _ION_TAPE_TEXT text; // strings, symbols, big int magnitudes, decimals (as text) and lobs
+        ION_TIMESTAMP timestamp;
+        Py_ssize_t end; // containers: the index of the node that follows the last child
+    } value;
+} _ION_TAPE_NODE;
+
+typedef struct {
+    _ION_TAPE_NODE* nodes;
+    Py_ssize_t node_count;
+    Py_ssize_t node_capacity;
+    _ION_TAPE_TEXT* annotations;
+    Py_ssize_t annotation_count;
+    Py_ssize_t annotation_capacity;
+    char* arena;
+    Py_ssize_t arena_len;
+    Py_ssize_t arena_capacity;
+    ION_STRING* annotation_temp; // reused by each value to fetch its annotations
+    Py_ssize_t annotation_temp_capacity;
+    decContext dec_context; // private to this read; the module's context must not be touched without the GIL
+} _ION_TAPE;
+
+/*
+ *  Makes room for 'needed' more elements in one of the tape's arrays. Only uses the raw allocator, which does not
+ *  require the GIL.
+ */
+static iERR ionc_tape_reserve(void** buffer, Py_ssize_t* capacity, Py_ssize_t used, Py_ssize_t needed,
+                              size_t element_size) {
+    iENTER;
+    if (used + needed > *capacity) {
+        Py_ssize_t new_capacity = *capacity ? *capacity * 2 : 64;
+        while (new_capacity < used + needed) new_capacity *= 2;
+        void* grown = PyMem_RawRealloc(*buffer, new_capacity * element_size);
+        if (grown == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        *buffer = grown;
+        *capacity = new_capacity;
+    }
+    iRETURN;
+}
+
+static iERR ionc_tape_add_text(_ION_TAPE* tape, ION_STRING* string_value, _ION_TAPE_TEXT* text_out) {
+    iENTER;
+    if (!string_value->value) {
+        text_out->offset = 0;
+        text_out->length = -1;
+        SUCCEED();
+    }
+    IONCHECK(ionc_tape_reserve((void**)&tape->arena, &tape->arena_capacity, tape->arena_len, string_value->length,
+                               sizeof(char)));
+    memcpy(tape->arena + tape->arena_len, string_value->value, string_value->length);
+    text_out->offset = tape->arena_len;
+    text_out->length = string_value->length;
+    tape->arena_len += string_value->length;
+    iRETURN;
+}
+
+static void ionc_tape_text_to_ion_string(_ION_TAPE* tape, _ION_TAPE_TEXT* text, ION_STRING* string_out) {
+    ION_STRING_INIT(string_out);
+    if (text->length >= 0) {
+        ion_string_assign_cstr(string_out, tape->arena + text->offset, (SIZE)text->length);
+    }
+}
+
+static void ionc_tape_free(_ION_TAPE* tape) {
+    PyMem_RawFree(tape->nodes);
+    PyMem_RawFree(tape->annotations);
+    PyMem_RawFree(tape->arena);
+    PyMem_RawFree(tape->annotation_temp);
+}
+
+static iERR ionc_tape_read_all(hREADER hreader, _ION_TAPE* tape, BOOL in_struct);
+
+/*
+ *  Records the reader's current value on the tape. Runs without the GIL, so it must not touch any Python object.
+ */
+static iERR ionc_tape_read_value(hREADER hreader, ION_TYPE t, _ION_TAPE* tape, BOOL in_struct) {
+    iENTER;
+    ION_STRING string_value;
+    ION_STRING* annotations = NULL;
+    SIZE annotation_count;
+    BOOL is_null;
+
+    IONCHECK(ionc_tape_reserve((void**)&tape->nodes, &tape->node_capacity, tape->node_count, 1,
+                               sizeof(_ION_TAPE_NODE)));
+    // Nodes are addressed by index as the array may move while children are recorded.
+    Py_ssize_t index = tape->node_count++;
+#define NODE (&tape->nodes[index])
+    memset(NODE, 0, sizeof(_ION_TAPE_NODE));
+    NODE->field_name.length = -1;
+
+    if (in_struct) {
+        IONCHECK(ion_reader_get_field_name(hreader, &string_value));
+        IONCHECK(ionc_tape_add_text(tape, &string_value, &NODE->field_name));
+    }
+
+    IONCHECK(ion_reader_get_annotation_count(hreader, &annotation_count));
+    if (annotation_count > 0) {
+        IONCHECK(ionc_tape_reserve((void**)&tape->annotation_temp, &tape->annotation_temp_capacity, 0,
+                                   annotation_count, sizeof(ION_STRING)));
+        annotations = tape->annotation_temp;
+        IONCHECK(ion_reader_get_annotations(hreader, annotations, annotation_count, &annotation_count));
+        IONCHECK(ionc_tape_reserve((void**)&tape->annotations, &tape->annotation_capacity, tape->annotation_count,
+                                   annotation_count, sizeof(_ION_TAPE_TEXT)));
+        NODE->annotations = tape->annotation_count;
+        NODE->annotation_count = annotation_count;
+        int i;
+        for (i = 0; i < annotation_count; i++) {
+            IONCHECK(ionc_tape_add_text(tape, &annotations[i], &tape->annotations[tape->annotation_count++]));
+        }
+    }
+
+    NODE->ion_type = ION_TYPE_INT(t);
+    IONCHECK(ion_reader_is_null(hreader, &is_null));
+    if (is_null) {
+        ION_TYPE null_type;
+        // Hack for ion-c issue https://github.com/amazon-ion/ion-c/issues/223
+        if (ION_TYPE_INT(t) != tid_SYMBOL_INT) {
+            IONCHECK(ion_reader_read_null(hreader, &null_type));
+        }
+        else {
+            null_type = tid_SYMBOL;
+        }
+        NODE->is_null = TRUE;
+        NODE->ion_type = ION_TYPE_INT(null_type);
+        SUCCEED();
+    }
+
+    switch (ION_TYPE_INT(t)) {
+        case tid_BOOL_INT:
+            IONCHECK(ion_reader_read_bool(hreader, &NODE->value.bool_value));
+            break;
+        case tid_INT_INT:
+        {
+            err = ion_reader_read_int64(hreader, &NODE->value.int_value);
+            if (err == IERR_NUMERIC_OVERFLOW) {
+                ION_INT ion_int_value;
+                SIZE int_len, int_written;
+                BOOL is_negative;
+                IONCHECK(ion_int_init(&ion_int_value, hreader));
+                IONCHECK(ion_reader_read_ion_int(hreader, &ion_int_value));
+                IONCHECK(ion_int_abs_bytes_length(&ion_int_value, &int_len));
+                IONCHECK(ionc_tape_reserve((void**)&tape->arena, &tape->arena_capacity, tape->arena_len,
+                                           int_len, sizeof(char)));
+                IONCHECK(ion_int_to_abs_bytes(&ion_int_value, 0, (BYTE*)(tape->arena + tape->arena_len), int_len,
+                                              &int_written));
+                IONCHECK(ion_int_is_negative(&ion_int_value, &is_negative));
+                NODE->big_int_sign = is_negative ? -1 : 1;
+                NODE->value.text.offset = tape->arena_len;
+                NODE->value.text.length = int_written;
+                tape->arena_len += int_written;
+            }
+            else {
+                IONCHECK(err);
+            }
+            break;
+        }
+        case tid_FLOAT_INT:
+            IONCHECK(ion_reader_read_double(hreader, &NODE->value.double_value));
+            break;
+        case tid_DECIMAL_INT:
+        {
+            ION_DECIMAL decimal_value;
+            IONCHECK(ion_reader_read_ion_decimal(hreader, &decimal_value));
+            SIZE dec_len = ionc_decimal_py_decstr_len(&decimal_value);
+            err = ionc_tape_reserve((void**)&tape->arena, &tape->arena_capacity, tape->arena_len, dec_len + 1,
+                                    sizeof(char));
+            if (!err) {
+                dec_len = ionc_decimal_to_py_decstr(&decimal_value, tape->arena + tape->arena_len);
+            }
+            ion_decimal_free(&decimal_value);
+            IONCHECK(err);
+            NODE->value.text.offset = tape->arena_len;
+            NODE->value.text.length = dec_len + 1;
+            tape->arena_len += dec_len + 1;
+            break;
+        }
+        case tid_TIMESTAMP_INT:
+            IONCHECK(ion_reader_read_timestamp(hreader, &NODE->value.timestamp));
+            break;
+        case tid_SYMBOL_INT:
+        case tid_STRING_INT:
+            IONCHECK(ion_reader_read_string(hreader, &string_value));
+            IONCHECK(ionc_tape_add_text(tape, &string_value, &NODE->value.text));
+            break;
+        case tid_CLOB_INT:
+        case tid_BLOB_INT:
+        {
+            SIZE length, bytes_read = 0;
+            IONCHECK(ion_reader_get_lob_size(hreader, &length));
+            IONCHECK(ionc_tape_reserve((void**)&tape->arena, &tape->arena_capacity, tape->arena_len, length,
+                                       sizeof(char)));
+            if (length) {
+                IONCHECK(ion_reader_read_lob_bytes(hreader, (BYTE*)(tape->arena + tape->arena_len), length,
+                                                   &bytes_read));
+                if (length != bytes_read) {
+                    FAILWITH(IERR_EOF);
+                }
+            }
+            NODE->value.text.offset = tape->arena_len;
+            NODE->value.text.length = length;
+            tape->arena_len += length;
+            break;
+        }
+        case tid_STRUCT_INT:
+        case tid_SEXP_INT:
+        case tid_LIST_INT:
+            IONCHECK(ion_reader_step_in(hreader));
+            IONCHECK(ionc_tape_read_all(hreader, tape, ION_TYPE_INT(t) == tid_STRUCT_INT));
+            IONCHECK(ion_reader_step_out(hreader));
+            NODE->value.end = tape->node_count;
+            break;
+        case tid_DATAGRAM_INT:
+        default:
+            FAILWITH(IERR_INVALID_STATE);
+    }
+#undef NODE
+
+fail:
+    cRETURN;
+}
+
+static iERR ionc_tape_read_all(hREADER hreader, _ION_TAPE* tape, BOOL in_struct) {
+    iENTER;
+    ION_TYPE t;
+    for (;;) {
+        IONCHECK(ion_reader_next(hreader, &t));
+        if (t == tid_EOF) {
+            break;
+        }
+        IONCHECK(ionc_tape_read_value(hreader, t, tape, in_struct));
+    }
+    iRETURN;
+}
+
+static iERR ionc_tape_build_all(_ION_TAPE* tape, Py_ssize_t* pos, Py_ssize_t end, PyObject* container,
+                                enum ContainerType parent_type, _ION_READ_CONTEXT* context);
+
+/*
+ *  Builds a lazy struct for the tape node at 'index': the IonPy proxy only records the tape and the index, and
+ *  decodes the values when they are accessed.
+ */
+static iERR ionc_tape_new_lazy_container(_ION_READ_CONTEXT* context, PyTypeObject* base_type, PyObject* cls,
+                                         Py_ssize_t index, PyObject* py_ion_type, PyObject* py_annotations,
+                                         PyObject** value_out) {
+    iENTER;
+    _IONC_MODULE_STATE* state = context->state;
+    PyObject* py_index = NULL;
+    PyObject* value = ionc_new_ionpy_value(state, base_type, cls, NULL, py_ion_type, py_annotations);
+    if (value == NULL) {
+        FAILWITH(IERR_INTERNAL_ERROR);
+    }
+    py_index = PyLong_FromSsize_t(index);
+    if (py_index == NULL
+            || PyObject_SetAttr(value, state->tape_str, context->lazy_tape) < 0
+            || PyObject_SetAttr(value, state->tape_index_str, py_index) < 0) {
+        Py_DECREF(value);
+        FAILWITH(IERR_INTERNAL_ERROR);
+    }
+    *value_out = value;
+fail:
+    Py_XDECREF(py_index);
+    cRETURN;
+}
+
+/*
+ *  Builds the Python value for the tape node at *pos, mirroring what ionc_read_value builds from a reader, and adds
+ *  it to the container.
+ */
+static iERR ionc_tape_build_value(_ION_TAPE* tape, Py_ssize_t* pos, PyObject* container,
+                                  enum ContainerType parent_type, _ION_READ_CONTEXT* context) {
+    iENTER;
+    _IONC_MODULE_STATE* state = context->state;
+    _ION_TAPE_NODE* node = &tape->nodes[(*pos)++];
+    uint8_t     value_model = context->value_model;
+    BOOL        wrap_py_value = !(value_model & 1);
+    BOOL        symbol_as_text = value_model & 2;
+    BOOL        use_std_dict   = value_model & 4;
+
+    ION_STRING  string_value;
+    PyObject*   py_annotations = NULL;
+    PyObject*   py_value = NULL;
+    PyObject*   ion_nature_constructor = NULL;
+    PyObject*   ion_nature_cls = NULL;
+    PyTypeObject* ion_nature_base = NULL;
+    PyObject*   py_field_name = NULL;
+    PyObject*   fields = context->fields;
+    int         ion_type = node->ion_type;
+
+    if (parent_type > LIST) {
+        ionc_tape_text_to_ion_string(tape, &node->field_name, &string_value);
+        py_field_name = ion_build_py_symbol_text(context, &string_value);
+        if (fields != NULL) {
+            PyObject* field_projection = py_field_name == Py_None ? NULL : PyDict_GetItem(fields, py_field_name);
+            if (field_projection == NULL) {
+                // Not projected: skip the node, and its children if it is a container.
+                if (!node->is_null && (ion_type == tid_STRUCT_INT || ion_type == tid_LIST_INT
+                                       || ion_type == tid_SEXP_INT)) {
+                    *pos = node->value.end;
+                }
+                SUCCEED();
+            }
+            context->fields = field_projection == Py_None ? NULL : field_projection;
+        }
+    }
+
+    if (node->annotation_count > 0) {
+        wrap_py_value = TRUE;
+        py_annotations = PyTuple_New(node->annotation_count);
+        int i;
+        for (i = 0; i < node->annotation_count; i++) {
+            ionc_tape_text_to_ion_string(tape, &tape->annotations[node->annotations + i], &string_value);
+            PyTuple_SetItem(py_annotations, i, ion_string_to_py_symboltoken_cached(context, &string_value));
+        }
+    }
+
+    if (node->is_null) {
+        py_value = Py_None;
+        Py_INCREF(py_value);
+        wrap_py_value = wrap_py_value || (ion_type != tid_NULL_INT);
+        ion_nature_cls = state->ionpynull_cls;
+        ion_nature_base = &PyBaseObject_Type;
+    }
+    else {
+        switch (ion_type) {
+            case tid_BOOL_INT:
+                py_value = PyBool_FromLong(node->value.bool_value);
+                ion_nature_cls = state->ionpybool_cls;
+                ion_nature_base = &PyLong_Type;
+                break;
+            case tid_INT_INT:
+                if (node->big_int_sign) {
+                    py_value = ionc_int_from_abs_bytes((BYTE*)(tape->arena + node->value.text.offset),
+                                                       (SIZE)node->value.text.length, node->big_int_sign < 0);
+                }
+                else {
+                    py_value = PyLong_FromLongLong(node->value.int_value);
+                }
+                ion_nature_cls = state->ionpyint_cls;
+                ion_nature_base = &PyLong_Type;
+                break;
+            case tid_FLOAT_INT:
+                py_value = PyFloat_FromDouble(node->value.double_value);
+                ion_nature_cls = state->ionpyfloat_cls;
+                ion_nature_base = &PyFloat_Type;
+                break;
+            case tid_DECIMAL_INT:
+            {
+                char* dec_str = tape->arena + node->value.text.offset;
+                Py_ssize_t dec_len = node->value.text.length - 1;
+                IONC_STAT_TIMER_START(state, started);
+                if (wrap_py_value) {
+                    py_value = PyUnicode_FromStringAndSize(dec_str, dec_len);
+                } else {
+                    py_value = PyObject_CallFunction(state->decimal_constructor, "s#", dec_str, dec_len, NULL);
+                }
+                IONC_STAT_TIMER_STOP(state, decimal_nanos, started);
+                ion_nature_cls = state->ionpydecimal_cls;
+                ion_nature_base = (PyTypeObject*)state->decimal_constructor;
+                break;
+            }
+            case tid_TIMESTAMP_INT:
+                IONCHECK(ionc_timestamp_to_py(state, &node->value.timestamp, &tape->dec_context, &py_value));
+                ion_nature_constructor = state->ionpytimestamp_fromvalue;
+                break;
+            case tid_SYMBOL_INT:
+                ionc_tape_text_to_ion_string(tape, &node->value.text, &string_value);
+                if (!symbol_as_text) {
+                    py_value = ion_string_to_py_symboltoken_cached(context, &string_value);
+                    ion_nature_cls = state->ionpysymbol_cls;
+                    ion_nature_base = &PyTuple_Type;
+                } else if (ion_string_is_null(&string_value)) {
+                    _FAILWITHMSG(IERR_INVALID_STATE, "Cannot emit symbol with undefined text when SYMBOL_AS_TEXT is set.");
+                } else {
+                    py_value = ion_build_py_symbol_text(context, &string_value);
+                    ion_nature_cls = state->ionpytext_cls;
+                    ion_nature_base = &PyUnicode_Type;
+                }
+                break;
+            case tid_STRING_INT:
+                py_value = PyUnicode_FromStringAndSize(tape->arena + node->value.text.offset, node->value.text.length);
+                ion_nature_cls = state->ionpytext_cls;
+                ion_nature_base = &PyUnicode_Type;
+                break;
+            case tid_CLOB_INT:
+                // Clob values must always be emitted as IonPyBytes, to avoid ambiguity with blob.
+                wrap_py_value = TRUE;
+                // intentional fall-through
+            case tid_BLOB_INT:
+                py_value = PyBytes_FromStringAndSize(tape->arena + node->value.text.offset, node->value.text.length);
+                ion_nature_cls = state->ionpybytes_cls;
+                ion_nature_base = &PyBytes_Type;
+                break;
+            case tid_STRUCT_INT:
+            {
+                enum ContainerType container_type = use_std_dict ? STD_DICT : MULTIMAP;
+                if (context->lazy_tape != NULL && !use_std_dict) {
+                    IONCHECK(ionc_tape_new_lazy_container(context, &PyBaseObject_Type, state->ionpylazydict_cls,
+                                                          *pos - 1, NULL, py_annotations, &py_value));
+                    *pos = node->value.end;
+                    wrap_py_value = FALSE;
+                    break;
+                }
+                if (use_std_dict && wrap_py_value) {
+                    py_value = ionc_new_ionpy_value(state, &PyDict_Type, state->ionpystddict_cls, NULL, NULL,
+                                                    py_annotations);
+                    wrap_py_value = FALSE;
+                }
+                else {
+                    py_value = PyDict_New();
+                }
+                if (py_value == NULL) {
+                    FAILWITH(IERR_INTERNAL_ERROR);
+                }
+                IONCHECK(Py_EnterRecursiveCall(" while reading an Ion container"));
+                err = ionc_tape_build_all(tape, pos, node->value.end, py_value, container_type, context);
+                Py_LeaveRecursiveCall();
+                IONCHECK(err);
+                if (container_type == MULTIMAP) {
+                    // there is no non-IonPy multimap so we always wrap, handing the store over as IonPyDict._factory does
+                    PyObject* store = py_value;
+                    py_value = ionc_new_ionpy_value(state, &PyBaseObject_Type, state->ionpydict_cls, NULL, NULL,
+                                                    py_annotations);
+                    if (py_value != NULL && PyObject_SetAttr(py_value, state->store_str, store) < 0) {
+                        Py_CLEAR(py_value);
+                    }
+                    Py_DECREF(store);
+                    if (py_value == NULL) {
+                        FAILWITH(IERR_INTERNAL_ERROR);
+                    }
+                    wrap_py_value = FALSE;
+                }
+                break;
+            }
+            case tid_SEXP_INT:
+                // Sexp values must always be emitted as IonPyList to avoid ambiguity with list.
+                wrap_py_value = TRUE;
+                // intentional fall-through
+            case tid_LIST_INT:
+                // A lazy sequence is filled right away, so the list really holds its items wherever it is used;
+                // only the structs in it stay lazy.
+                if (wrap_py_value || context->lazy_tape != NULL) {
+                    py_value = ionc_new_ionpy_value(state, &PyList_Type, context->lazy_tape != NULL
+                                                    ? state->ionpylazylist_cls : state->ionpylist_cls, NULL,
+                                                    state->py_ion_type_table[ion_type >> 8], py_annotations);
+                    wrap_py_value = FALSE;
+                } else {
+                    py_value = PyList_New(0);
+                }
+                if (py_value == NULL) {
+                    FAILWITH(IERR_INTERNAL_ERROR);
+                }
+                IONCHECK(Py_EnterRecursiveCall(" while reading an Ion container"));
+                err = ionc_tape_build_all(tape, pos, node->value.end, py_value, LIST, context);
+                Py_LeaveRecursiveCall();
+                IONCHECK(err);
+                break;
+            default:
+                FAILWITH(IERR_INVALID_STATE);
+        }
+    }
+    if (py_value == NULL) {
+        FAILWITH(IERR_INTERNAL_ERROR);
+    }
+
+    IONC_STAT_VALUE(state, ion_type);
+    PyObject* final_py_value = py_value;
+    if (wrap_py_value) {
+        IONC_STAT_ADD(state, wrappers, 1);
+        if (ion_nature_base != NULL) {
+            final_py_value = ionc_new_ionpy_value(
+                state,
+                ion_nature_base,
+                ion_nature_cls,
+                ion_nature_base == &PyBaseObject_Type ? NULL : py_value,
+                state->py_ion_type_table[ion_type >> 8],
+                py_annotations
+            );
+        }
+        else {
+            final_py_value = PyObject_CallFunctionObjArgs(
+                ion_nature_constructor,
+                state->py_ion_type_table[ion_type >> 8],
+                py_value,
+                py_annotations,
+                NULL
+            );
+        }
+        Py_CLEAR(py_value);
+        if (final_py_value == NULL) {
+            FAILWITH(IERR_INTERNAL_ERROR);
+        }
+    }
+
+    ionc_add_to_container(container, final_py_value, parent_type, py_field_name);
+
+fail:
+    context->fields = fields;
+    Py_XDECREF(py_annotations);
+    if (py_field_name && py_field_name != Py_None) Py_DECREF(py_field_name);
+    if (err) {
+        Py_XDECREF(py_value);
+    }
+    cRETURN;
+}
+
+static iERR ionc_tape_build_all(_ION_TAPE* tape, Py_ssize_t* pos, Py_ssize_t end, PyObject* container,
+                                enum ContainerType parent_type, _ION_READ_CONTEXT* context) {
+    iENTER;
+    while (*pos < end) {
+        IONCHECK(ionc_tape_build_value(tape, pos, container, parent_type, context));
+    }
+    iRETURN;
+}
+
+/*
+ *  The tape of a buffer read with IonPyValueModel.LAZY. It outlives the read, shared by the IonPyLazyDict proxies
+ *  built from it, which ask it for their values by node index when they are accessed.
+ */
+typedef struct {
+    PyObject_HEAD
+    _ION_TAPE tape;
+    _ION_READ_CONTEXT context;
+    _IONC_MUTEX mutex; // held by fields and build, as the proxies of a load may be used by several threads
+} ionc_LazyTape;
+
+static PyObject* ionc_lazy_tape_error(_IONC_MODULE_STATE* state, iERR err) {
+    PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+    _err_msg[0] = '\0';
+    return exception;
+}
+
+/*
+ *  Checks that 'index' is a non-null struct node of the tape.
+ */
+static _ION_TAPE_NODE* ionc_lazy_tape_struct(ionc_LazyTape* self, Py_ssize_t index) {
+    _ION_TAPE_NODE* node;
+    if (index < 0 || index >= self->tape.node_count) {
+        PyErr_SetString(PyExc_IndexError, "Tape index out of range.");
+        return NULL;
+    }
+    node = &self->tape.nodes[index];
+    if (node->is_null || node->ion_type != tid_STRUCT_INT) {
+        PyErr_SetString(PyExc_ValueError, "Tape index is not a struct.");
+        return NULL;
+    }
+    return node;
+}
+
+/*
+ *  Returns a dict of each field name of the struct at the given index to the list of the node indexes of its values,
+ *  in document order. Only the field names are built.
+ */
+static PyObject* _ionc_lazy_tape_fields(ionc_LazyTape* self, PyObject* arg) {
+    Py_ssize_t index = PyLong_AsSsize_t(arg), i;
+    ION_STRING field_name;
+    PyObject *fields = NULL, *py_field_name = NULL, *indexes, *py_index = NULL;
+    if (index == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    _ION_TAPE_NODE* node = ionc_lazy_tape_struct(self, index);
+    if (node == NULL) {
+        return NULL;
+    }
+    fields = PyDict_New();
+    if (fields == NULL) {
+        return NULL;
+    }
+    for (i = index + 1; i < node->value.end; ) {
+        _ION_TAPE_NODE* child = &self->tape.nodes[i];
+        ionc_tape_text_to_ion_string(&self->tape, &child->field_name, &field_name);
+        py_field_name = ion_build_py_symbol_text(&self->context, &field_name);
+        if (py_field_name == Py_None) {
+            Py_INCREF(py_field_name);
+        }
+        py_index = PyLong_FromSsize_t(i);
+        if (py_field_name == NULL || py_index == NULL) {
+            goto fail;
+        }
+        indexes = PyDict_GetItemWithError(fields, py_field_name); // Borrowed reference
+        if (indexes == NULL) {
+            if (PyErr_Occurred()) {
+                goto fail;
+            }
+            indexes = PyList_New(0);
+            if (indexes == NULL || PyDict_SetItem(fields, py_field_name, indexes) < 0) {
+                Py_XDECREF(indexes);
+                goto fail;
+            }
+            Py_DECREF(indexes);
+        }
+        if (PyList_Append(indexes, py_index) < 0) {
+            goto fail;
+        }
+        Py_CLEAR(py_field_name);
+        Py_CLEAR(py_index);
+        BOOL is_container = !child->is_null && (child->ion_type == tid_STRUCT_INT || child->ion_type == tid_LIST_INT
+                                                || child->ion_type == tid_SEXP_INT);
+        i = is_container ? child->value.end : i + 1;
+    }
+    return fields;
+
+fail:
+    Py_XDECREF(py_field_name);
+    Py_XDECREF(py_index);
+    Py_DECREF(fields);
+    return NULL;
+}
+
+static PyObject* ionc_lazy_tape_fields(ionc_LazyTape* self, PyObject* arg) {
+    PyObject* result;
+    IONC_LOCK(self->mutex);
+    result = _ionc_lazy_tape_fields(self, arg);
+    IONC_UNLOCK(self->mutex);
+    return result;
+}
+
+/*
+ *  Builds the value at the given index, as it would be if read eagerly except that its containers are lazy.
+ */
+static PyObject* _ionc_lazy_tape_build(ionc_LazyTape* self, PyObject* arg) {
+    iENTER;
+    Py_ssize_t index = PyLong_AsSsize_t(arg);
+    PyObject *values = NULL, *value = NULL;
+    if (index == -1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    if (index < 0 || index >= self->tape.node_count) {
+        PyErr_SetString(PyExc_IndexError, "Tape index out of range.");
+        return NULL;
+    }
+    values = PyList_New(0);
+    if (values == NULL) {
+        return NULL;
+    }
+    IONCHECK(ionc_tape_build_value(&self->tape, &index, values, LIST, &self->context));
+    value = PyList_GET_ITEM(values, 0);
+    Py_INCREF(value);
+fail:
+    Py_DECREF(values);
+    if (err) {
+        return ionc_lazy_tape_error(self->context.state, err);
+    }
+    return value;
+}
+
+static PyObject* ionc_lazy_tape_build(ionc_LazyTape* self, PyObject* arg) {
+    PyObject* result;
+    IONC_LOCK(self->mutex);
+    result = _ionc_lazy_tape_build(self, arg);
+    IONC_UNLOCK(self->mutex);
+    return result;
+}
+
+static void ionc_lazy_tape_dealloc(PyObject* self) {
+    ionc_LazyTape* lazy_tape = (ionc_LazyTape*)self;
+    ionc_symbol_cache_clear(&lazy_tape->context);
+    ionc_tape_free(&lazy_tape->tape);
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyMethodDef ionc_lazy_tape_methods[] = {
+    {"fields", (PyCFunction)ionc_lazy_tape_fields, METH_O, "Maps each field name of a struct to its value indexes."},
+    {"build", (PyCFunction)ionc_lazy_tape_build, METH_O, "Builds the value at an index."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyType_Slot ionc_lazy_tape_slots[] = {
+    {Py_tp_doc, "Parsed values that lazy containers decode from on access."},
+    {Py_tp_dealloc, ionc_lazy_tape_dealloc},
+    {Py_tp_methods, ionc_lazy_tape_methods},
+    {0, NULL}
+};
+
+static PyType_Spec ionc_lazy_tape_spec = {
+    .name = "ionc.LazyTape",
+    .basicsize = sizeof(ionc_LazyTape),
+    .flags = IONC_TPFLAGS_INTERNAL,
+    .slots = ionc_lazy_tape_slots
+};
+
+/*
+ *  Reads every value of an in-memory buffer and returns them as a list. The buffer is parsed with the GIL released,
+ *  so independent buffers can be read in parallel by several threads.
+ */
+PyObject* ionc_read_buffer(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    uint8_t value_model = 0;
+    PyObject *text_buffer_size_limit = Py_None, *py_catalog = Py_None, *catalog = NULL, *values = NULL;
+    PyObject *py_fields = Py_None;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    ION_READER_OPTIONS options;
+    _ION_TAPE tape;
+    _ION_READ_CONTEXT* context = NULL;
+    ionc_LazyTape* lazy_tape = NULL;
+    Py_ssize_t pos = 0;
+    static char *kwlist[] = {"data", "value_model", "text_buffer_size_limit", "catalog", "fields", NULL};
+
+    buffer.obj = NULL;
+    memset(&tape, 0, sizeof(tape));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|bOOO", kwlist, &buffer, &value_model,
+                                     &text_buffer_size_limit, &py_catalog, &py_fields)) {
+        return NULL;
+    }
+    if (py_fields != Py_None && !PyDict_Check(py_fields)) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "fields must be a dict or None.");
+    }
+    if (py_fields != Py_None && (value_model & 8)) {
+        // The lazy containers decode after the read returns, when the projection is no longer known.
+        _FAILWITHMSG(IERR_INVALID_ARG, "fields can't be combined with IonPyValueModel.LAZY.");
+    }
+
+    memset(&options, 0, sizeof(options));
+    tape.dec_context = state->dec_context;
+    options.decimal_context = &tape.dec_context;
+    if (text_buffer_size_limit != Py_None) {
+        options.symbol_threshold = PyLong_AsLong(text_buffer_size_limit);
+    }
+    if (py_catalog != Py_None) {
+        IONCHECK(ionc_catalog_from_py(state, py_catalog, &catalog));
+        options.pcatalog = (hCATALOG) PyCapsule_GetPointer(catalog, IONC_CATALOG_CAPSULE_NAME);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = ionc_reader_open_pinned(state, &reader, &buffer, &pinned_stream, &options);
+    if (!err) {
+        err = ionc_tape_read_all(reader, &tape, FALSE);
+    }
+    if (reader != NULL) {
+        iERR close_err = ion_reader_close(reader);
+        if (!err) err = close_err;
+        reader = NULL;
+    }
+    Py_END_ALLOW_THREADS
+    IONCHECK(err);
+
+    values = PyList_New(0);
+    if (values == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    if (value_model & 8) {
+        // IonPyValueModel.LAZY: the tape is handed over to an object the lazy containers keep alive.
+        lazy_tape = PyObject_New(ionc_LazyTape, (PyTypeObject*)state->lazy_tape_type);
+        if (lazy_tape == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        lazy_tape->tape = tape;
+        memset(&tape, 0, sizeof(tape));
+        memset(&lazy_tape->mutex, 0, sizeof(lazy_tape->mutex));
+        memset(&lazy_tape->context, 0, sizeof(_ION_READ_CONTEXT));
+        lazy_tape->context.state = state;
+        lazy_tape->context.value_model = value_model;
+        lazy_tape->context.lazy_tape = (PyObject*)lazy_tape;
+        IONCHECK(ionc_tape_build_all(&lazy_tape->tape, &pos, lazy_tape->tape.node_count, values, LIST,
+                                     &lazy_tape->context));
+        SUCCEED();
+    }
+    context = (_ION_READ_CONTEXT*)PyMem_Calloc(1, sizeof(_ION_READ_CONTEXT));
+    if (context == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    context->state = state;
+    context->value_model = value_model;
+    context->fields = py_fields == Py_None ? NULL : py_fields;
+    IONCHECK(ionc_tape_build_all(&tape, &pos, tape.node_count, values, LIST, context));
+
+fail:
+    if (context != NULL) {
+        ionc_symbol_cache_clear(context);
+        PyMem_Free(context);
+    }
+    Py_XDECREF(lazy_tape);
+    ionc_tape_free(&tape);
+    Py_XDECREF(catalog);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    if (err) {
+        Py_XDECREF(values);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    return values;
+}
+
+/******************************************************************************
+*       Binary stream splitting                                              *
+******************************************************************************/
+
+#define IONC_BINARY_IVM_LEN 4
+#define IONC_SID_ION_SYMBOL_TABLE 3
+
+static const BYTE IONC_BINARY_IVM[IONC_BINARY_IVM_LEN] = {0xE0, 0x01, 0x00, 0xEA};
+
+typedef struct {
+    Py_ssize_t start;
+    Py_ssize_t end;
+} _IONC_SPAN;
+
+typedef struct {
+    _IONC_SPAN body; // the top-level values of the shard
+    Py_ssize_t context_start; // the local symbol tables in effect where the shard starts, as a range of indexes
+    Py_ssize_t context_end;   // into the list of local symbol table spans
+} _IONC_SHARD;
+
+/*
+ *  Reads a binary Ion VarUInt. Returns FALSE if it does not end before 'limit' or does not fit a Py_ssize_t.
+ */
+static BOOL ionc_read_var_uint(const BYTE* data, Py_ssize_t limit, Py_ssize_t* pos, Py_ssize_t* value_out) {
+    Py_ssize_t value = 0;
+    int i;
+    for (i = 0; *pos < limit && i < 8; i++) {
+        BYTE b = data[(*pos)++];
+        value = (value << 7) | (b & 0x7F);
+        if (b & 0x80) {
+            *value_out = value;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ *  Finds the extent of the binary top-level value at 'pos' from its type descriptor alone, and whether it is a local
+ *  symbol table, i.e. a struct whose first annotation is $ion_symbol_table.
+ */
+static iERR ionc_scan_binary_value(const BYTE* data, Py_ssize_t len, Py_ssize_t pos, Py_ssize_t* end_out,
+                                   BOOL* is_symbol_table_out) {
+    iENTER;
+    BYTE td = data[pos++];
+    int type = td >> 4, length_nibble = td & 0x0F;
+    Py_ssize_t length = 0;
+
+    *is_symbol_table_out = FALSE;
+    if (type == 1 || length_nibble == 15) {
+        length = 0; // bools keep their value in the length nibble; 15 is a typed null
+    }
+    else if (length_nibble == 14 || (type == 13 && length_nibble == 1)) {
+        if (!ionc_read_var_uint(data, len, &pos, &length)) {
+            FAILWITH(pos == len ? IERR_UNEXPECTED_EOF : IERR_INVALID_BINARY);
+        }
+    }
+    else {
+        length = length_nibble;
+    }
+    if (length > len - pos) {
+        FAILWITH(IERR_UNEXPECTED_EOF);
+    }
+    *end_out = pos + length;
+
+    if (type == 14 && length > 0) {
+        Py_ssize_t annotations_length, first_annotation, cursor = pos;
+        if (ionc_read_var_uint(data, *end_out, &cursor, &annotations_length)
+                && ionc_read_var_uint(data, *end_out, &cursor, &first_annotation)
+                && first_annotation == IONC_SID_ION_SYMBOL_TABLE) {
+            cursor = pos;
+            ionc_read_var_uint(data, *end_out, &cursor, &annotations_length);
+            cursor += annotations_length;
+            *is_symbol_table_out = cursor < *end_out && (data[cursor] >> 4) == 13;
+        }
+    }
+    iRETURN;
+}
+
+/*
+ *  Splits a binary Ion stream into at most 'shard_count' streams of about the same size, cut at top-level value
+ *  boundaries. The cut points are found from the type descriptors alone. Each shard after the first is prefixed with
+ *  an IVM and every local symbol table in effect where it starts, so it can be read on its own.
+ *
+ *  Args:
+ *      data:  A bytes-like object holding binary Ion, starting with an IVM
+ *      shard_count:  The maximum number of shards
+ *
+ *  Returns:
+ *      A list of bytes objects
+ */
+PyObject* ionc_split_binary(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    Py_ssize_t shard_count;
+    _IONC_SPAN* symbol_tables = NULL;
+    Py_ssize_t symbol_table_count = 0, symbol_table_capacity = 0;
+    _IONC_SHARD* shards = NULL;
+    Py_ssize_t shards_used = 0, i, j;
+    PyObject* py_shards = NULL;
+    static char *kwlist[] = {"data", "shard_count", NULL};
+
+    buffer.obj = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*n", kwlist, &buffer, &shard_count)) {
+        return NULL;
+    }
+    const BYTE* data = (const BYTE*)buffer.buf;
+    Py_ssize_t len = buffer.len;
+    if (shard_count < 1) shard_count = 1;
+    if (len < IONC_BINARY_IVM_LEN || memcmp(data, IONC_BINARY_IVM, IONC_BINARY_IVM_LEN) != 0) {
+        _FAILWITHMSG(IERR_INVALID_BINARY, "Expected binary Ion starting with an IVM.");
+    }
+    shards = (_IONC_SHARD*)PyMem_RawMalloc(shard_count * sizeof(_IONC_SHARD));
+    if (shards == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    Py_ssize_t target = len / shard_count + 1;
+    Py_ssize_t pos = 0, context_start = 0;
+    shards[0].body.start = 0;
+    shards[0].context_start = shards[0].context_end = 0;
+    shards_used = 1;
+    while (!err && pos < len) {
+        if (len - pos >= IONC_BINARY_IVM_LEN && memcmp(data + pos, IONC_BINARY_IVM, IONC_BINARY_IVM_LEN) == 0) {
+            // An IVM resets the symbol table context.
+            context_start = symbol_table_count;
+            pos += IONC_BINARY_IVM_LEN;
+            continue;
+        }
+        Py_ssize_t end;
+        BOOL is_symbol_table;
+        err = ionc_scan_binary_value(data, len, pos, &end, &is_symbol_table);
+        if (err) break;
+        if (is_symbol_table) {
+            err = ionc_tape_reserve((void**)&symbol_tables, &symbol_table_capacity, symbol_table_count, 1,
+                                    sizeof(_IONC_SPAN));
+            if (err) break;
+            symbol_tables[symbol_table_count].start = pos;
+            symbol_tables[symbol_table_count].end = end;
+            symbol_table_count++;
+        }
+        else if (shards_used < shard_count && pos - shards[shards_used - 1].body.start >= target) {
+            shards[shards_used - 1].body.end = pos;
+            shards[shards_used].body.start = pos;
+            shards[shards_used].context_start = context_start;
+            shards[shards_used].context_end = symbol_table_count;
+            shards_used++;
+        }
+        pos = end;
+    }
+    shards[shards_used - 1].body.end = len;
+    Py_END_ALLOW_THREADS
+    IONCHECK(err);
+
+    py_shards = PyList_New(shards_used);
+    if (py_shards == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    for (i = 0; i < shards_used; i++) {
+        _IONC_SHARD* shard = &shards[i];
+        Py_ssize_t shard_len = shard->body.end - shard->body.start;
+        if (i > 0) {
+            shard_len += IONC_BINARY_IVM_LEN;
+            for (j = shard->context_start; j < shard->context_end; j++) {
+                shard_len += symbol_tables[j].end - symbol_tables[j].start;
+            }
+        }
+        PyObject* py_shard = PyBytes_FromStringAndSize(NULL, shard_len);
+        if (py_shard == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        char* dst = PyBytes_AS_STRING(py_shard);
+        if (i > 0) {
+            memcpy(dst, IONC_BINARY_IVM, IONC_BINARY_IVM_LEN);
+            dst += IONC_BINARY_IVM_LEN;
+            for (j = shard->context_start; j < shard->context_end; j++) {
+                memcpy(dst, data + symbol_tables[j].start, symbol_tables[j].end - symbol_tables[j].start);
+                dst += symbol_tables[j].end - symbol_tables[j].start;
+            }
+        }
+        memcpy(dst, data + shard->body.start, shard->body.end - shard->body.start);
+        PyList_SET_ITEM(py_shards, i, py_shard);
+    }
+
+fail:
+    PyMem_RawFree(symbol_tables);
+    PyMem_RawFree(shards);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    if (err) {
+        Py_XDECREF(py_shards);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    return py_shards;
+}
+
+/*
+ *  Finds how much of the start of a binary Ion stream, given in pieces, is whole top-level values, from the type
+ *  descriptors alone.
+ *
+ *  Args:
+ *      data:  A bytes-like object holding the unread part of a binary Ion stream
+ *
+ *  Returns:
+ *      A tuple (end, reset, symbol_tables): data[:end] holds whole top-level values; reset is whether it holds an IVM;
+ *      and symbol_tables lists the (start, end) spans of its local symbol tables after its last IVM
+ */
+PyObject* ionc_scan_binary(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    _IONC_SPAN* symbol_tables = NULL;
+    Py_ssize_t symbol_table_count = 0, symbol_table_capacity = 0, pos = 0, i;
+    BOOL reset = FALSE;
+    PyObject *py_symbol_tables = NULL, *result = NULL;
+    static char *kwlist[] = {"data", NULL};
+
+    buffer.obj = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*", kwlist, &buffer)) {
+        return NULL;
+    }
+    const BYTE* data = (const BYTE*)buffer.buf;
+    Py_ssize_t len = buffer.len;
+    while (pos < len) {
+        if (data[pos] == IONC_BINARY_IVM[0] && len - pos < IONC_BINARY_IVM_LEN) {
+            break; // maybe the start of an IVM
+        }
+        if (len - pos >= IONC_BINARY_IVM_LEN && memcmp(data + pos, IONC_BINARY_IVM, IONC_BINARY_IVM_LEN) == 0) {
+            reset = TRUE;
+            symbol_table_count = 0;
+            pos += IONC_BINARY_IVM_LEN;
+            continue;
+        }
+        Py_ssize_t end;
+        BOOL is_symbol_table;
+        err = ionc_scan_binary_value(data, len, pos, &end, &is_symbol_table);
+        if (err == IERR_UNEXPECTED_EOF) {
+            err = IERR_OK;
+            break;
+        }
+        IONCHECK(err);
+        if (is_symbol_table) {
+            IONCHECK(ionc_tape_reserve((void**)&symbol_tables, &symbol_table_capacity, symbol_table_count, 1,
+                                       sizeof(_IONC_SPAN)));
+            symbol_tables[symbol_table_count].start = pos;
+            symbol_tables[symbol_table_count].end = end;
+            symbol_table_count++;
+        }
+        pos = end;
+    }
+
+    py_symbol_tables = PyList_New(symbol_table_count);
+    if (py_symbol_tables == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    for (i = 0; i < symbol_table_count; i++) {
+        PyObject* span = Py_BuildValue("(nn)", symbol_tables[i].start, symbol_tables[i].end);
+        if (span == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        PyList_SET_ITEM(py_symbol_tables, i, span);
+    }
+    result = Py_BuildValue("(nOO)", pos, reset ? Py_True : Py_False, py_symbol_tables);
+    if (result == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+
+fail:
+    PyMem_RawFree(symbol_tables);
+    Py_XDECREF(py_symbol_tables);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    if (err) {
+        Py_XDECREF(result);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    return result;
+}
+
+/******************************************************************************
+*       Columnar export                                                       *
+******************************************************************************/
+
+#define IONC_COLUMN_INT64 0
+#define IONC_COLUMN_FLOAT64 1
+#define IONC_COLUMN_BOOL 2
+#define IONC_COLUMN_STRING 3
+#define IONC_COLUMN_TYPE_COUNT 4
+
+static const char* IONC_COLUMN_TYPE_NAMES[IONC_COLUMN_TYPE_COUNT] = {"int64", "float64", "bool", "string"};
+// The buffer format and item size of each column type's values; string columns hold UTF-8 bytes.
+static char* IONC_COLUMN_FORMATS[IONC_COLUMN_TYPE_COUNT] = {"q", "d", "B", "B"};
+static const Py_ssize_t IONC_COLUMN_ITEM_SIZES[IONC_COLUMN_TYPE_COUNT] = {8, 8, 1, 1};
+
+typedef struct {
+    BYTE* data;
+    Py_ssize_t len;
+    Py_ssize_t capacity;
+} _IONC_BUFFER;
+
+/*
+ *  A column being filled, laid out as an Arrow array: a validity bitmap (least significant bit first), the values
+ *  (zero for nulls) and, for strings, rows + 1 int64 offsets into the UTF-8 values.
+ */
+typedef struct {
+    int type;
+    Py_ssize_t rows;
+    _IONC_BUFFER validity;
+    _IONC_BUFFER values;
+    _IONC_BUFFER offsets;
+} _IONC_COLUMN;
+
+/*
+ *  A field of the schema's path trie. The names borrow the UTF-8 of the schema's str objects.
+ */
+typedef struct {
+    Py_ssize_t parent;  // the index of the struct field holding this one, or -1 for fields of the top-level structs
+    ION_STRING name;
+    Py_ssize_t column;  // the column read from this field, or -1 if it is a struct holding deeper fields
+} _IONC_PATH_NODE;
+
+typedef struct {
+    _IONC_PATH_NODE* nodes;
+    Py_ssize_t node_count;
+    _IONC_COLUMN* columns;
+    Py_ssize_t column_count;
+    Py_ssize_t rows;
+} _IONC_COLUMN_SCAN;
+
+static iERR ionc_buffer_append(_IONC_BUFFER* buffer, const void* data, Py_ssize_t len) {
+    iENTER;
+    if (len == 0) SUCCEED();
+    IONCHECK(ionc_tape_reserve((void**)&buffer->data, &buffer->capacity, buffer->len, len, sizeof(BYTE)));
+    memcpy(buffer->data + buffer->len, data, len);
+    buffer->len += len;
+    iRETURN;
+}
+
+/*
+ *  Appends the next row of a column; a NULL value appends a null.
+ */
+static iERR ionc_column_push(_IONC_COLUMN* column, const void* value, Py_ssize_t value_len) {
+    iENTER;
+    static const BYTE zeros[8] = {0};
+    if (column->rows % 8 == 0) {
+        IONCHECK(ionc_buffer_append(&column->validity, zeros, 1));
+    }
+    if (value) {
+        column->validity.data[column->rows / 8] |= (BYTE)(1 << (column->rows % 8));
+    }
+    if (column->type == IONC_COLUMN_STRING) {
+        if (value) {
+            IONCHECK(ionc_buffer_append(&column->values, value, value_len));
+        }
+        int64_t offset = column->values.len;
+        IONCHECK(ionc_buffer_append(&column->offsets, &offset, sizeof(offset)));
+    }
+    else {
+        IONCHECK(ionc_buffer_append(&column->values, value ? value : zeros, IONC_COLUMN_ITEM_SIZES[column->type]));
+    }
+    column->rows++;
+    iRETURN;
+}
+
+/*
+ *  Reads the reader's current value into the next row of a column.
+ */
+static iERR ionc_column_read(hREADER reader, ION_TYPE t, _IONC_COLUMN* column, Py_ssize_t column_index) {
+    iENTER;
+    BOOL is_null;
+    int ion_type = ION_TYPE_INT(t);
+    IONCHECK(ion_reader_is_null(reader, &is_null));
+    if (is_null) {
+        IONCHECK(ionc_column_push(column, NULL, 0));
+        SUCCEED();
+    }
+    switch (column->type) {
+        case IONC_COLUMN_INT64:
+            if (ion_type == tid_INT_INT) {
+                int64_t int_value;
+                IONCHECK(ion_reader_read_int64(reader, &int_value));
+                IONCHECK(ionc_column_push(column, &int_value, sizeof(int_value)));
+                SUCCEED();
+            }
+            break;
+        case IONC_COLUMN_FLOAT64:
+            if (ion_type == tid_FLOAT_INT || ion_type == tid_INT_INT) {
+                double double_value;
+                if (ion_type == tid_FLOAT_INT) {
+                    IONCHECK(ion_reader_read_double(reader, &double_value));
+                }
+                else {
+                    int64_t int_value;
+                    IONCHECK(ion_reader_read_int64(reader, &int_value));
+                    double_value = (double)int_value;
+                }
+                IONCHECK(ionc_column_push(column, &double_value, sizeof(double_value)));
+                SUCCEED();
+            }
+            break;
+        case IONC_COLUMN_BOOL:
+            if (ion_type == tid_BOOL_INT) {
+                BOOL bool_value;
+                IONCHECK(ion_reader_read_bool(reader, &bool_value));
+                BYTE byte_value = bool_value ? 1 : 0;
+                IONCHECK(ionc_column_push(column, &byte_value, sizeof(byte_value)));
+                SUCCEED();
+            }
+            break;
+        case IONC_COLUMN_STRING:
+            if (ion_type == tid_STRING_INT || ion_type == tid_SYMBOL_INT) {
+                ION_STRING string_value;
+                IONCHECK(ion_reader_read_string(reader, &string_value));
+                // A symbol with unknown text is null.
+                IONCHECK(ionc_column_push(column, string_value.value ? (void*)string_value.value : NULL,
+                                          string_value.length));
+                SUCCEED();
+            }
+            break;
+    }
+    snprintf(_err_msg, ERR_MSG_MAX_LEN, "Column %zd expects %s values.", column_index,
+             IONC_COLUMN_TYPE_NAMES[column->type]);
+    FAILWITH(IERR_INVALID_ARG);
+    iRETURN;
+}
+
+static BOOL ionc_string_equals(ION_STRING* a, ION_STRING* b) {
+    return a->value && b->value && a->length == b->length && memcmp(a->value, b->value, a->length) == 0;
+}
+
+/*
+ *  Reads the fields of the struct the reader is positioned on whose paths continue from the path node 'parent'. Of
+ *  repeated fields, the first one fills the column.
+ */
+static iERR ionc_columns_read_struct(hREADER reader, _IONC_COLUMN_SCAN* scan, Py_ssize_t parent) {
+    iENTER;
+    ION_TYPE t;
+    ION_STRING field_name;
+    BOOL is_null;
+    Py_ssize_t i;
+    IONCHECK(ion_reader_step_in(reader));
+    for (;;) {
+        IONCHECK(ion_reader_next(reader, &t));
+        if (t == tid_EOF) break;
+        IONCHECK(ion_reader_get_field_name(reader, &field_name));
+        for (i = 0; i < scan->node_count; i++) {
+            _IONC_PATH_NODE* node = &scan->nodes[i];
+            if (node->parent != parent || !ionc_string_equals(&node->name, &field_name)) continue;
+            if (node->column >= 0) {
+                if (scan->columns[node->column].rows == scan->rows) {
+                    IONCHECK(ionc_column_read(reader, t, &scan->columns[node->column], node->column));
+                }
+            }
+            else if (ION_TYPE_INT(t) == tid_STRUCT_INT) {
+                IONCHECK(ion_reader_is_null(reader, &is_null));
+                if (!is_null) {
+                    IONCHECK(ionc_columns_read_struct(reader, scan, i));
+                }
+            }
+            break;
+        }
+    }
+    IONCHECK(ion_reader_step_out(reader));
+    iRETURN;
+}
+
+/*
+ *  Reads every top-level struct of the stream as a row. Doesn't touch python, so it runs without the GIL.
+ */
+static iERR ionc_columns_read_all(hREADER reader, _IONC_COLUMN_SCAN* scan) {
+    iENTER;
+    ION_TYPE t;
+    BOOL is_null;
+    Py_ssize_t i;
+    for (;;) {
+        IONCHECK(ion_reader_next(reader, &t));
+        if (t == tid_EOF) break;
+        if (ION_TYPE_INT(t) != tid_STRUCT_INT) {
+            _FAILWITHMSG(IERR_INVALID_ARG, "Columns can only be read from a stream of structs.");
+        }
+        IONCHECK(ion_reader_is_null(reader, &is_null));
+        if (!is_null) {
+            IONCHECK(ionc_columns_read_struct(reader, scan, -1));
+        }
+        // Fields missing from the row are null.
+        for (i = 0; i < scan->column_count; i++) {
+            if (scan->columns[i].rows == scan->rows) {
+                IONCHECK(ionc_column_push(&scan->columns[i], NULL, 0));
+            }
+        }
+        scan->rows++;
+    }
+    iRETURN;
+}
+
+/*
+ *  Adds the path of a column to the scan's path trie. Fails if it is a prefix of, or has a prefix in, another path.
+ */
+static iERR ionc_columns_add_path(_IONC_COLUMN_SCAN* scan, PyObject* path, Py_ssize_t column) {
+    iENTER;
+    Py_ssize_t depth, i, parent = -1, path_len = PyTuple_GET_SIZE(path);
+    if (path_len == 0) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "Column paths must have at least one field name.");
+    }
+    for (depth = 0; depth < path_len; depth++) {
+        PyObject* py_name = PyTuple_GET_ITEM(path, depth);
+        ION_STRING name;
+        Py_ssize_t name_len;
+        if (!PyUnicode_Check(py_name)) {
+            _FAILWITHMSG(IERR_INVALID_ARG, "Column paths must be tuples of field names.");
+        }
+        name.value = (BYTE*)PyUnicode_AsUTF8AndSize(py_name, &name_len);
+        if (name.value == NULL) {
+            FAILWITH(IERR_INVALID_ARG);
+        }
+        name.length = (int32_t)name_len;
+        BOOL is_leaf = depth == path_len - 1;
+        for (i = 0; i < scan->node_count; i++) {
+            if (scan->nodes[i].parent == parent && ionc_string_equals(&scan->nodes[i].name, &name)) break;
+        }
+        if (i < scan->node_count) {
+            if (is_leaf || scan->nodes[i].column >= 0) {
+                _FAILWITHMSG(IERR_INVALID_ARG, "Column paths must not be prefixes of each other.");
+            }
+        }
+        else {
+            scan->nodes[i].parent = parent;
+            scan->nodes[i].name = name;
+            scan->nodes[i].column = is_leaf ? column : -1;
+            scan->node_count++;
+        }
+        parent = i;
+    }
+    iRETURN;
+}
+
+static void ionc_column_scan_free(_IONC_COLUMN_SCAN* scan) {
+    Py_ssize_t i;
+    if (scan->columns != NULL) {
+        for (i = 0; i < scan->column_count; i++) {
+            PyMem_RawFree(scan->columns[i].validity.data);
+            PyMem_RawFree(scan->columns[i].values.data);
+            PyMem_RawFree(scan->columns[i].offsets.data);
+        }
+        PyMem_RawFree(scan->columns);
+    }
+    PyMem_RawFree(scan->nodes);
+}
+
+/*
+ *  A read-only buffer of a loaded column, exported through the buffer protocol with its item format.
+ */
+typedef struct {
+    PyObject_HEAD
+    _IONC_BUFFER buffer;
+    Py_ssize_t shape;
+    Py_ssize_t itemsize;
+    char* format;
+} ionc_Column;
+
+static int ionc_column_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    static BYTE empty[8];
+    ionc_Column* column = (ionc_Column*)self;
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Column buffers are read-only.");
+        view->obj = NULL;
+        return -1;
+    }
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = column->buffer.data ? column->buffer.data : empty;
+    view->len = column->shape * column->itemsize;
+    view->readonly = 1;
+    view->itemsize = column->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? column->format : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &column->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &column->itemsize : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static void ionc_column_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    PyMem_RawFree(((ionc_Column*)self)->buffer.data);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyType_Slot ionc_column_slots[] = {
+    {Py_tp_doc, "A read-only buffer of column values."},
+    {Py_tp_dealloc, ionc_column_dealloc},
+#if PY_VERSION_HEX >= 0x03090000
+    // Before 3.9 the buffer slots can't be given in a spec; the module sets them on the created type instead.
+    {Py_bf_getbuffer, ionc_column_getbuffer},
+#endif
+    {0, NULL}
+};
+
+static PyType_Spec ionc_column_spec = {
+    .name = "ionc.Column",
+    .basicsize = sizeof(ionc_Column),
+    .flags = IONC_TPFLAGS_INTERNAL,
+    .slots = ionc_column_slots
+};
+
+/*
+ *  Hands a filled buffer over to a new Column of the module state 'state'.
+ */
+static PyObject* ionc_column_new(_IONC_MODULE_STATE* state, _IONC_BUFFER* buffer, Py_ssize_t itemsize,
+                                 char* format) {
+    ionc_Column* column = PyObject_New(ionc_Column, (PyTypeObject*)state->column_type);
+    if (column == NULL) {
+        return NULL;
+    }
+    column->buffer = *buffer;
+    column->shape = buffer->len / itemsize;
+    column->itemsize = itemsize;
+    column->format = format;
+    memset(buffer, 0, sizeof(_IONC_BUFFER));
+    return (PyObject*)column;
+}
+
+/*
+ *  Reads a stream of structs straight into typed column buffers, one row per top-level struct, without creating a
+ *  python object per value. The stream is read with the GIL released.
+ *
+ *  Args:
+ *      data:  A bytes-like object holding text or binary Ion
+ *      columns:  A sequence of (path, type) tuples, where path is a tuple of field names and type is one of 'int64',
+ *          'float64', 'bool' or 'string'
+ *      catalog:  An optional SymbolTableCatalog
+ *
+ *  Returns:
+ *      A tuple of the row count and a list holding a (validity, values, offsets) tuple of Columns per column, where
+ *      offsets is None except for string columns
+ */
+PyObject* ionc_read_columns(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    PyObject *py_columns, *py_catalog = Py_None, *catalog = NULL, *schema = NULL, *py_column_list = NULL;
+    PyObject* result = NULL;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    ION_READER_OPTIONS options;
+    _IONC_COLUMN_SCAN scan;
+    decContext read_dec_context = state->dec_context;
+    Py_ssize_t i, j, path_nodes = 0;
+    static char *kwlist[] = {"data", "columns", "catalog", NULL};
+
+    buffer.obj = NULL;
+    memset(&scan, 0, sizeof(scan));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*O|O", kwlist, &buffer, &py_columns, &py_catalog)) {
+        return NULL;
+    }
+    // Holds the path tuples, and so the field name strs the path trie borrows from, until the read is done.
+    schema = PySequence_Tuple(py_columns);
+    if (schema == NULL) {
+        PyErr_Clear();
+        _FAILWITHMSG(IERR_INVALID_ARG, "columns must be a sequence of (path, type) tuples.");
+    }
+    scan.column_count = PyTuple_GET_SIZE(schema);
+    for (i = 0; i < scan.column_count; i++) {
+        PyObject* column = PyTuple_GET_ITEM(schema, i);
+        if (!PyTuple_Check(column) || PyTuple_GET_SIZE(column) != 2 || !PyTuple_Check(PyTuple_GET_ITEM(column, 0))
+                || !PyUnicode_Check(PyTuple_GET_ITEM(column, 1))) {
+            _FAILWITHMSG(IERR_INVALID_ARG, "columns must be a sequence of (path, type) tuples.");
+        }
+        path_nodes += PyTuple_GET_SIZE(PyTuple_GET_ITEM(column, 0));
+    }
+    scan.columns = (_IONC_COLUMN*)PyMem_RawCalloc(scan.column_count ? scan.column_count : 1, sizeof(_IONC_COLUMN));
+    scan.nodes = (_IONC_PATH_NODE*)PyMem_RawCalloc(path_nodes ? path_nodes : 1, sizeof(_IONC_PATH_NODE));
+    if (scan.columns == NULL || scan.nodes == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    for (i = 0; i < scan.column_count; i++) {
+        PyObject* column = PyTuple_GET_ITEM(schema, i);
+        const char* type_name = PyUnicode_AsUTF8(PyTuple_GET_ITEM(column, 1));
+        for (j = 0; j < IONC_COLUMN_TYPE_COUNT; j++) {
+            if (type_name && strcmp(type_name, IONC_COLUMN_TYPE_NAMES[j]) == 0) break;
+        }
+        if (j == IONC_COLUMN_TYPE_COUNT) {
+            PyErr_Clear();
+            _FAILWITHMSG(IERR_INVALID_ARG, "Column types must be one of 'int64', 'float64', 'bool' or 'string'.");
+        }
+        scan.columns[i].type = (int)j;
+        if (j == IONC_COLUMN_STRING) {
+            int64_t offset = 0;
+            IONCHECK(ionc_buffer_append(&scan.columns[i].offsets, &offset, sizeof(offset)));
+        }
+        err = ionc_columns_add_path(&scan, PyTuple_GET_ITEM(column, 0), i);
+        if (err) {
+            PyErr_Clear();
+            FAILWITH(err);
+        }
+    }
+
+    memset(&options, 0, sizeof(options));
+    options.decimal_context = &read_dec_context;
+    if (py_catalog != Py_None) {
+        IONCHECK(ionc_catalog_from_py(state, py_catalog, &catalog));
+        options.pcatalog = (hCATALOG) PyCapsule_GetPointer(catalog, IONC_CATALOG_CAPSULE_NAME);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = ionc_reader_open_pinned(state, &reader, &buffer, &pinned_stream, &options);
+    if (!err) {
+        err = ionc_columns_read_all(reader, &scan);
+    }
+    if (reader != NULL) {
+        iERR close_err = ion_reader_close(reader);
+        if (!err) err = close_err;
+        reader = NULL;
+    }
+    Py_END_ALLOW_THREADS
+    IONCHECK(err);
+
+    py_column_list = PyList_New(scan.column_count);
+    if (py_column_list == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    for (i = 0; i < scan.column_count; i++) {
+        _IONC_COLUMN* column = &scan.columns[i];
+        PyObject* validity = ionc_column_new(state, &column->validity, 1, "B");
+        PyObject* values = ionc_column_new(state, &column->values, IONC_COLUMN_ITEM_SIZES[column->type],
+                                           IONC_COLUMN_FORMATS[column->type]);
+        PyObject* offsets = column->type == IONC_COLUMN_STRING
+                ? ionc_column_new(state, &column->offsets, 8, "q") : Py_None;
+        if (offsets == Py_None) {
+            Py_INCREF(Py_None);
+        }
+        PyObject* buffers = (validity && values && offsets) ? PyTuple_Pack(3, validity, values, offsets) : NULL;
+        Py_XDECREF(validity);
+        Py_XDECREF(values);
+        Py_XDECREF(offsets);
+        if (buffers == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        PyList_SET_ITEM(py_column_list, i, buffers);
+    }
+    result = Py_BuildValue("(nO)", scan.rows, py_column_list);
+    if (result == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+
+fail:
+    ionc_column_scan_free(&scan);
+    Py_XDECREF(py_column_list);
+    Py_XDECREF(schema);
+    Py_XDECREF(catalog);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    if (err) {
+        Py_XDECREF(result);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    return result;
+}
+
+/******************************************************************************
+*       Transcoding                                                           *
+******************************************************************************/
+
+/*
+ *  Re-encodes a buffer of Ion as binary or text by connecting an ion-c reader straight to an ion-c writer, so no
+ *  Python object is built for any value. The whole conversion runs without the GIL.
+ */
+PyObject* ionc_transcode(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    PyObject *binary = Py_True, *indent = Py_None, *py_catalog = Py_None, *catalog = NULL, *written = NULL;
+    int omit_version_marker = 0;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    hWRITER writer = NULL;
+    ION_STREAM* ion_stream = NULL;
+    ION_READER_OPTIONS read_options;
+    ION_WRITER_OPTIONS write_options;
+    decContext read_dec_context = state->dec_context;
+    static char *kwlist[] = {"data", "binary", "indent", "omit_version_marker", "catalog", NULL};
+
+    buffer.obj = NULL;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|OOpO", kwlist, &buffer, &binary, &indent,
+                                     &omit_version_marker, &py_catalog)) {
+        return NULL;
+    }
+
+    memset(&read_options, 0, sizeof(read_options));
+    read_options.decimal_context = &read_dec_context;
+    if (py_catalog != Py_None) {
+        IONCHECK(ionc_catalog_from_py(state, py_catalog, &catalog));
+        read_options.pcatalog = (hCATALOG) PyCapsule_GetPointer(catalog, IONC_CATALOG_CAPSULE_NAME);
+    }
+    memset(&write_options, 0, sizeof(write_options));
+    write_options.output_as_binary = PyObject_IsTrue(binary);
+    write_options.max_annotation_count = ANNOTATION_MAX_LEN;
+
+    IONCHECK(ion_stream_open_memory_only(&ion_stream));
+    if (!write_options.output_as_binary && !omit_version_marker) {
+        IONCHECK(ionc_write_text_version_marker(ion_stream));
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    err = ionc_reader_open_pinned(state, &reader, &buffer, &pinned_stream, &read_options);
+    if (!err) {
+        err = ion_writer_open(&writer, ion_stream, &write_options);
+    }
+    if (!err) {
+        err = ion_writer_write_all_values(writer, reader);
+    }
+    if (writer != NULL) {
+        iERR close_err = ion_writer_close(writer);
+        if (!err) err = close_err;
+        writer = NULL;
+    }
+    if (reader != NULL) {
+        iERR close_err = ion_reader_close(reader);
+        if (!err) err = close_err;
+        reader = NULL;
+    }
+    Py_END_ALLOW_THREADS
+    IONCHECK(err);
+
+    IONCHECK(ionc_stream_to_bytes(ion_stream, &written));
+    if (!write_options.output_as_binary && indent != Py_None) {
+        IONCHECK(ionc_pretty_print_bytes(indent, &written));
+    }
+
+fail:
+    if (ion_stream != NULL) {
+        ion_stream_close(ion_stream);
+    }
+    Py_XDECREF(catalog);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    if (err) {
+        Py_XDECREF(written);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    return written;
+}
+
+/******************************************************************************
+*       JSON down-conversion                                                  *
+******************************************************************************/
+
+#define IONC_JSON_APPEND(buffer, literal) ionc_buffer_append(buffer, literal, sizeof(literal) - 1)
+
+// A member of a struct being written, located by its offsets in the output.
+typedef struct {
+    Py_ssize_t index;       // its position in the struct
+    Py_ssize_t start;       // of its "name": value
+    Py_ssize_t name_len;    // of the JSON string of its name, with which it starts
+    Py_ssize_t end;
+    Py_ssize_t kept_start;  // of the member written in its place: itself, or the last of a repeated name; -1 if none
+    Py_ssize_t kept_end;
+    const BYTE* name;
+} _IONC_JSON_MEMBER;
+
+typedef struct {
+    _IONC_BUFFER out;
+    _IONC_BUFFER lob;       // holds the lob being converted
+    _IONC_BUFFER scratch;   // a struct's members while they are rewritten
+    _IONC_JSON_MEMBER* members; // of the structs being written, innermost last
+    Py_ssize_t member_count;
+    Py_ssize_t member_capacity;
+    decContext dec_context;
+} _IONC_JSON_CONTEXT;
+
+static const char IONC_JSON_HEX_DIGITS[] = "0123456789abcdef";
+static const char IONC_BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static iERR ionc_json_write_escaped_char(_IONC_BUFFER* out, Py_UCS4 c) {
+    iENTER;
+    char escaped[12];
+    switch (c) {
+        case '"':  IONCHECK(IONC_JSON_APPEND(out, "\\\"")); SUCCEED();
+        case '\\': IONCHECK(IONC_JSON_APPEND(out, "\\\\")); SUCCEED();
+        case '\n': IONCHECK(IONC_JSON_APPEND(out, "\\n")); SUCCEED();
+        case '\r': IONCHECK(IONC_JSON_APPEND(out, "\\r")); SUCCEED();
+        case '\t': IONCHECK(IONC_JSON_APPEND(out, "\\t")); SUCCEED();
+        case '\b': IONCHECK(IONC_JSON_APPEND(out, "\\b")); SUCCEED();
+        case '\f': IONCHECK(IONC_JSON_APPEND(out, "\\f")); SUCCEED();
+    }
+    if (c >= 0x20 && c < 0x7f) {
+        char ascii = (char)c;
+        IONCHECK(ionc_buffer_append(out, &ascii, 1));
+        SUCCEED();
+    }
+    if (c >= 0x10000) {
+        // Outside the basic multilingual plane, as json.dumps does: a surrogate pair.
+        c -= 0x10000;
+        IONCHECK(ionc_json_write_escaped_char(out, 0xd800 | (c >> 10)));
+        IONCHECK(ionc_json_write_escaped_char(out, 0xdc00 | (c & 0x3ff)));
+        SUCCEED();
+    }
+    escaped[0] = '\\';
+    escaped[1] = 'u';
+    escaped[2] = IONC_JSON_HEX_DIGITS[(c >> 12) & 0xf];
+    escaped[3] = IONC_JSON_HEX_DIGITS[(c >> 8) & 0xf];
+    escaped[4] = IONC_JSON_HEX_DIGITS[(c >> 4) & 0xf];
+    escaped[5] = IONC_JSON_HEX_DIGITS[c & 0xf];
+    IONCHECK(ionc_buffer_append(out, escaped, 6));
+    iRETURN;
+}
+
+/*
+ *  Writes UTF-8 text as a JSON string, escaping everything outside printable ASCII as json.dumps does by default.
+ */
+static iERR ionc_json_write_string(_IONC_BUFFER* out, const BYTE* text, SIZE len) {
+    iENTER;
+    SIZE i = 0, run;
+    IONCHECK(IONC_JSON_APPEND(out, "\""));
+    while (i < len) {
+        // Copy runs of characters that need no escaping at once.
+        for (run = i; run < len && text[run] >= 0x20 && text[run] < 0x7f && text[run] != '"' && text[run] != '\\';
+             run++);
+        IONCHECK(ionc_buffer_append(out, text + i, run - i));
+        i = run;
+        if (i == len) break;
+
+        Py_UCS4 c = text[i];
+        int continuation = 0;
+        if (c >= 0xf0 && c < 0xf5) { c &= 0x07; continuation = 3; }
+        else if (c >= 0xe0 && c < 0xf0) { c &= 0x0f; continuation = 2; }
+        else if (c >= 0xc2 && c < 0xe0) { c &= 0x1f; continuation = 1; }
+        else if (c >= 0x80) {
+            FAILWITH(IERR_INVALID_UNICODE_SEQUENCE);
+        }
+        if (continuation && i + continuation >= len) {
+            FAILWITH(IERR_INVALID_UNICODE_SEQUENCE);
+        }
+        for (i++; continuation > 0; continuation--, i++) {
+            if ((text[i] & 0xc0) != 0x80) {
+                FAILWITH(IERR_INVALID_UNICODE_SEQUENCE);
+            }
+            c = (c << 6) | (text[i] & 0x3f);
+        }
+        IONCHECK(ionc_json_write_escaped_char(out, c));
+    }
+    IONCHECK(IONC_JSON_APPEND(out, "\""));
+    iRETURN;
+}
+
+/*
+ *  Writes a float as json.dumps does: its repr, or Infinity, -Infinity and NaN.
+ */
+static iERR ionc_json_write_double(_IONC_BUFFER* out, double value) {
+    iENTER;
+    char* repr = NULL;
+    if (Py_IS_NAN(value)) {
+        IONCHECK(IONC_JSON_APPEND(out, "NaN"));
+        SUCCEED();
+    }
+    if (Py_IS_INFINITY(value)) {
+        IONCHECK(value > 0 ? IONC_JSON_APPEND(out, "Infinity") : IONC_JSON_APPEND(out, "-Infinity"));
+        SUCCEED();
+    }
+    repr = PyOS_double_to_string(value, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+    if (repr == NULL) {
+        PyErr_Clear();
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    IONCHECK(ionc_buffer_append(out, repr, strlen(repr)));
+
+fail:
+    PyMem_Free(repr);
+    cRETURN;
+}
+
+static iERR ionc_json_write_base64(_IONC_BUFFER* out, const BYTE* data, SIZE len) {
+    iENTER;
+    char quad[4];
+    SIZE i;
+    IONCHECK(IONC_JSON_APPEND(out, "\""));
+    for (i = 0; i < len; i += 3) {
+        uint32_t group = (uint32_t)data[i] << 16;
+        if (i + 1 < len) group |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) group |= data[i + 2];
+        quad[0] = IONC_BASE64_DIGITS[(group >> 18) & 0x3f];
+        quad[1] = IONC_BASE64_DIGITS[(group >> 12) & 0x3f];
+        quad[2] = i + 1 < len ? IONC_BASE64_DIGITS[(group >> 6) & 0x3f] : '=';
+        quad[3] = i + 2 < len ? IONC_BASE64_DIGITS[group & 0x3f] : '=';
+        IONCHECK(ionc_buffer_append(out, quad, 4));
+    }
+    IONCHECK(IONC_JSON_APPEND(out, "\""));
+    iRETURN;
+}
+
+/*
+ *  Writes a timestamp as the str() of the Timestamp it loads as, i.e. datetime's isoformat with a space separator.
+ */
+static iERR ionc_json_write_timestamp(_IONC_BUFFER* out, ION_TIMESTAMP* timestamp, decContext* context) {
+    iENTER;
+    char text[48];
+    int len, precision, digits, fractional_precision, microseconds = 0;
+    int month = 1, day = 1, hours = 0, minutes = 0, seconds = 0;
+    BOOL has_local_offset;
+
+    IONCHECK(ion_timestamp_get_precision(timestamp, &precision));
+    if (precision < ION_TS_YEAR) {
+        _FAILWITHMSG(IERR_INVALID_TIMESTAMP, "Found a timestamp with less than year precision.");
+    }
+    if (precision >= ION_TS_MONTH) month = timestamp->month;
+    if (precision >= ION_TS_DAY) day = timestamp->day;
+    if (precision >= ION_TS_MIN) {
+        hours = timestamp->hours;
+        minutes = timestamp->minutes;
+    }
+    if (precision >= ION_TS_SEC) seconds = timestamp->seconds;
+    if (precision == ION_TS_FRAC) {
+        IONCHECK(ionc_timestamp_fraction(timestamp, context, &digits, &fractional_precision, &microseconds));
+    }
+    len = snprintf(text, sizeof(text), "\"%04d-%02d-%02d %02d:%02d:%02d", timestamp->year, month, day, hours,
+                   minutes, seconds);
+    if (microseconds) {
+        len += snprintf(text + len, sizeof(text) - len, ".%06d", microseconds);
+    }
+    IONCHECK(ion_timestamp_has_local_offset(timestamp, &has_local_offset));
+    if (has_local_offset) {
+        int off_minutes;
+        IONCHECK(ion_timestamp_get_local_offset(timestamp, &off_minutes));
+        char sign = off_minutes < 0 ? '-' : '+';
+        if (off_minutes < 0) off_minutes = -off_minutes;
+        len += snprintf(text + len, sizeof(text) - len, "%c%02d:%02d", sign, off_minutes / 60, off_minutes % 60);
+    }
+    text[len++] = '"';
+    IONCHECK(ionc_buffer_append(out, text, len));
+    iRETURN;
+}
 
-    BOOL        is_null;
-    ION_STRING  field_name;
-    SIZE        annotation_count;
-    PyObject*   py_annotations = NULL;
-    PyObject*   py_value = NULL;
-    PyObject*   ion_nature_constructor = NULL;
-    PyObject*   py_field_name = NULL;
+static iERR ionc_json_write_all(hREADER hreader, _IONC_JSON_CONTEXT* context, BOOL in_struct);
 
-    if (parent_type > LIST) {
-        IONCHECK(ion_reader_get_field_name(hreader, &field_name));
-        py_field_name = ion_build_py_string(&field_name);
-    }
+/*
+ *  Writes the reader's current value as JSON, as json.dumps(value, cls=IonToJSONEncoder) would write the value it
+ *  loads as: annotations are dropped; symbols and strings become strings; decimals become floats; timestamps
+ *  become the str() of their Timestamp; blobs become base64 strings and clobs strings of their bytes as code points;
+ *  sexps become arrays; and float nan and infinities, as nulls of any type, become null.
+ */
+static iERR ionc_json_write_value(hREADER hreader, ION_TYPE t, _IONC_JSON_CONTEXT* context) {
+    iENTER;
+    _IONC_BUFFER* out = &context->out;
+    BOOL is_null;
+    ION_STRING string_value;
 
-    IONCHECK(ion_reader_get_annotation_count(hreader, &annotation_count));
-    if (annotation_count > 0) {
-        wrap_py_value = TRUE;
-        ION_STRING* annotations = (ION_STRING*)PyMem_Malloc(annotation_count * sizeof(ION_STRING));
-        err = ion_reader_get_annotations(hreader, annotations, annotation_count, &annotation_count);
-        if (err) {
-            PyMem_Free(annotations);
-            IONCHECK(err);
-        }
-        py_annotations = PyTuple_New(annotation_count);
-        int i;
-        for (i = 0; i < annotation_count; i++) {
-            PyTuple_SetItem(py_annotations, i, ion_string_to_py_symboltoken(&annotations[i]));
-        }
-        PyMem_Free(annotations);
-    }
-    ION_TYPE original_t = t;
     IONCHECK(ion_reader_is_null(hreader, &is_null));
     if (is_null) {
-        t = tid_NULL;
+        IONCHECK(IONC_JSON_APPEND(out, "null"));
+        SUCCEED();
     }
-    int ion_type = ION_TYPE_INT(t);
-
-    switch (ion_type) {
-        case tid_EOF_INT:
-            SUCCEED();
-        case tid_NULL_INT:
-        {
-            // TODO double check the real null type, now it's initialized to IonType.NULL by default
-            ION_TYPE null_type;
-            // Hack for ion-c issue https://github.com/amazon-ion/ion-c/issues/223
-            if (original_t != tid_SYMBOL_INT) {
-                IONCHECK(ion_reader_read_null(hreader, &null_type));
-            }
-            else {
-                null_type = tid_SYMBOL;
-            }
-
-            ion_type = ION_TYPE_INT(null_type);
-            py_value = Py_None;
-            // you wouldn't think you need to incref Py_None, and in
-            // newer C API versions you won't, but for now you do.
-            // see https://github.com/python/cpython/issues/103906 for more
-            Py_INCREF(py_value);
-            wrap_py_value = wrap_py_value || (ion_type != tid_NULL_INT);
-            ion_nature_constructor = _ionpynull_fromvalue;
-            break;
-        }
+    switch (ION_TYPE_INT(t)) {
         case tid_BOOL_INT:
         {
             BOOL bool_value;
             IONCHECK(ion_reader_read_bool(hreader, &bool_value));
-            py_value = PyBool_FromLong(bool_value);
-            ion_nature_constructor = _ionpybool_fromvalue;
+            IONCHECK(bool_value ? IONC_JSON_APPEND(out, "true") : IONC_JSON_APPEND(out, "false"));
             break;
         }
         case tid_INT_INT:
         {
-            int64_t int64_value;
-            err = ion_reader_read_int64(hreader, &int64_value);
-            if (err == IERR_OK) {
-                py_value = PyLong_FromLongLong(int64_value);
-            } else if (err == IERR_NUMERIC_OVERFLOW) {
+            int64_t int_value;
+            char int_text[24];
+            err = ion_reader_read_int64(hreader, &int_value);
+            if (err == IERR_NUMERIC_OVERFLOW) {
                 ION_INT ion_int_value;
+                SIZE int_char_len, int_char_written;
                 IONCHECK(ion_int_init(&ion_int_value, hreader));
                 IONCHECK(ion_reader_read_ion_int(hreader, &ion_int_value));
-                SIZE int_char_len, int_char_written;
-                // ion_int_char_length includes 1 char for \0
-                // which ion_int_to_char sets at end.
+                // ion_int_char_length includes 1 char for \0 which ion_int_to_char sets at end.
                 IONCHECK(ion_int_char_length(&ion_int_value, &int_char_len));
-                char* ion_int_str = (char*)PyMem_Malloc(int_char_len);
-                err = ion_int_to_char(&ion_int_value, (BYTE*)ion_int_str, int_char_len, &int_char_written);
-                if (err) {
-                    PyMem_Free(ion_int_str);
-                    IONCHECK(err);
-                }
-                py_value = PyLong_FromString(ion_int_str, NULL, 10);
-                PyMem_Free(ion_int_str);
-            } else {
-                FAILWITH(err)
+                IONCHECK(ionc_tape_reserve((void**)&context->lob.data, &context->lob.capacity, 0, int_char_len,
+                                           sizeof(BYTE)));
+                IONCHECK(ion_int_to_char(&ion_int_value, context->lob.data, int_char_len, &int_char_written));
+                IONCHECK(ionc_buffer_append(out, context->lob.data, strlen((char*)context->lob.data)));
+            }
+            else {
+                IONCHECK(err);
+                IONCHECK(ionc_buffer_append(out, int_text, snprintf(int_text, sizeof(int_text), "%lld",
+                                                                    (long long)int_value)));
             }
-
-            ion_nature_constructor = _ionpyint_fromvalue;
             break;
         }
         case tid_FLOAT_INT:
         {
             double double_value;
             IONCHECK(ion_reader_read_double(hreader, &double_value));
-            py_value = Py_BuildValue("d", double_value);
-            ion_nature_constructor = _ionpyfloat_fromvalue;
+            if (Py_IS_NAN(double_value) || Py_IS_INFINITY(double_value)) {
+                IONCHECK(IONC_JSON_APPEND(out, "null"));
+            }
+            else {
+                IONCHECK(ionc_json_write_double(out, double_value));
+            }
             break;
         }
         case tid_DECIMAL_INT:
         {
             ION_DECIMAL decimal_value;
+            char* dec_str;
             IONCHECK(ion_reader_read_ion_decimal(hreader, &decimal_value));
-            SIZE dec_len = ION_DECIMAL_STRLEN(&decimal_value);
-            char* dec_str = (char*)PyMem_Malloc(dec_len + 1);
-            // returns iERR but only error condition that would cause that is null decimal value
-            iERR e = ion_decimal_to_string(&decimal_value, dec_str);
-            if (e) {
-                ion_decimal_free(&decimal_value);
-                PyMem_Free(dec_str);
-                FAILWITH(e);
-            }
-            dec_str[dec_len] = '\0';
-            c_decstr_to_py_decstr(dec_str, dec_len);
-
-            if (wrap_py_value) {
-                py_value = Py_BuildValue("s", dec_str);
-            } else {
-                py_value = PyObject_CallFunction(_decimal_constructor, "s", dec_str, NULL);
+            SIZE dec_len = ionc_decimal_py_decstr_len(&decimal_value);
+            err = ionc_tape_reserve((void**)&context->lob.data, &context->lob.capacity, 0, dec_len + 1,
+                                    sizeof(BYTE));
+            if (!err) {
+                dec_str = (char*)context->lob.data;
+                dec_len = ionc_decimal_to_py_decstr(&decimal_value, dec_str);
+                dec_str[dec_len] = '\0';
             }
             ion_decimal_free(&decimal_value);
-            PyMem_Free(dec_str);
-
-            ion_nature_constructor = _ionpydecimal_fromvalue;
+            IONCHECK(err);
+            // float(Decimal) rounds correctly, as does parsing the decimal's text.
+            double double_value = PyOS_string_to_double(dec_str, NULL, NULL);
+            if (double_value == -1.0 && PyErr_Occurred()) {
+                PyErr_Clear();
+                FAILWITH(IERR_INVALID_ARG);
+            }
+            IONCHECK(ionc_json_write_double(out, double_value));
             break;
         }
         case tid_TIMESTAMP_INT:
         {
-            IONCHECK(ionc_read_timestamp(hreader, &py_value));
-            ion_nature_constructor = _ionpytimestamp_fromvalue;
+            ION_TIMESTAMP timestamp_value;
+            IONCHECK(ion_reader_read_timestamp(hreader, &timestamp_value));
+            IONCHECK(ionc_json_write_timestamp(out, &timestamp_value, &context->dec_context));
             break;
         }
         case tid_SYMBOL_INT:
-        {
-            ION_STRING string_value;
-            IONCHECK(ion_reader_read_string(hreader, &string_value));
-            if (!symbol_as_text) {
-                py_value = ion_string_to_py_symboltoken(&string_value);
-                ion_nature_constructor = _ionpysymbol_fromvalue;
-            } else if (ion_string_is_null(&string_value)) {
-                _FAILWITHMSG(IERR_INVALID_STATE, "Cannot emit symbol with undefined text when SYMBOL_AS_TEXT is set.");
-            } else {
-                py_value = ion_build_py_string(&string_value);
-                ion_nature_constructor = _ionpytext_fromvalue;
-            }
-            break;
-        }
         case tid_STRING_INT:
-        {
-            ION_STRING string_value;
             IONCHECK(ion_reader_read_string(hreader, &string_value));
-            py_value = ion_build_py_string(&string_value);
-            ion_nature_constructor = _ionpytext_fromvalue;
+            if (string_value.value == NULL) {
+                // A symbol with unknown text.
+                IONCHECK(IONC_JSON_APPEND(out, "null"));
+            }
+            else {
+                IONCHECK(ionc_json_write_string(out, string_value.value, string_value.length));
+            }
             break;
-        }
         case tid_CLOB_INT:
-        {
-            // Clob values must always be emitted as IonPyBytes, to avoid ambiguity with blob.
-            wrap_py_value = TRUE;
-            // intentional fall-through
-        }
         case tid_BLOB_INT:
         {
-            SIZE length, bytes_read;
-            char *buf = NULL;
+            SIZE length, bytes_read = 0, i;
             IONCHECK(ion_reader_get_lob_size(hreader, &length));
+            IONCHECK(ionc_tape_reserve((void**)&context->lob.data, &context->lob.capacity, 0, length, sizeof(BYTE)));
             if (length) {
-                buf = (char*)PyMem_Malloc((size_t)length);
-                err = ion_reader_read_lob_bytes(hreader, (BYTE *)buf, length, &bytes_read);
-                if (err) {
-                    PyMem_Free(buf);
-                    IONCHECK(err);
-                }
+                IONCHECK(ion_reader_read_lob_bytes(hreader, context->lob.data, length, &bytes_read));
                 if (length != bytes_read) {
-                    PyMem_Free(buf);
                     FAILWITH(IERR_EOF);
                 }
             }
-            else {
-                buf = "";
+            if (ION_TYPE_INT(t) == tid_BLOB_INT) {
+                IONCHECK(ionc_json_write_base64(out, context->lob.data, length));
+                break;
             }
-            py_value = Py_BuildValue(IONC_BYTES_FORMAT, buf, length);
-            if (length) {
-                PyMem_Free(buf);
+            IONCHECK(IONC_JSON_APPEND(out, "\""));
+            for (i = 0; i < length; i++) {
+                IONCHECK(ionc_json_write_escaped_char(out, context->lob.data[i]));
             }
-            ion_nature_constructor = _ionpybytes_fromvalue;
+            IONCHECK(IONC_JSON_APPEND(out, "\""));
             break;
         }
         case tid_STRUCT_INT:
-        {
-            enum ContainerType container_type;
-
-            if (use_std_dict) {
-                if (wrap_py_value) {
-                    // we construct an empty IonPyStdDict and don't wrap later to avoid
-                    // copying the values when wrapping or needing to delegate in the impl
-                    py_value = PyObject_CallFunctionObjArgs(
-                            _ionpystddict_cls,
-                            py_annotations,
-                            NULL);
-                    wrap_py_value = FALSE;
-                } else {
-                    py_value = PyDict_New();
-                }
-                container_type = STD_DICT;
-            } else {
-                py_value = PyDict_New();
-                ion_nature_constructor = _ionpydict_factory;
-                // there is no non-IonPy multimap so we always wrap
-                wrap_py_value = TRUE;
-                container_type = MULTIMAP;
-            }
-
-            IONCHECK(ionc_read_into_container(hreader, py_value, container_type, value_model));
+            IONCHECK(IONC_JSON_APPEND(out, "{"));
+            IONCHECK(ion_reader_step_in(hreader));
+            IONCHECK(ionc_json_write_all(hreader, context, TRUE));
+            IONCHECK(ion_reader_step_out(hreader));
+            IONCHECK(IONC_JSON_APPEND(out, "}"));
             break;
-        }
         case tid_SEXP_INT:
-        {
-            // Sexp values must always be emitted as IonPyList to avoid ambiguity with list.
-            wrap_py_value = TRUE;
-            // intentional fall-through
-        }
         case tid_LIST_INT:
-        {
-            // instead of creating a std Python list and "wrapping" it
-            // which would copy the elements, create the IonPyList now
-            if (wrap_py_value) {
-                py_value = PyObject_CallFunctionObjArgs(
-                        _ionpylist_factory,
-                        py_ion_type_table[ion_type >> 8],
-                        py_annotations,
-                        NULL);
-                wrap_py_value = FALSE;
-            } else {
-                py_value = PyList_New(0);
-            }
-            IONCHECK(ionc_read_into_container(hreader, py_value, LIST, value_model));
-            ion_nature_constructor = _ionpylist_fromvalue;
+            IONCHECK(IONC_JSON_APPEND(out, "["));
+            IONCHECK(ion_reader_step_in(hreader));
+            IONCHECK(ionc_json_write_all(hreader, context, FALSE));
+            IONCHECK(ion_reader_step_out(hreader));
+            IONCHECK(IONC_JSON_APPEND(out, "]"));
             break;
-        }
         case tid_DATAGRAM_INT:
         default:
             FAILWITH(IERR_INVALID_STATE);
+    }
+    iRETURN;
+}
+
+static BOOL ionc_json_member_same_name(const _IONC_JSON_MEMBER* left, const _IONC_JSON_MEMBER* right) {
+    return left->name_len == right->name_len && memcmp(left->name, right->name, left->name_len) == 0;
+}
+
+static int ionc_json_member_by_name(const void* a, const void* b) {
+    const _IONC_JSON_MEMBER* left = (const _IONC_JSON_MEMBER*)a;
+    const _IONC_JSON_MEMBER* right = (const _IONC_JSON_MEMBER*)b;
+    int order;
+    if (left->name_len != right->name_len) {
+        return left->name_len < right->name_len ? -1 : 1;
+    }
+    order = memcmp(left->name, right->name, left->name_len);
+    if (order != 0) {
+        return order;
+    }
+    return left->index < right->index ? -1 : left->index > right->index;
+}
+
+static int ionc_json_member_by_index(const void* a, const void* b) {
+    Py_ssize_t left = ((const _IONC_JSON_MEMBER*)a)->index, right = ((const _IONC_JSON_MEMBER*)b)->index;
+    return left < right ? -1 : left > right;
+}
+
+/*
+ *  Rewrites the members of the struct just written, the context's members from 'base' on, so that a repeated field
+ *  name only keeps its last value, at the position of its first, as in the struct that loading it builds.
+ */
+static iERR ionc_json_keep_last_fields(_IONC_JSON_CONTEXT* context, Py_ssize_t base) {
+    iENTER;
+    _IONC_JSON_MEMBER* members = context->members + base;
+    Py_ssize_t count = context->member_count - base, i, group, start;
+    BOOL repeated = FALSE;
+    if (count < 2) {
+        SUCCEED();
+    }
+    for (i = 0; i < count; i++) {
+        members[i].name = context->out.data + members[i].start;
+        members[i].kept_start = members[i].start;
+        members[i].kept_end = members[i].end;
+    }
+    // Sorted by name, and by position within a name, so the first of a group is where its last value goes.
+    qsort(members, count, sizeof(_IONC_JSON_MEMBER), ionc_json_member_by_name);
+    for (group = 0; group < count; group = i) {
+        for (i = group + 1; i < count && ionc_json_member_same_name(&members[group], &members[i]); i++) {
+            members[i].kept_start = -1;
+        }
+        if (i - group > 1) {
+            repeated = TRUE;
+            members[group].kept_start = members[i - 1].start;
+            members[group].kept_end = members[i - 1].end;
         }
+    }
+    if (!repeated) {
+        SUCCEED();
+    }
+    qsort(members, count, sizeof(_IONC_JSON_MEMBER), ionc_json_member_by_index);
+    context->scratch.len = 0;
+    for (i = 0; i < count; i++) {
+        if (members[i].kept_start < 0) {
+            continue;
+        }
+        if (context->scratch.len) {
+            IONCHECK(IONC_JSON_APPEND(&context->scratch, ", "));
+        }
+        IONCHECK(ionc_buffer_append(&context->scratch, context->out.data + members[i].kept_start,
+                                    members[i].kept_end - members[i].kept_start));
+    }
+    start = members[0].start;
+    memcpy(context->out.data + start, context->scratch.data, context->scratch.len);
+    context->out.len = start + context->scratch.len;
+    iRETURN;
+}
 
-    PyObject* final_py_value = py_value;
-    if (wrap_py_value) {
-        final_py_value = PyObject_CallFunctionObjArgs(
-            ion_nature_constructor,
-            py_ion_type_table[ion_type >> 8],
-            py_value,
-            py_annotations,
-            NULL
-        );
-        Py_XDECREF(py_value);
+/*
+ *  Writes the values at the reader's depth, separated as json.dumps separates them by default. Of the fields of a
+ *  struct with the same name, only the last value is kept.
+ */
+static iERR ionc_json_write_all(hREADER hreader, _IONC_JSON_CONTEXT* context, BOOL in_struct) {
+    iENTER;
+    ION_TYPE t;
+    ION_STRING field_name;
+    BOOL first = TRUE;
+    Py_ssize_t base = context->member_count, start = 0, name_len = 0;
+    for (;;) {
+        IONCHECK(ion_reader_next(hreader, &t));
+        if (t == tid_EOF) {
+            break;
+        }
+        if (!first) {
+            IONCHECK(IONC_JSON_APPEND(&context->out, ", "));
+        }
+        first = FALSE;
+        if (in_struct) {
+            IONCHECK(ion_reader_get_field_name(hreader, &field_name));
+            if (field_name.value == NULL) {
+                _FAILWITHMSG(IERR_INVALID_SYMBOL, "Found a field name with unknown text.");
+            }
+            start = context->out.len;
+            IONCHECK(ionc_json_write_string(&context->out, field_name.value, field_name.length));
+            name_len = context->out.len - start;
+            IONCHECK(IONC_JSON_APPEND(&context->out, ": "));
+        }
+        IONCHECK(ionc_json_write_value(hreader, t, context));
+        if (in_struct) {
+            // Reserved only now, as the members of the structs in the value come and go while it is written.
+            IONCHECK(ionc_tape_reserve((void**)&context->members, &context->member_capacity, context->member_count,
+                                       1, sizeof(_IONC_JSON_MEMBER)));
+            _IONC_JSON_MEMBER* member = &context->members[context->member_count++];
+            member->index = context->member_count - 1 - base;
+            member->start = start;
+            member->name_len = name_len;
+            member->end = context->out.len;
+        }
     }
+    if (in_struct) {
+        IONCHECK(ionc_json_keep_last_fields(context, base));
+    }
+fail:
+    context->member_count = base;
+    cRETURN;
+}
 
-    ionc_add_to_container(container, final_py_value, parent_type, py_field_name);
+/*
+ *  Down-converts a buffer of Ion straight to JSON text, without building the Python values. With single_value, the
+ *  stream must hold at most one value, which is written on its own (null if there is none); otherwise the stream's
+ *  values are written as a JSON array.
+ */
+PyObject* ionc_to_json(PyObject* self, PyObject *args, PyObject *kwds) {
+    iENTER;
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    int single_value = 1;
+    PyObject *py_catalog = Py_None, *catalog = NULL, *json = NULL;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    ION_READER_OPTIONS options;
+    ION_TYPE t;
+    _IONC_JSON_CONTEXT context;
+    static char *kwlist[] = {"data", "single_value", "catalog", NULL};
+
+    buffer.obj = NULL;
+    memset(&context, 0, sizeof(context));
+    context.dec_context = state->dec_context;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|pO", kwlist, &buffer, &single_value, &py_catalog)) {
+        return NULL;
+    }
+    memset(&options, 0, sizeof(options));
+    options.decimal_context = &context.dec_context;
+    if (py_catalog != Py_None) {
+        IONCHECK(ionc_catalog_from_py(state, py_catalog, &catalog));
+        options.pcatalog = (hCATALOG) PyCapsule_GetPointer(catalog, IONC_CATALOG_CAPSULE_NAME);
+    }
+
+    IONCHECK(ionc_reader_open_pinned(state, &reader, &buffer, &pinned_stream, &options));
+    if (single_value) {
+        IONCHECK(ion_reader_next(reader, &t));
+        if (t == tid_EOF) {
+            IONCHECK(IONC_JSON_APPEND(&context.out, "null"));
+        }
+        else {
+            IONCHECK(ionc_json_write_value(reader, t, &context));
+            IONCHECK(ion_reader_next(reader, &t));
+            if (t != tid_EOF) {
+                _FAILWITHMSG(IERR_INVALID_STATE, "Stream contained more than 1 values; expected a single value.");
+            }
+        }
+    }
+    else {
+        IONCHECK(IONC_JSON_APPEND(&context.out, "["));
+        IONCHECK(ionc_json_write_all(reader, &context, FALSE));
+        IONCHECK(IONC_JSON_APPEND(&context.out, "]"));
+    }
+    // Everything written is ASCII.
+    json = PyUnicode_DecodeASCII((char*)context.out.data, context.out.len, NULL);
+    if (json == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
 
 fail:
-    Py_XDECREF(py_annotations);
-    // note: we're not actually increffing None when we have a field name that has
-    // no text, which we technically _should_ be doing.
-    // todo: consider increffing Py_None in ion_build_py_string
-    if (py_field_name && py_field_name != Py_None) Py_DECREF(py_field_name);
+    if (reader != NULL) {
+        ion_reader_close(reader);
+    }
+    PyMem_RawFree(context.out.data);
+    PyMem_RawFree(context.lob.data);
+    PyMem_RawFree(context.scratch.data);
+    PyMem_RawFree(context.members);
+    Py_XDECREF(catalog);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
     if (err) {
-        Py_XDECREF(py_value);
+        Py_XDECREF(json);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    return json;
+}
+
+/******************************************************************************
+*       Statistics                                                            *
+******************************************************************************/
+
+/*
+ *  Turns the counters on or off. Counting costs a branch per value, and a clock read per timed conversion and file
+ *  call, so they start off. Returns whether they were enabled.
+ */
+PyObject* ionc_stats_enable(PyObject* self, PyObject *args, PyObject *kwds) {
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    int enabled = 1;
+    BOOL was_enabled = state->stats_enabled;
+    static char *kwlist[] = {"enabled", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &enabled)) {
+        return NULL;
+    }
+#ifdef IONC_DISABLE_STATS
+    if (enabled) {
+        PyErr_SetString(PyExc_NotImplementedError, "The C extension was built with IONC_DISABLE_STATS.");
+        return NULL;
+    }
+#endif
+    state->stats_enabled = enabled ? TRUE : FALSE;
+    return PyBool_FromLong(was_enabled);
+}
+
+/*
+ *  Returns a dict of each IonType with a non-zero count to its count, from counts indexed by the type's id >> 8.
+ */
+static PyObject* ionc_type_histogram_to_py(_IONC_MODULE_STATE* state, const uint64_t* counts) {
+    int i;
+    PyObject *histogram, *count, *previous;
+    histogram = PyDict_New();
+    if (histogram == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < IONC_STATS_TYPE_COUNT; i++) {
+        uint64_t n = counts[i];
+        if (n == 0) {
+            continue;
+        }
+        // Both int type ids are IonType.INT.
+        previous = PyDict_GetItem(histogram, state->py_ion_type_table[i]);
+        if (previous != NULL) {
+            n += PyLong_AsUnsignedLongLong(previous);
+        }
+        count = PyLong_FromUnsignedLongLong(n);
+        if (count == NULL || PyDict_SetItem(histogram, state->py_ion_type_table[i], count) < 0) {
+            Py_XDECREF(count);
+            Py_DECREF(histogram);
+            return NULL;
+        }
+        Py_DECREF(count);
+    }
+    return histogram;
+}
+
+/*
+ *  Returns the counters as a dict, and zeroes them afterwards if 'reset':
+ *      {enabled, refills, refill_bytes, refill_nanos, flushes, flush_bytes, flush_nanos,
+ *       values: {IonType: count}, wrappers, decimal_nanos, timestamp_nanos, allocations}
+ *  Values are counted by the type they are read as, so typed nulls count under their type.
+ */
+PyObject* ionc_stats(PyObject* self, PyObject *args, PyObject *kwds) {
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    int reset = 0;
+    PyObject *values;
+    static char *kwlist[] = {"reset", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", kwlist, &reset)) {
+        return NULL;
+    }
+
+    IONC_LOCK(state->stats_mutex);
+    _IONC_STATS counts = state->stats;
+    if (reset) {
+        memset(&state->stats, 0, sizeof(state->stats));
+    }
+    IONC_UNLOCK(state->stats_mutex);
+
+    values = ionc_type_histogram_to_py(state, counts.values);
+    if (values == NULL) {
+        return NULL;
+    }
+
+    PyObject* stats = Py_BuildValue("{s:O,s:K,s:K,s:K,s:K,s:K,s:K,s:N,s:K,s:K,s:K,s:K}",
+        "enabled", state->stats_enabled ? Py_True : Py_False,
+        "refills", (unsigned long long)counts.refills,
+        "refill_bytes", (unsigned long long)counts.refill_bytes,
+        "refill_nanos", (unsigned long long)counts.refill_nanos,
+        "flushes", (unsigned long long)counts.flushes,
+        "flush_bytes", (unsigned long long)counts.flush_bytes,
+        "flush_nanos", (unsigned long long)counts.flush_nanos,
+        "values", values,
+        "wrappers", (unsigned long long)counts.wrappers,
+        "decimal_nanos", (unsigned long long)counts.decimal_nanos,
+        "timestamp_nanos", (unsigned long long)counts.timestamp_nanos,
+        "allocations", (unsigned long long)counts.allocations);
+    return stats;
+}
+
+/******************************************************************************
+*       Scan                                                                  *
+******************************************************************************/
+
+#define IONC_SCAN_LOB_CHUNK_SIZE 1024*4
+
+// What a scan has found so far. Filled without the GIL or any Python object.
+typedef struct {
+    BOOL validate; // read every value with the calls the Python read paths make, rather than only stepping over it
+    Py_ssize_t top_level_count;
+    Py_ssize_t value_count; // at every depth
+    uint64_t type_counts[IONC_STATS_TYPE_COUNT]; // at every depth, by the type's id >> 8
+    uint64_t type_bytes[IONC_STATS_TYPE_COUNT]; // of the top-level values, from the start of each to the next
+    SIZE max_depth; // of the containers, so 0 for a stream of scalars
+    BOOL collect_offsets;
+    POSITION* offsets; // of the top-level values, when collected; allocated with PyMem_RawMalloc
+    Py_ssize_t offsets_capacity;
+    int previous_type; // of the last top-level value, whose bytes are counted at the start of the next; -1 if none
+    POSITION previous_offset;
+} _IONC_SCAN;
+
+/*
+ *  Counts the bytes of the last top-level value, which ends where the next value, or the stream, starts.
+ */
+static void ionc_scan_end_top_level_value(_IONC_SCAN* scan, POSITION end) {
+    if (scan->previous_type >= 0 && end > scan->previous_offset) {
+        scan->type_bytes[scan->previous_type] += (uint64_t)(end - scan->previous_offset);
     }
-    cRETURN;
+    scan->previous_type = -1;
 }
 
 /*
- *  Reads ion values
- *
- *  Args:
- *      hreader:  An ion reader
- *      container:  A container that elements are read from
- *      parent_type: the type of the container to add to.
- *      value_model: Flags to control how Ion values map to Python types
- *
+ *  Steps through every value at the reader's depth and below. Scalars are only read when validating: otherwise the
+ *  binary reader skips them by their length, and only the structure of the stream is checked.
  */
-iERR ionc_read_all(hREADER hreader, PyObject* container, enum ContainerType parent_type, uint8_t value_model) {
+static iERR ionc_scan_walk(hREADER hreader, _IONC_SCAN* scan, SIZE depth, BOOL in_struct) {
     iENTER;
     ION_TYPE t;
+    BOOL is_null, bool_value;
+    int64_t int_value;
+    double double_value;
+    ION_DECIMAL decimal_value;
+    ION_TIMESTAMP timestamp_value;
+    ION_STRING string_value;
+    SIZE annotation_count, length, bytes_read;
+    POSITION offset;
+    BYTE lob_chunk[IONC_SCAN_LOB_CHUNK_SIZE];
+
     for (;;) {
         IONCHECK(ion_reader_next(hreader, &t));
         if (t == tid_EOF) {
-            assert(t == tid_EOF && "next() at end");
             break;
         }
-        IONCHECK(ionc_read_value(hreader, t, container, parent_type, value_model));
+        int type_index = ION_TYPE_INT(t) >> 8;
+        if (type_index >= IONC_STATS_TYPE_COUNT) {
+            FAILWITH(IERR_INVALID_STATE);
+        }
+        scan->value_count++;
+        scan->type_counts[type_index]++;
+        if (depth == 0) {
+            IONCHECK(ion_reader_get_value_offset(hreader, &offset));
+            ionc_scan_end_top_level_value(scan, offset);
+            scan->previous_type = type_index;
+            scan->previous_offset = offset;
+            if (scan->collect_offsets) {
+                IONCHECK(ionc_tape_reserve((void**)&scan->offsets, &scan->offsets_capacity, scan->top_level_count,
+                                           1, sizeof(POSITION)));
+                scan->offsets[scan->top_level_count] = offset;
+            }
+            scan->top_level_count++;
+        }
+        if (scan->validate) {
+            // Resolves the symbol IDs of the field name and annotations.
+            if (in_struct) {
+                IONCHECK(ion_reader_get_field_name(hreader, &string_value));
+            }
+            IONCHECK(ion_reader_get_annotation_count(hreader, &annotation_count));
+            if (annotation_count > 0) {
+                SIZE i;
+                for (i = 0; i < annotation_count; i++) {
+                    IONCHECK(ion_reader_get_an_annotation(hreader, i, &string_value));
+                }
+            }
+        }
+        int ion_type = ION_TYPE_INT(t);
+        if (ion_type != tid_STRUCT_INT && ion_type != tid_SEXP_INT && ion_type != tid_LIST_INT && !scan->validate) {
+            continue;
+        }
+        IONCHECK(ion_reader_is_null(hreader, &is_null));
+        if (is_null) {
+            continue;
+        }
+        switch (ion_type) {
+            case tid_BOOL_INT:
+                IONCHECK(ion_reader_read_bool(hreader, &bool_value));
+                break;
+            case tid_INT_INT:
+                err = ion_reader_read_int64(hreader, &int_value);
+                if (err == IERR_NUMERIC_OVERFLOW) {
+                    ION_INT ion_int_value;
+                    IONCHECK(ion_int_init(&ion_int_value, hreader));
+                    IONCHECK(ion_reader_read_ion_int(hreader, &ion_int_value));
+                }
+                else {
+                    IONCHECK(err);
+                }
+                break;
+            case tid_FLOAT_INT:
+                IONCHECK(ion_reader_read_double(hreader, &double_value));
+                break;
+            case tid_DECIMAL_INT:
+                IONCHECK(ion_reader_read_ion_decimal(hreader, &decimal_value));
+                ion_decimal_free(&decimal_value);
+                break;
+            case tid_TIMESTAMP_INT:
+                IONCHECK(ion_reader_read_timestamp(hreader, &timestamp_value));
+                break;
+            case tid_SYMBOL_INT:
+            case tid_STRING_INT:
+                IONCHECK(ion_reader_read_string(hreader, &string_value));
+                break;
+            case tid_CLOB_INT:
+            case tid_BLOB_INT:
+                IONCHECK(ion_reader_get_lob_size(hreader, &length));
+                while (length > 0) {
+                    IONCHECK(ion_reader_read_lob_partial_bytes(hreader, lob_chunk, IONC_SCAN_LOB_CHUNK_SIZE,
+                                                               &bytes_read));
+                    if (bytes_read == 0) {
+                        FAILWITH(IERR_EOF);
+                    }
+                    length -= bytes_read;
+                }
+                break;
+            case tid_STRUCT_INT:
+            case tid_SEXP_INT:
+            case tid_LIST_INT:
+                if (depth + 1 > scan->max_depth) {
+                    scan->max_depth = depth + 1;
+                }
+                IONCHECK(ion_reader_step_in(hreader));
+                IONCHECK(ionc_scan_walk(hreader, scan, depth + 1, ion_type == tid_STRUCT_INT));
+                IONCHECK(ion_reader_step_out(hreader));
+                break;
+            case tid_DATAGRAM_INT:
+            default:
+                FAILWITH(IERR_INVALID_STATE);
+        }
     }
     iRETURN;
 }
 
-iERR ion_read_file_stream_handler(struct _ion_user_stream *pstream) {
+/*
+ *  Checks that a stream is well-formed Ion and summarizes it, without creating a Python object per value:
+ *      {values, total_values, types: {IonType: count}, bytes: {IonType: bytes}, max_depth, error, offsets}
+ *  'values' counts the top-level values and 'total_values' those at every depth, which 'types' breaks down by type.
+ *  'bytes' sums the sizes of the top-level values by their type, each measured from its start to that of the next,
+ *  so any whitespace, comments or symbol tables in between are counted with the value before them. 'max_depth' is
+ *  the deepest container nesting. 'error' is None for a valid stream; otherwise the scan stops at the first error and
+ *  it is {message, position, line, column}, the byte position of the reader, and for text its line and column, with
+ *  everything before it counted. When 'offsets' is True, 'offsets' lists the byte offset of every top-level value,
+ *  e.g. to split a stream between workers; otherwise it is None.
+ *
+ *  With 'validate' False, scalars are stepped over without being read: that only checks the structure of a binary
+ *  stream, but a text stream is still fully tokenized.
+ *
+ *  'file' may be a bytes-like object, scanned in place with the GIL released, or a file, read as by ionc_read.
+ */
+PyObject* ionc_scan(PyObject *self, PyObject *args, PyObject *kwds) {
     iENTER;
-    char *char_buffer = NULL;
-    Py_ssize_t size;
-    _ION_READ_STREAM_HANDLE *stream_handle = (_ION_READ_STREAM_HANDLE *) pstream->handler_state;
-    PyObject *py_buffer_as_bytes = NULL;
-    PyObject *py_buffer = PyObject_CallMethod(stream_handle->py_file, "read", "O", IONC_STREAM_BYTES_READ_SIZE);
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    PyObject *py_file = NULL, *py_catalog = Py_None, *catalog = NULL, *result = NULL, *py_error = NULL;
+    PyObject *py_offsets = NULL, *types = NULL, *type_bytes = NULL;
+    int validate = 1, offsets = 0;
+    Py_ssize_t read_size = 0, i;
+    Py_buffer buffer;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    ION_READER_OPTIONS options;
+    decContext read_dec_context = state->dec_context;
+    _ION_READ_STREAM_HANDLE stream_handle;
+    _IONC_SCAN scan;
+    iERR scan_err;
+    POSITION end = 0;
+    int64_t error_bytes = 0;
+    int32_t error_line = 0, error_column = 0;
+    static char *kwlist[] = {"file", "validate", "offsets", "catalog", "read_size", NULL};
+
+    buffer.obj = NULL;
+    memset(&stream_handle, 0, sizeof(stream_handle));
+    memset(&scan, 0, sizeof(scan));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ppOn", kwlist, &py_file, &validate, &offsets, &py_catalog,
+                                     &read_size)) {
+        return NULL;
+    }
+    if (read_size <= 0) {
+        read_size = IONC_STREAM_READ_BUFFER_SIZE;
+    }
+    if (read_size > IONC_STREAM_MAX_READ_SIZE) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "read_size must be at most 1 GiB.");
+    }
+    scan.validate = validate;
+    scan.collect_offsets = offsets;
+    scan.previous_type = -1;
 
-    if (py_buffer == NULL) {
-        pstream->limit = NULL;
-        FAILWITH(IERR_READ_ERROR);
+    memset(&options, 0, sizeof(options));
+    options.decimal_context = &read_dec_context;
+    if (py_catalog != Py_None) {
+        IONCHECK(ionc_catalog_from_py(state, py_catalog, &catalog));
+        options.pcatalog = (hCATALOG) PyCapsule_GetPointer(catalog, IONC_CATALOG_CAPSULE_NAME);
     }
 
-    if (PyBytes_Check(py_buffer)) {
-        // stream is binary
-        if (PyBytes_AsStringAndSize(py_buffer, &char_buffer, &size) < 0) {
-            pstream->limit = NULL;
-            FAILWITH(IERR_READ_ERROR);
-        }
-    } else {
-        // convert str to unicode
-        py_buffer_as_bytes = PyUnicode_AsUTF8String(py_buffer);
-        if (py_buffer_as_bytes == NULL || py_buffer_as_bytes == Py_None) {
-            pstream->limit = NULL;
-            FAILWITH(IERR_READ_ERROR);
+    if (PyObject_CheckBuffer(py_file)) {
+        if (PyObject_GetBuffer(py_file, &buffer, PyBUF_SIMPLE) < 0) {
+            buffer.obj = NULL;
+            FAILWITH(IERR_INVALID_ARG);
         }
-        if (PyBytes_AsStringAndSize(py_buffer_as_bytes, &char_buffer, &size) < 0) {
-            pstream->limit = NULL;
-            FAILWITH(IERR_READ_ERROR);
+        IONCHECK(ionc_reader_open_pinned(state, &reader, &buffer, &pinned_stream, &options));
+        Py_BEGIN_ALLOW_THREADS
+        scan_err = ionc_scan_walk(reader, &scan, 0, FALSE);
+        Py_END_ALLOW_THREADS
+        end = buffer.len;
+    }
+    else {
+        // The stream handler calls into the file, so the GIL is held throughout.
+        stream_handle.py_file = py_file;
+        stream_handle.read_size = read_size;
+        stream_handle.use_readinto = PyObject_HasAttr(py_file, state->readinto_str);
+        IONCHECK(ion_reader_open_stream(&reader, &stream_handle, ion_read_file_stream_handler, &options));
+        scan_err = ionc_scan_walk(reader, &scan, 0, FALSE);
+        if (!scan_err && ion_reader_get_position(reader, &error_bytes, &error_line, &error_column) == IERR_OK) {
+            end = error_bytes;
         }
     }
 
-    // safe-guarding the size variable to protect memcpy bounds
-    if (size < 0  || size > IONC_STREAM_READ_BUFFER_SIZE) {
-        FAILWITH(IERR_READ_ERROR);
+    if (scan_err) {
+        if (scan_err == IERR_NO_MEMORY || PyErr_Occurred()) {
+            // Not a problem with the data.
+            FAILWITH(scan_err);
+        }
+        ion_reader_get_position(reader, &error_bytes, &error_line, &error_column);
+        end = error_bytes;
+        if (error_line > 0) {
+            py_error = Py_BuildValue("{s:s,s:L,s:i,s:i}", "message", ion_error_to_str(scan_err),
+                                     "position", (long long)error_bytes, "line", error_line, "column", error_column);
+        }
+        else {
+            py_error = Py_BuildValue("{s:s,s:L,s:O,s:O}", "message", ion_error_to_str(scan_err),
+                                     "position", (long long)error_bytes, "line", Py_None, "column", Py_None);
+        }
+        _err_msg[0] = '\0';
+        if (py_error == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+    }
+    else {
+        py_error = Py_None;
+        Py_INCREF(py_error);
     }
-    memcpy(stream_handle->buffer, char_buffer, size);
+    ionc_scan_end_top_level_value(&scan, end);
 
-    pstream->curr = stream_handle->buffer;
-    if (size < 1) {
-        pstream->limit = NULL;
-        DONTFAILWITH(IERR_EOF);
+    if (offsets) {
+        py_offsets = PyList_New(scan.top_level_count);
+        if (py_offsets == NULL) {
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        for (i = 0; i < scan.top_level_count; i++) {
+            PyObject* offset = PyLong_FromLongLong((long long)scan.offsets[i]);
+            if (offset == NULL) {
+                FAILWITH(IERR_NO_MEMORY);
+            }
+            PyList_SET_ITEM(py_offsets, i, offset);
+        }
     }
-    pstream->limit = pstream->curr + size;
+    else {
+        py_offsets = Py_None;
+        Py_INCREF(py_offsets);
+    }
+    types = ionc_type_histogram_to_py(state, scan.type_counts);
+    type_bytes = ionc_type_histogram_to_py(state, scan.type_bytes);
+    if (types == NULL || type_bytes == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    result = Py_BuildValue("{s:n,s:n,s:O,s:O,s:n,s:O,s:O}", "values", scan.top_level_count,
+                           "total_values", scan.value_count, "types", types, "bytes", type_bytes,
+                           "max_depth", (Py_ssize_t)scan.max_depth, "error", py_error, "offsets", py_offsets);
 
 fail:
-    Py_XDECREF(py_buffer_as_bytes);
-    Py_XDECREF(py_buffer);
-    cRETURN;
+    if (reader != NULL) {
+        ion_reader_close(reader);
+    }
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    PyMem_Free(stream_handle.buffer);
+    PyMem_RawFree(scan.offsets);
+    Py_XDECREF(catalog);
+    Py_XDECREF(py_error);
+    Py_XDECREF(py_offsets);
+    Py_XDECREF(types);
+    Py_XDECREF(type_bytes);
+    if (err) {
+        if (!PyErr_Occurred()) {
+            PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        }
+        _err_msg[0] = '\0';
+        return NULL;
+    }
+    return result;
 }
 
-PyObject* ionc_read_iter_next(PyObject *self) {
-    iENTER;
-    ION_TYPE t;
-    ionc_read_Iterator *iterator = (ionc_read_Iterator*) self;
-    PyObject* container = NULL;
-    hREADER reader = iterator->reader;
+/******************************************************************************
+*       Benchmark harness                                                     *
+******************************************************************************/
 
-    if (iterator->closed) {
-        PyErr_SetNone(PyExc_StopIteration);
-        return NULL;
-    }
-    IONCHECK(ion_reader_next(reader, &t));
+#define IONC_BENCHMARK_PHASE_COUNT 4
 
-    if (t == tid_EOF) {
-        assert(t == tid_EOF && "next() at end");
+static const char* IONC_BENCHMARK_PHASE_NAMES[] = {"parse", "tape", "materialize", "serialize"};
 
-        IONCHECK(ion_reader_close(reader));
-        PyErr_SetNone(PyExc_StopIteration);
-        iterator->closed = TRUE;
-        return NULL;
+typedef struct {
+    uint64_t nanos;
+    uint64_t cycles;
+    Py_ssize_t allocations;
+    Py_ssize_t allocated_bytes;
+} _IONC_BENCHMARK_PHASE;
+
+/*
+ *  The allocators in place of which the counting hooks are installed, one per PyMem domain. The hooks pass every call
+ *  through, so memory allocated on either side of a measured phase may be freed on the other. They are installed while
+ *  any thread is running a benchmark (_ionc_benchmark_hooks of them, which is only touched with the GIL held and
+ *  _ionc_benchmark_hooks_mutex).
+ *
+ *  The passes release the GIL in places, and the raw domain is called without it, so the hooks run on other threads
+ *  too. Only the calls of a thread that is measuring a phase are counted, in counters of its own.
+ */
+static PyMemAllocatorEx _ionc_benchmark_allocators[3];
+static const PyMemAllocatorDomain _ionc_benchmark_domains[] = {PYMEM_DOMAIN_RAW, PYMEM_DOMAIN_MEM, PYMEM_DOMAIN_OBJ};
+static int _ionc_benchmark_hooks;
+static _IONC_MUTEX _ionc_benchmark_hooks_mutex;
+static IONC_THREAD_LOCAL BOOL _ionc_benchmark_counting;
+static IONC_THREAD_LOCAL Py_ssize_t _ionc_benchmark_allocations;
+static IONC_THREAD_LOCAL Py_ssize_t _ionc_benchmark_allocated_bytes;
+
+#define IONC_BENCHMARK_COUNT(size) { \
+    if (_ionc_benchmark_counting) { \
+        _ionc_benchmark_allocations++; \
+        _ionc_benchmark_allocated_bytes += (size); \
+    } \
+}
+
+static void* ionc_benchmark_malloc(void* ctx, size_t size) {
+    PyMemAllocatorEx* allocator = (PyMemAllocatorEx*)ctx;
+    IONC_BENCHMARK_COUNT(size);
+    return allocator->malloc(allocator->ctx, size);
+}
+
+static void* ionc_benchmark_calloc(void* ctx, size_t nelem, size_t elsize) {
+    PyMemAllocatorEx* allocator = (PyMemAllocatorEx*)ctx;
+    IONC_BENCHMARK_COUNT(nelem * elsize);
+    return allocator->calloc(allocator->ctx, nelem, elsize);
+}
+
+static void* ionc_benchmark_realloc(void* ctx, void* ptr, size_t new_size) {
+    PyMemAllocatorEx* allocator = (PyMemAllocatorEx*)ctx;
+    // A growing buffer pays for a trip to the allocator on every realloc, so each one is counted.
+    IONC_BENCHMARK_COUNT(new_size);
+    return allocator->realloc(allocator->ctx, ptr, new_size);
+}
+
+static void ionc_benchmark_free(void* ctx, void* ptr) {
+    PyMemAllocatorEx* allocator = (PyMemAllocatorEx*)ctx;
+    allocator->free(allocator->ctx, ptr);
+}
+
+static void ionc_benchmark_hook_allocators(void) {
+    int i;
+    IONC_LOCK(_ionc_benchmark_hooks_mutex);
+    if (_ionc_benchmark_hooks++ == 0) {
+        for (i = 0; i < 3; i++) {
+            PyMemAllocatorEx hook = {&_ionc_benchmark_allocators[i], ionc_benchmark_malloc, ionc_benchmark_calloc,
+                                     ionc_benchmark_realloc, ionc_benchmark_free};
+            PyMem_GetAllocator(_ionc_benchmark_domains[i], &_ionc_benchmark_allocators[i]);
+            PyMem_SetAllocator(_ionc_benchmark_domains[i], &hook);
+        }
     }
+    IONC_UNLOCK(_ionc_benchmark_hooks_mutex);
+}
 
-    container = PyList_New(0);
-    IONCHECK(ionc_read_value(reader, t, container, FALSE, iterator->value_model));
-    Py_ssize_t len = PyList_Size(container);
-    if (len != 1) {
-        _FAILWITHMSG(IERR_INVALID_ARG, "assertion failed: len == 1");
+static void ionc_benchmark_unhook_allocators(void) {
+    int i;
+    IONC_LOCK(_ionc_benchmark_hooks_mutex);
+    if (--_ionc_benchmark_hooks == 0) {
+        for (i = 0; i < 3; i++) {
+            PyMem_SetAllocator(_ionc_benchmark_domains[i], &_ionc_benchmark_allocators[i]);
+        }
     }
+    IONC_UNLOCK(_ionc_benchmark_hooks_mutex);
+}
 
-    PyObject* value = PyList_GetItem(container, 0);
-    Py_XINCREF(value);
-    Py_DECREF(container);
+static uint64_t ionc_benchmark_cycles(void) {
+#if IONC_CYCLE_COUNTER_SUPPORTED
+    // The time stamp counter ticks at the nominal frequency, regardless of frequency scaling.
+    return (uint64_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
 
-    return value;
+static void ionc_benchmark_phase_start(_IONC_BENCHMARK_PHASE* phase) {
+    _ionc_benchmark_allocations = 0;
+    _ionc_benchmark_allocated_bytes = 0;
+    _ionc_benchmark_counting = TRUE;
+    phase->cycles = ionc_benchmark_cycles();
+    phase->nanos = ionc_nanos();
+}
+
+static void ionc_benchmark_phase_stop(_IONC_BENCHMARK_PHASE* phase) {
+    phase->nanos = ionc_nanos() - phase->nanos;
+    phase->cycles = ionc_benchmark_cycles() - phase->cycles;
+    _ionc_benchmark_counting = FALSE;
+    phase->allocations = _ionc_benchmark_allocations;
+    phase->allocated_bytes = _ionc_benchmark_allocated_bytes;
+}
+
+static iERR ionc_benchmark_parse(_IONC_MODULE_STATE* state, Py_buffer* buffer, Py_ssize_t* value_count) {
+    iENTER;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    ION_READER_OPTIONS options;
+    decContext read_dec_context = state->dec_context;
+    _IONC_SCAN scan;
+
+    memset(&options, 0, sizeof(options));
+    options.decimal_context = &read_dec_context;
+    IONCHECK(ionc_reader_open_pinned(state, &reader, buffer, &pinned_stream, &options));
+    memset(&scan, 0, sizeof(scan));
+    scan.validate = TRUE;
+    scan.previous_type = -1;
+    err = ionc_scan_walk(reader, &scan, 0, FALSE);
+    *value_count = scan.value_count;
+    IONCHECK(err);
 
 fail:
-    Py_XDECREF(container);
-    PyObject* exception = PyErr_Format(_ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
-    _err_msg[0] = '\0';
-    return exception;
+    if (reader != NULL) {
+        iERR close_err = ion_reader_close(reader);
+        if (!err) err = close_err;
+    }
+    cRETURN;
 }
 
-PyObject* ionc_read_iter(PyObject *self) {
-    Py_INCREF(self);
-    return self;
+/*
+ *  Reads all of 'buffer' onto a fresh 'tape', which the caller frees.
+ */
+static iERR ionc_benchmark_read_tape(_IONC_MODULE_STATE* state, Py_buffer* buffer, _ION_TAPE* tape) {
+    iENTER;
+    hREADER reader = NULL;
+    _ION_PINNED_STREAM pinned_stream;
+    ION_READER_OPTIONS options;
+
+    memset(&options, 0, sizeof(options));
+    memset(tape, 0, sizeof(_ION_TAPE));
+    tape->dec_context = state->dec_context;
+    options.decimal_context = &tape->dec_context;
+    IONCHECK(ionc_reader_open_pinned(state, &reader, buffer, &pinned_stream, &options));
+    IONCHECK(ionc_tape_read_all(reader, tape, FALSE));
+
+fail:
+    if (reader != NULL) {
+        iERR close_err = ion_reader_close(reader);
+        if (!err) err = close_err;
+    }
+    cRETURN;
 }
 
-void ionc_read_iter_dealloc(PyObject *self) {
-    ionc_read_Iterator *iterator = (ionc_read_Iterator*) self;
-    if (!iterator->closed) {
-        ion_reader_close(iterator->reader);
-        iterator->closed = TRUE;
+/*
+ *  Builds the Python values of a whole 'tape' into a new list, as ionc_read_buffer does.
+ */
+static iERR ionc_benchmark_materialize(_ION_TAPE* tape, PyObject** values_out) {
+    iENTER;
+    Py_ssize_t pos = 0;
+    PyObject* values = PyList_New(0);
+    _ION_READ_CONTEXT* context = (_ION_READ_CONTEXT*)PyMem_Calloc(1, sizeof(_ION_READ_CONTEXT));
+    if (values == NULL || context == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
     }
-    Py_DECREF(iterator->file_handler_state.py_file);
-    PyObject_Del(self);
+    IONCHECK(ionc_tape_build_all(tape, &pos, tape->node_count, values, LIST, context));
+    *values_out = values;
+    values = NULL;
+
+fail:
+    if (context != NULL) {
+        ionc_symbol_cache_clear(context);
+        PyMem_Free(context);
+    }
+    Py_XDECREF(values);
+    cRETURN;
+}
+
+static PyObject* ionc_benchmark_phase_to_py(_IONC_BENCHMARK_PHASE* phase) {
+    PyObject* cycles;
+    if (IONC_CYCLE_COUNTER_SUPPORTED) {
+        cycles = PyLong_FromUnsignedLongLong(phase->cycles);
+    }
+    else {
+        cycles = Py_None;
+        Py_INCREF(cycles);
+    }
+    if (cycles == NULL) {
+        return NULL;
+    }
+    return Py_BuildValue("{s:K,s:N,s:n,s:n}", "nanos", (unsigned long long)phase->nanos, "cycles", cycles,
+                         "allocations", phase->allocations, "allocated_bytes", phase->allocated_bytes);
 }
 
 /*
- *  Entry point of read/load functions
+ *  Times the passes a load/dump round trip of 'data' is made of, each for 'iterations' runs: the ion-c parse on its
+ *  own, the read of the values onto a tape, the materialization of the Python values from the last tape read, and
+ *  their serialization (ionc_write). Together the tape and materialize passes are what ionc_read_buffer does. Unlike
+ *  timing simpleion.loads from Python, this separates the cost of ion-c from the cost of the Python objects, and counts
+ *  the allocations each pass makes through the PyMem allocators. ion-c allocates through malloc, so the parse pass
+ *  only reports the allocations this module makes on its behalf.
+ *
+ *  The parse, tape and materialize passes hold the GIL; serialization releases it while the writer closes. Only the
+ *  allocations of the calling thread are counted, whether or not it holds the GIL.
  */
-PyObject* ionc_read(PyObject* self, PyObject *args, PyObject *kwds) {
+PyObject* ionc_benchmark(PyObject* self, PyObject *args, PyObject *kwds) {
     iENTER;
-    PyObject *py_file = NULL; // TextIOWrapper
-    uint8_t value_model = 0;
-    PyObject *text_buffer_size_limit;
-    ionc_read_Iterator *iterator = NULL;
-    static char *kwlist[] = {"file", "value_model", "text_buffer_size_limit", NULL};
-    // todo: this could be simpler and likely faster by converting to c types here.
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, IONC_READ_ARGS_FORMAT, kwlist, &py_file,
-                                     &value_model, &text_buffer_size_limit)) {
-        FAILWITH(IERR_INVALID_ARG);
+    _IONC_MODULE_STATE* state = ionc_module_state(self);
+    Py_buffer buffer;
+    Py_ssize_t iterations = 1, i, value_count = 0, parsed_count;
+    PyObject *binary = Py_True, *write_args = NULL, *values = NULL, *written = NULL;
+    PyObject *result = NULL, *py_phase;
+    _IONC_BENCHMARK_PHASE phases[IONC_BENCHMARK_PHASE_COUNT];
+    _ION_TAPE tape;
+    BOOL hooked = FALSE;
+    static char *kwlist[] = {"data", "iterations", "binary", NULL};
+
+    buffer.obj = NULL;
+    memset(phases, 0, sizeof(phases));
+    memset(&tape, 0, sizeof(tape));
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|nO", kwlist, &buffer, &iterations, &binary)) {
+        return NULL;
     }
-    iterator = PyObject_New(ionc_read_Iterator, &ionc_read_IteratorType);
-    if (!iterator) {
-        FAILWITH(IERR_INTERNAL_ERROR);
+    if (iterations < 1) {
+        _FAILWITHMSG(IERR_INVALID_ARG, "iterations must be at least 1.");
     }
-    Py_INCREF(py_file);
+    ionc_benchmark_hook_allocators();
+    hooked = TRUE;
 
-    if (!PyObject_Init((PyObject*) iterator, &ionc_read_IteratorType)) {
-        FAILWITH(IERR_INTERNAL_ERROR);
+    ionc_benchmark_phase_start(&phases[0]);
+    for (i = 0; i < iterations && !err; i++) {
+        parsed_count = 0;
+        err = ionc_benchmark_parse(state, &buffer, &parsed_count);
     }
+    ionc_benchmark_phase_stop(&phases[0]);
+    IONCHECK(err);
+    value_count = parsed_count;
 
-    iterator->closed = FALSE;
-    iterator->file_handler_state.py_file = py_file;
-    iterator->value_model = value_model;
-    memset(&iterator->reader, 0, sizeof(iterator->reader));
-    memset(&iterator->_reader_options, 0, sizeof(iterator->_reader_options));
-    iterator->_reader_options.decimal_context = &dec_context;
-    if (text_buffer_size_limit != Py_None) {
-        int symbol_threshold = PyLong_AsLong(text_buffer_size_limit);
-        iterator->_reader_options.symbol_threshold = symbol_threshold;
+    ionc_benchmark_phase_start(&phases[1]);
+    for (i = 0; i < iterations && !err; i++) {
+        ionc_tape_free(&tape);
+        err = ionc_benchmark_read_tape(state, &buffer, &tape);
     }
+    ionc_benchmark_phase_stop(&phases[1]);
+    IONCHECK(err);
 
-    IONCHECK(ion_reader_open_stream(
-        &iterator->reader,
-        &iterator->file_handler_state,
-        ion_read_file_stream_handler,
-        &iterator->_reader_options)); // NULL represents default reader options
-    return iterator;
+    ionc_benchmark_phase_start(&phases[2]);
+    for (i = 0; i < iterations && !err; i++) {
+        Py_CLEAR(values);
+        err = ionc_benchmark_materialize(&tape, &values);
+    }
+    ionc_benchmark_phase_stop(&phases[2]);
+    IONCHECK(err);
+
+    // The last materialized values are serialized, as the write API would be handed them.
+    write_args = Py_BuildValue("(OOOO)", values, binary, Py_True, Py_False);
+    if (write_args == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    ionc_benchmark_phase_start(&phases[3]);
+    for (i = 0; i < iterations; i++) {
+        Py_XDECREF(written);
+        written = ionc_write(self, write_args, NULL);
+        if (written == NULL) break;
+    }
+    ionc_benchmark_phase_stop(&phases[3]);
+    if (written == NULL) {
+        goto fail;
+    }
+
+    result = Py_BuildValue("{s:n,s:n,s:n,s:O}", "bytes", buffer.len, "values", value_count,
+                           "iterations", iterations, "cycle_counter",
+                           IONC_CYCLE_COUNTER_SUPPORTED ? Py_True : Py_False);
+    if (result == NULL) {
+        FAILWITH(IERR_NO_MEMORY);
+    }
+    for (i = 0; i < IONC_BENCHMARK_PHASE_COUNT; i++) {
+        py_phase = ionc_benchmark_phase_to_py(&phases[i]);
+        if (py_phase == NULL || PyDict_SetItemString(result, IONC_BENCHMARK_PHASE_NAMES[i], py_phase) < 0) {
+            Py_XDECREF(py_phase);
+            FAILWITH(IERR_NO_MEMORY);
+        }
+        Py_DECREF(py_phase);
+    }
 
 fail:
-    if (iterator != NULL) {
-        Py_DECREF(py_file);
+    if (hooked) {
+        ionc_benchmark_unhook_allocators();
     }
-    Py_XDECREF(iterator);
-    PyObject* exception = PyErr_Format(_ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
-    _err_msg[0] = '\0';
-    return exception;
+    ionc_tape_free(&tape);
+    Py_XDECREF(write_args);
+    Py_XDECREF(values);
+    Py_XDECREF(written);
+    if (buffer.obj != NULL) {
+        PyBuffer_Release(&buffer);
+    }
+    if (err) {
+        Py_XDECREF(result);
+        PyObject* exception = PyErr_Format(state->ion_exception_cls, "%s %s", ion_error_to_str(err), _err_msg);
+        _err_msg[0] = '\0';
+        return exception;
+    }
+    if (result == NULL && !PyErr_Occurred()) {
+        PyErr_SetString(PyExc_RuntimeError, "Benchmark failed.");
+    }
+    return result;
 }
 
 /******************************************************************************
@@ -1535,134 +6752,264 @@ static char ioncmodule_docs[] =
 static PyMethodDef ioncmodule_funcs[] = {
     {"ionc_write", (PyCFunction)ionc_write, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
     {"ionc_read", (PyCFunction)ionc_read, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_read_buffer", (PyCFunction)ionc_read_buffer, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_split_binary", (PyCFunction)ionc_split_binary, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_scan_binary", (PyCFunction)ionc_scan_binary, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_read_columns", (PyCFunction)ionc_read_columns, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_transcode", (PyCFunction)ionc_transcode, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_to_json", (PyCFunction)ionc_to_json, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_scan", (PyCFunction)ionc_scan, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_stats_enable", (PyCFunction)ionc_stats_enable, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_stats", (PyCFunction)ionc_stats, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_benchmark", (PyCFunction)ionc_benchmark, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
+    {"ionc_set_max_buffer_len", (PyCFunction)ionc_set_max_buffer_len, METH_VARARGS | METH_KEYWORDS, ioncmodule_docs},
     {NULL}
 };
 
-static struct PyModuleDef moduledef = {
-    PyModuleDef_HEAD_INIT,
-    "ionc",             /* m_name */
-    ioncmodule_docs,    /* m_doc */
-    -1,                 /* m_size */
-    ioncmodule_funcs,   /* m_methods */
-    NULL,               /* m_reload */
-    NULL,               /* m_traverse */
-    NULL,               /* m_clear*/
-    NULL,               /* m_free */
-};
+/*
+ *  Creates one of the module's types from its spec, as a type of the module 'm'.
+ */
+static PyObject* ionc_type_from_spec(PyObject* m, PyType_Spec* spec) {
+#if PY_VERSION_HEX >= 0x03090000
+    PyObject* type = PyType_FromModuleAndSpec(m, spec, NULL);
+#else
+    PyObject* type = PyType_FromSpec(spec);
+#endif
+    return type;
+}
+
+/*
+ *  Fills the state of the module 'm': creates its types, imports the classes, and creates the strings and decimal
+ *  context template that its reads and writes share.
+ */
+static int ionc_module_state_init(PyObject* m, _IONC_MODULE_STATE* state) {
+    PyObject *decimal_module, *simpletypes_module, *ion_core_module, *ion_symbols_module, *exception_module;
+    PyObject *py_timestamp_precision, *py_ion_type;
+
+    state->writer_type = ionc_type_from_spec(m, &ionc_writer_spec);
+    state->read_iterator_type = ionc_type_from_spec(m, &ionc_read_iterator_spec);
+    state->lazy_tape_type = ionc_type_from_spec(m, &ionc_lazy_tape_spec);
+    state->column_type = ionc_type_from_spec(m, &ionc_column_spec);
+    if (state->writer_type == NULL || state->read_iterator_type == NULL || state->lazy_tape_type == NULL
+            || state->column_type == NULL) {
+        return -1;
+    }
+#ifndef Py_TPFLAGS_DISALLOW_INSTANTIATION
+    ((PyTypeObject*)state->read_iterator_type)->tp_new = NULL;
+    ((PyTypeObject*)state->lazy_tape_type)->tp_new = NULL;
+    ((PyTypeObject*)state->column_type)->tp_new = NULL;
+#endif
+#if PY_VERSION_HEX < 0x03090000
+    ((PyTypeObject*)state->column_type)->tp_as_buffer->bf_getbuffer = ionc_column_getbuffer;
+#endif
+
+    decimal_module = PyImport_ImportModule("decimal");
+    if (decimal_module == NULL) {
+        return -1;
+    }
+    state->decimal_constructor = PyObject_GetAttrString(decimal_module, "Decimal");
+    Py_DECREF(decimal_module);
+    if (state->decimal_constructor == NULL) {
+        return -1;
+    }
+    state->decimal_zero = PyObject_CallFunction(state->decimal_constructor, "i", 0, NULL);
+
+    simpletypes_module = PyImport_ImportModule("amazon.ion.simple_types");
+    if (simpletypes_module == NULL) {
+        return -1;
+    }
+    state->ionpynull_cls              = PyObject_GetAttrString(simpletypes_module, "IonPyNull");
+    state->ionpybool_cls              = PyObject_GetAttrString(simpletypes_module, "IonPyBool");
+    state->ionpyint_cls               = PyObject_GetAttrString(simpletypes_module, "IonPyInt");
+    state->ionpyfloat_cls             = PyObject_GetAttrString(simpletypes_module, "IonPyFloat");
+    state->ionpydecimal_cls           = PyObject_GetAttrString(simpletypes_module, "IonPyDecimal");
+    state->ionpytimestamp_cls         = PyObject_GetAttrString(simpletypes_module, "IonPyTimestamp");
+    state->ionpybytes_cls             = PyObject_GetAttrString(simpletypes_module, "IonPyBytes");
+    state->ionpytext_cls              = PyObject_GetAttrString(simpletypes_module, "IonPyText");
+    state->ionpysymbol_cls            = PyObject_GetAttrString(simpletypes_module, "IonPySymbol");
+    state->ionpylist_cls              = PyObject_GetAttrString(simpletypes_module, "IonPyList");
+    state->ionpydict_cls              = PyObject_GetAttrString(simpletypes_module, "IonPyDict");
+    state->ionpystddict_cls           = PyObject_GetAttrString(simpletypes_module, "IonPyStdDict");
+    state->ionpylazydict_cls          = PyObject_GetAttrString(simpletypes_module, "IonPyLazyDict");
+    state->ionpylazylist_cls          = PyObject_GetAttrString(simpletypes_module, "IonPyLazyList");
+    Py_DECREF(simpletypes_module);
+    if (state->ionpytimestamp_cls == NULL) {
+        return -1;
+    }
+    state->ionpytimestamp_fromvalue   = PyObject_GetAttrString(state->ionpytimestamp_cls, "from_value");
 
-PyObject* ionc_init_module(void) {
+    ion_core_module = PyImport_ImportModule("amazon.ion.core");
+    if (ion_core_module == NULL) {
+        return -1;
+    }
+    py_timestamp_precision            = PyObject_GetAttrString(ion_core_module, "TimestampPrecision");
+    state->py_timestamp_cls           = PyObject_GetAttrString(ion_core_module, "Timestamp");
+    py_ion_type                       = PyObject_GetAttrString(ion_core_module, "IonType");
+    Py_DECREF(ion_core_module);
+    if (py_timestamp_precision == NULL || py_ion_type == NULL) {
+        Py_XDECREF(py_timestamp_precision);
+        Py_XDECREF(py_ion_type);
+        return -1;
+    }
+
+    ion_symbols_module = PyImport_ImportModule("amazon.ion.symbols");
+    if (ion_symbols_module != NULL) {
+        state->py_symboltoken_constructor = PyObject_GetAttrString(ion_symbols_module, "SymbolToken");
+        Py_DECREF(ion_symbols_module);
+    }
+
+    state->py_ion_type_table[0x0] = PyObject_GetAttrString(py_ion_type, "NULL");
+    state->py_ion_type_table[0x1] = PyObject_GetAttrString(py_ion_type, "BOOL");
+    state->py_ion_type_table[0x2] = PyObject_GetAttrString(py_ion_type, "INT");
+    state->py_ion_type_table[0x3] = PyObject_GetAttrString(py_ion_type, "INT");
+    state->py_ion_type_table[0x4] = PyObject_GetAttrString(py_ion_type, "FLOAT");
+    state->py_ion_type_table[0x5] = PyObject_GetAttrString(py_ion_type, "DECIMAL");
+    state->py_ion_type_table[0x6] = PyObject_GetAttrString(py_ion_type, "TIMESTAMP");
+    state->py_ion_type_table[0x7] = PyObject_GetAttrString(py_ion_type, "SYMBOL");
+    state->py_ion_type_table[0x8] = PyObject_GetAttrString(py_ion_type, "STRING");
+    state->py_ion_type_table[0x9] = PyObject_GetAttrString(py_ion_type, "CLOB");
+    state->py_ion_type_table[0xA] = PyObject_GetAttrString(py_ion_type, "BLOB");
+    state->py_ion_type_table[0xB] = PyObject_GetAttrString(py_ion_type, "LIST");
+    state->py_ion_type_table[0xC] = PyObject_GetAttrString(py_ion_type, "SEXP");
+    state->py_ion_type_table[0xD] = PyObject_GetAttrString(py_ion_type, "STRUCT");
+    Py_DECREF(py_ion_type);
+
+    state->py_ion_timestamp_precision_table[0] = PyObject_GetAttrString(py_timestamp_precision, "YEAR");
+    state->py_ion_timestamp_precision_table[1] = PyObject_GetAttrString(py_timestamp_precision, "MONTH");
+    state->py_ion_timestamp_precision_table[2] = PyObject_GetAttrString(py_timestamp_precision, "DAY");
+    state->py_ion_timestamp_precision_table[3] = NULL; // Impossible; there is no hour precision.
+    state->py_ion_timestamp_precision_table[4] = PyObject_GetAttrString(py_timestamp_precision, "MINUTE");
+    state->py_ion_timestamp_precision_table[5] = PyObject_GetAttrString(py_timestamp_precision, "SECOND");
+    state->py_ion_timestamp_precision_table[6] = PyObject_GetAttrString(py_timestamp_precision, "SECOND");
+    Py_DECREF(py_timestamp_precision);
+
+    exception_module = PyImport_ImportModule("amazon.ion.exceptions");
+    if (exception_module != NULL) {
+        state->ion_exception_cls = PyObject_GetAttrString(exception_module, "IonException");
+        Py_DECREF(exception_module);
+    }
+
+    decContextDefault(&state->dec_context, DEC_INIT_DECQUAD);  //The writer already had one of these, but it's private.
+    state->dec_context.digits = 10000;
+    state->dec_context.emax = DEC_MAX_MATH;
+    state->dec_context.emin = -DEC_MAX_MATH;
+    state->max_buffer_len = INT32_MAX;
+    state->ion_type_str = PyUnicode_FromString("ion_type");
+    state->ion_annotations_str = PyUnicode_FromString("ion_annotations");
+    state->text_str = PyUnicode_FromString("text");
+    state->sid_str = PyUnicode_FromString("sid");
+    state->precision_str = PyUnicode_FromString("precision");
+    state->fractional_seconds_str = PyUnicode_FromString("fractional_seconds");
+    state->exponent_str = PyUnicode_FromString("exponent");
+    state->digits_str = PyUnicode_FromString("digits");
+    state->fractional_precision_str = PyUnicode_FromString("fractional_precision");
+    state->store_str = PyUnicode_FromString("_IonPyDict__store");
+    state->write_str = PyUnicode_FromString("write");
+    state->name_str = PyUnicode_FromString("name");
+    state->empty_tuple = PyTuple_New(0);
+    state->version_str = PyUnicode_FromString("version");
+    state->ionc_catalog_str = PyUnicode_FromString("_ionc_catalog");
+    state->tape_str = PyUnicode_FromString("_tape");
+    state->tape_index_str = PyUnicode_FromString("_tape_index");
+    state->readinto_str = PyUnicode_FromString("readinto");
+
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+    return 0;
+}
+
+int ionc_module_exec(PyObject* m) {
+    _IONC_MODULE_STATE* state = ionc_module_state(m);
     PyDateTime_IMPORT;
-    PyObject* m;
-
-    m = PyModule_Create(&moduledef);
-
-    IONC_STREAM_BYTES_READ_SIZE = PyLong_FromLong(IONC_STREAM_READ_BUFFER_SIZE/4);
-
-    // TODO is there a destructor for modules? these should be decreffed there
-    _decimal_module             = PyImport_ImportModule("decimal");
-    _decimal_constructor        = PyObject_GetAttrString(_decimal_module, "Decimal");
-    _decimal_zero               = PyObject_CallFunction(_decimal_constructor, "i", 0, NULL);
-    _simpletypes_module         = PyImport_ImportModule("amazon.ion.simple_types");
-
-    _ionpynull_cls              = PyObject_GetAttrString(_simpletypes_module, "IonPyNull");
-    _ionpybool_cls              = PyObject_GetAttrString(_simpletypes_module, "IonPyBool");
-    _ionpyint_cls               = PyObject_GetAttrString(_simpletypes_module, "IonPyInt");
-    _ionpyfloat_cls             = PyObject_GetAttrString(_simpletypes_module, "IonPyFloat");
-    _ionpydecimal_cls           = PyObject_GetAttrString(_simpletypes_module, "IonPyDecimal");
-    _ionpytimestamp_cls         = PyObject_GetAttrString(_simpletypes_module, "IonPyTimestamp");
-    _ionpybytes_cls             = PyObject_GetAttrString(_simpletypes_module, "IonPyBytes");
-    _ionpytext_cls              = PyObject_GetAttrString(_simpletypes_module, "IonPyText");
-    _ionpysymbol_cls            = PyObject_GetAttrString(_simpletypes_module, "IonPySymbol");
-    _ionpylist_cls              = PyObject_GetAttrString(_simpletypes_module, "IonPyList");
-    _ionpydict_cls              = PyObject_GetAttrString(_simpletypes_module, "IonPyDict");
-    _ionpystddict_cls           = PyObject_GetAttrString(_simpletypes_module, "IonPyStdDict");
-
-    _ionpynull_fromvalue        = PyObject_GetAttrString(_ionpynull_cls, "from_value");
-    _ionpybool_fromvalue        = PyObject_GetAttrString(_ionpybool_cls, "from_value");
-    _ionpyint_fromvalue         = PyObject_GetAttrString(_ionpyint_cls, "from_value");
-    _ionpyfloat_fromvalue       = PyObject_GetAttrString(_ionpyfloat_cls, "from_value");
-    _ionpydecimal_fromvalue     = PyObject_GetAttrString(_ionpydecimal_cls, "from_value");
-    _ionpytimestamp_fromvalue   = PyObject_GetAttrString(_ionpytimestamp_cls, "from_value");
-    _ionpybytes_fromvalue       = PyObject_GetAttrString(_ionpybytes_cls, "from_value");
-    _ionpytext_fromvalue        = PyObject_GetAttrString(_ionpytext_cls, "from_value");
-    _ionpysymbol_fromvalue      = PyObject_GetAttrString(_ionpysymbol_cls, "from_value");
-    _ionpylist_fromvalue        = PyObject_GetAttrString(_ionpylist_cls, "from_value");
-    _ionpylist_factory          = PyObject_GetAttrString(_ionpylist_cls, "_factory");
-    _ionpydict_factory          = PyObject_GetAttrString(_ionpydict_cls, "_factory");
-
-    _ion_core_module            = PyImport_ImportModule("amazon.ion.core");
-    _py_timestamp_precision     = PyObject_GetAttrString(_ion_core_module, "TimestampPrecision");
-    _py_timestamp_cls           = PyObject_GetAttrString(_ion_core_module, "Timestamp");
-    _py_timestamp__new__        = PyObject_GetAttrString(_py_timestamp_cls, "__new__");
-    _py_ion_type                = PyObject_GetAttrString(_ion_core_module, "IonType");
-
-    _ion_symbols_module         = PyImport_ImportModule("amazon.ion.symbols");
-    _py_symboltoken_constructor = PyObject_GetAttrString(_ion_symbols_module, "SymbolToken");
-
-    py_ion_type_table[0x0] = PyObject_GetAttrString(_py_ion_type, "NULL");
-    py_ion_type_table[0x1] = PyObject_GetAttrString(_py_ion_type, "BOOL");
-    py_ion_type_table[0x2] = PyObject_GetAttrString(_py_ion_type, "INT");
-    py_ion_type_table[0x3] = PyObject_GetAttrString(_py_ion_type, "INT");
-    py_ion_type_table[0x4] = PyObject_GetAttrString(_py_ion_type, "FLOAT");
-    py_ion_type_table[0x5] = PyObject_GetAttrString(_py_ion_type, "DECIMAL");
-    py_ion_type_table[0x6] = PyObject_GetAttrString(_py_ion_type, "TIMESTAMP");
-    py_ion_type_table[0x7] = PyObject_GetAttrString(_py_ion_type, "SYMBOL");
-    py_ion_type_table[0x8] = PyObject_GetAttrString(_py_ion_type, "STRING");
-    py_ion_type_table[0x9] = PyObject_GetAttrString(_py_ion_type, "CLOB");
-    py_ion_type_table[0xA] = PyObject_GetAttrString(_py_ion_type, "BLOB");
-    py_ion_type_table[0xB] = PyObject_GetAttrString(_py_ion_type, "LIST");
-    py_ion_type_table[0xC] = PyObject_GetAttrString(_py_ion_type, "SEXP");
-    py_ion_type_table[0xD] = PyObject_GetAttrString(_py_ion_type, "STRUCT");
-
-    c_ion_type_table[0x0] = tid_NULL_INT;
-    c_ion_type_table[0x1] = tid_BOOL_INT;
-    c_ion_type_table[0x2] = tid_INT_INT;
-    c_ion_type_table[0x3] = tid_FLOAT_INT;
-    c_ion_type_table[0x4] = tid_DECIMAL_INT;
-    c_ion_type_table[0x5] = tid_TIMESTAMP_INT;
-    c_ion_type_table[0x6] = tid_SYMBOL_INT;
-    c_ion_type_table[0x7] = tid_STRING_INT;
-    c_ion_type_table[0x8] = tid_CLOB_INT;
-    c_ion_type_table[0x9] = tid_BLOB_INT;
-    c_ion_type_table[0xA] = tid_LIST_INT;
-    c_ion_type_table[0xB] = tid_SEXP_INT;
-    c_ion_type_table[0xC] = tid_STRUCT_INT;
-
-    py_ion_timestamp_precision_table[0] = PyObject_GetAttrString(_py_timestamp_precision, "YEAR");
-    py_ion_timestamp_precision_table[1] = PyObject_GetAttrString(_py_timestamp_precision, "MONTH");
-    py_ion_timestamp_precision_table[2] = PyObject_GetAttrString(_py_timestamp_precision, "DAY");
-    py_ion_timestamp_precision_table[3] = NULL; // Impossible; there is no hour precision.
-    py_ion_timestamp_precision_table[4] = PyObject_GetAttrString(_py_timestamp_precision, "MINUTE");
-    py_ion_timestamp_precision_table[5] = PyObject_GetAttrString(_py_timestamp_precision, "SECOND");
-    py_ion_timestamp_precision_table[6] = PyObject_GetAttrString(_py_timestamp_precision, "SECOND");
-
-    _exception_module   = PyImport_ImportModule("amazon.ion.exceptions");
-    _ion_exception_cls  = PyObject_GetAttrString(_exception_module, "IonException");
-
-    decContextDefault(&dec_context, DEC_INIT_DECQUAD);  //The writer already had one of these, but it's private.
-    dec_context.digits = 10000;
-    dec_context.emax = DEC_MAX_MATH;
-    dec_context.emin = -DEC_MAX_MATH;
-    ion_type_str = PyUnicode_FromString("ion_type");
-    ion_annotations_str = PyUnicode_FromString("ion_annotations");
-    text_str = PyUnicode_FromString("text");
-    sid_str = PyUnicode_FromString("sid");
-    precision_str = PyUnicode_FromString("precision");
-    fractional_seconds_str = PyUnicode_FromString("fractional_seconds");
-    exponent_str = PyUnicode_FromString("exponent");
-    digits_str = PyUnicode_FromString("digits");
-    fractional_precision_str = PyUnicode_FromString("fractional_precision");
-    store_str = PyUnicode_FromString("_IonPyDict__store");
-
-    return m;
-}
-
-static PyObject* init_module(void) {
-    return ionc_init_module();
+    if (PyDateTimeAPI == NULL) {
+        return -1;
+    }
+#if PY_VERSION_HEX < 0x03090000
+    if (_ionc_module != NULL) {
+        PyErr_SetString(PyExc_ImportError, "Before Python 3.9 the C extension can only be loaded once per process.");
+        return -1;
+    }
+    _ionc_module = m;
+#endif
+    // On failure the module is freed, and ionc_module_free releases whatever was already created.
+    if (ionc_module_state_init(m, state) < 0) {
+        return -1;
+    }
+    Py_INCREF(state->writer_type);
+    if (PyModule_AddObject(m, "Writer", state->writer_type) < 0) {
+        Py_DECREF(state->writer_type);
+        return -1;
+    }
+    // Whether ionc_read and ionc_write accept a compression.
+    if (PyModule_AddIntConstant(m, "IONC_ZLIB", IONC_ZLIB_SUPPORTED) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static int ionc_module_traverse(PyObject* m, visitproc visit, void* arg) {
+    _IONC_MODULE_STATE* state = ionc_module_state(m);
+    size_t i;
+    if (state == NULL) {
+        return 0;
+    }
+    for (i = 0; i < IONC_MODULE_STATE_OBJECT_COUNT; i++) {
+        Py_VISIT(((PyObject**)state)[i]);
+    }
+    return 0;
+}
+
+static int ionc_module_clear(PyObject* m) {
+    _IONC_MODULE_STATE* state = ionc_module_state(m);
+    size_t i;
+    if (state == NULL) {
+        return 0;
+    }
+    for (i = 0; i < IONC_MODULE_STATE_OBJECT_COUNT; i++) {
+        Py_CLEAR(((PyObject**)state)[i]);
+    }
+    return 0;
+}
+
+static void ionc_module_free(void* m) {
+    ionc_module_clear((PyObject*)m);
+#if PY_VERSION_HEX < 0x03090000
+    if (_ionc_module == (PyObject*)m) {
+        _ionc_module = NULL;
+    }
+#endif
 }
 
+static PyModuleDef_Slot ioncmodule_slots[] = {
+    {Py_mod_exec, ionc_module_exec},
+#if PY_VERSION_HEX >= 0x030C0000
+    // Each interpreter gets its own instance of the module and its state. They still share the GIL, because the
+    // allocator hooks ionc_benchmark installs with PyMem_SetAllocator are process-wide.
+    {Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED},
+#endif
+#ifdef Py_mod_gil
+    // The state that is changed after exec, and the Writer, iterator and LazyTape objects, are guarded by their
+    // mutexes, see IONC_LOCK.
+    {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+    {0, NULL}
+};
+
+static struct PyModuleDef moduledef = {
+    PyModuleDef_HEAD_INIT,
+    "ionc",                         /* m_name */
+    ioncmodule_docs,                /* m_doc */
+    sizeof(_IONC_MODULE_STATE),     /* m_size */
+    ioncmodule_funcs,               /* m_methods */
+    ioncmodule_slots,               /* m_slots */
+    ionc_module_traverse,           /* m_traverse */
+    ionc_module_clear,              /* m_clear*/
+    ionc_module_free,               /* m_free */
+};
+
 PyMODINIT_FUNC
 PyInit_ionc(void)
 {
-    return init_module();
+    return PyModuleDef_Init(&moduledef);
 }
@@ -12,15 +12,22 @@
 # specific language governing permissions and limitations under the
 # License.
 
+from . import simpleion
 from .core import IonType
 from .simple_types import IonPyList, IonPyDict, IonPyNull, IonPyBool, IonPyInt, IonPyFloat, IonPyDecimal, \
     IonPyTimestamp, IonPyText, IonPyBytes, IonPySymbol
 from base64 import standard_b64encode
+import json
 import sys
 if hasattr(sys, "pypy_version_info"):
     raise ImportError("The json_encoder module is not supported for use with PyPy.")
 from jsonconversion.encoder import JSONExtendedEncoder
 
+try:
+    import amazon.ion.ionc as _ionc
+except ImportError:
+    _ionc = None
+
 
 class IonToJSONEncoder(JSONExtendedEncoder):
     """JSON Encoder for Ion value types. Used in the json.dumps method as the cls parameter to support JSON encoding of
@@ -66,3 +73,25 @@ class IonToJSONEncoder(JSONExtendedEncoder):
             return float(o)
         else:
             super(IonToJSONEncoder, self).default(o)
+
+
+def ion_to_json(data, single_value=True, catalog=None):
+    """Down-convert Ion to JSON text, as ``json.dumps(simpleion.loads(data), cls=IonToJSONEncoder)`` would.
+
+    With the C extension the JSON is written straight from the Ion reader, without creating a Python object per
+    value. Either way, of the fields of a struct with the same name only the last value is written, at the position of
+    the first.
+
+    Args:
+        data (Union[bytes|str]): The text or binary Ion to convert.
+        single_value (Optional[True|False]): When True, ``data`` must hold no more than one top-level value, which is
+            converted on its own. When False, the top-level values are converted as a JSON array. Default: True.
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
+    Returns (str):
+        The JSON text.
+    """
+    if isinstance(data, str):
+        data = data.encode('utf-8')
+    if simpleion.c_ext and _ionc is not None:
+        return _ionc.ionc_to_json(data, single_value=single_value, catalog=catalog)
+    return json.dumps(simpleion.loads(data, catalog=catalog, single_value=single_value), cls=IonToJSONEncoder)
@@ -805,6 +805,86 @@ class IonPyDict(MutableMapping):
                         annotations=self.ion_annotations, depth=depth)
 
 
+class IonPyLazyDict(IonPyDict):
+    """
+    IonPyDict loaded with ``IonPyValueModel.LAZY``.
+
+    The values of a field are only decoded when the field is looked up with ``[]``, ``get`` or ``in``. Any other
+    use, including iterating over the items or changing the struct, first decodes every value, after which it
+    behaves exactly as an IonPyDict. Values that were already looked up are kept, so they are the same objects.
+    """
+    __name__ = 'IonPyLazyDict'
+    __qualname__ = 'IonPyLazyDict'
+
+    _tape = None  # the C extension's parsed values; None once this has been fully decoded
+    _tape_index = 0
+    _fields = None  # field name -> tape indexes of its values
+    _decoded = None  # tape index -> value, for the values looked up so far
+    _lazy_store = None
+
+    def _field_indexes(self):
+        if self._fields is None:
+            self._fields = self._tape.fields(self._tape_index)
+        return self._fields
+
+    def _decode(self, index):
+        if self._decoded is None:
+            self._decoded = {}
+        try:
+            return self._decoded[index]
+        except KeyError:
+            value = self._decoded[index] = self._tape.build(index)
+            return value
+
+    @property
+    def _IonPyDict__store(self):
+        if self._tape is not None:
+            self._lazy_store = {key: [self._decode(index) for index in indexes]
+                                for key, indexes in self._field_indexes().items()}
+            self._tape = self._fields = self._decoded = None
+        return self._lazy_store
+
+    @_IonPyDict__store.setter
+    def _IonPyDict__store(self, store):
+        self._lazy_store = store
+        self._tape = self._fields = self._decoded = None
+
+    def __getitem__(self, key):
+        if self._tape is None:
+            return super().__getitem__(key)
+        return self._decode(self._field_indexes()[key][-1])
+
+    def __contains__(self, key):
+        if self._tape is None:
+            return super().__contains__(key)
+        return key in self._field_indexes()
+
+    def __len__(self):
+        if self._tape is None:
+            return super().__len__()
+        return sum([len(indexes) for indexes in self._field_indexes().values()])
+
+    def __iter__(self):
+        if self._tape is None:
+            return super().__iter__()
+        return iter(list(self._field_indexes()))
+
+    def __getstate__(self):
+        self._IonPyDict__store  # the tape can't be pickled; decode everything it holds first
+        return self.__dict__
+
+
+class IonPyLazyList(IonPyList):
+    """
+    IonPyList loaded with ``IonPyValueModel.LAZY``.
+
+    The items are decoded with the list, so it is a fully filled list wherever it is used; only the structs in it are
+    again lazy.
+    """
+    __name__ = 'IonPyLazyList'
+    __qualname__ = 'IonPyLazyList'
+
+
 def is_null(value):
     """A mechanism to determine if a value is ``None`` or an Ion ``null``."""
     return value is None or isinstance(value, IonPyNull)
@@ -54,25 +54,35 @@ disabled as below:
     ``simpleion.c_ext = False``
 
 """
+import gzip
 import io
+import mmap
+import zlib
+from array import array
+import os
+import re
 import warnings
+from concurrent.futures import ThreadPoolExecutor
 from datetime import datetime
 from decimal import Decimal
 from enum import IntFlag
+from functools import partial
 from io import BytesIO, TextIOBase
+from itertools import chain, islice
 from types import GeneratorType
-from typing import Union
+from typing import NamedTuple, Optional, Union
 
 from amazon.ion.reader_text import text_reader
 from amazon.ion.writer_text import text_writer
 from .core import IonEvent, IonEventType, IonType, ION_STREAM_END_EVENT, Timestamp, ION_VERSION_MARKER_EVENT
 from .exceptions import IonException
-from .reader import blocking_reader, NEXT_EVENT
+from .reader import blocking_reader, read_data_event, NEXT_EVENT
 from .reader_binary import binary_reader
 from .reader_managed import managed_reader
 from .simple_types import IonPyList, IonPyDict, IonPyNull, IonPyBool, IonPyInt, IonPyFloat, IonPyDecimal, \
     IonPyTimestamp, IonPyText, IonPyBytes, IonPySymbol, is_null
 from .symbols import SymbolToken
+from .util import coroutine
 from .writer import blocking_writer
 from .writer_binary import binary_writer
 
@@ -95,7 +105,7 @@ c_ext = __IS_C_EXTENSION_SUPPORTED
 
 
 def dump(obj, fp, imports=None, binary=True, sequence_as_stream=False, indent=None,
-         tuple_as_sexp=False, omit_version_marker=False):
+         tuple_as_sexp=False, omit_version_marker=False, compression=None):
     """Serialize ``obj`` as an Ion formatted stream and write it to fp.
 
     The python object hierarchy is mapped to the Ion data model as described in the module pydoc.
@@ -121,17 +131,26 @@ def dump(obj, fp, imports=None, binary=True, sequence_as_stream=False, indent=No
         indent (Str): If binary is False and indent is a string, then members of containers will be pretty-printed with
             a newline followed by that string repeated for each level of nesting. None (the default) selects the most
             compact representation without any newlines. Example: to indent with four spaces per level of nesting,
-            use ``'    '``.
+            use ``'    '``. Any indent made only of whitespace is written natively when the C extension is enabled;
+            other indents are written by the pure-Python implementation.
         tuple_as_sexp (Optional[True|False]): When True, all tuple values will be written as Ion s-expressions.
             When False, all tuple values will be written as Ion lists. Default: False.
         omit_version_marker (Optional[True|False]): If binary is False and omit_version_marker is True, omits the
             Ion Version Marker ($ion_1_0) from the output.  Default: False.
+        compression (Optional[str]): ``'gzip'`` or ``'zlib'`` to compress the output, e.g. for a ``.10n.gz`` file.
+            The C extension compresses it natively as it is written, when it was built with zlib. Default: None.
 
     Returns None.
     """
-    if c_ext and __IS_C_EXTENSION_SUPPORTED and (imports is None and indent is None):
-        return dump_extension(obj, fp, binary=binary, sequence_as_stream=sequence_as_stream,
-                              tuple_as_sexp=tuple_as_sexp, omit_version_marker=omit_version_marker)
+    native_compression = compression is None or _native_compression(compression)
+    if c_ext and __IS_C_EXTENSION_SUPPORTED and (binary or _is_native_indent(indent)) and native_compression:
+        return dump_extension(obj, fp, imports=imports, binary=binary, sequence_as_stream=sequence_as_stream,
+                              indent=indent, tuple_as_sexp=tuple_as_sexp, omit_version_marker=omit_version_marker,
+                              compression=compression)
+    elif compression is not None:
+        return _dump_compressed(obj, fp, compression, imports=imports, binary=binary,
+                                sequence_as_stream=sequence_as_stream, indent=indent, tuple_as_sexp=tuple_as_sexp,
+                                omit_version_marker=omit_version_marker)
     else:
         return dump_python(obj, fp, imports=imports, binary=binary, sequence_as_stream=sequence_as_stream,
                            indent=indent,
@@ -146,6 +165,10 @@ def dumps(obj, imports=None, binary=True, sequence_as_stream=False,
          Union[str|bytes]: The string or binary representation of the data.  if ``binary=True``, this will be a
              ``bytes`` object, otherwise this will be a ``str`` object
     """
+    if c_ext and __IS_C_EXTENSION_SUPPORTED and (binary or _is_native_indent(indent)):
+        return dumps_extension(obj, imports=imports, binary=binary, sequence_as_stream=sequence_as_stream,
+                               indent=indent, tuple_as_sexp=tuple_as_sexp, omit_version_marker=omit_version_marker)
+
     ion_buffer = io.BytesIO()
 
     dump(obj, ion_buffer, imports=imports, sequence_as_stream=sequence_as_stream, binary=binary,
@@ -218,9 +241,26 @@ class IonPyValueModel(IntFlag):
     the IonPyDict is both the IonPy wrapper and the multi-map.
     """
 
+    LAZY = 8
+    """Containers will be proxies that decode their values only when accessed.
+
+    Structs are IonPyLazyDict and lists and sexps are IonPyLazyList, whatever
+    the other flags (except that STRUCT_AS_STD_DICT structs are still built in
+    full). A struct decodes just the values of the fields that are looked up
+    with ``[]``, ``get`` or ``in``; any other use decodes all of its values. A
+    list or sexp holds its items as soon as it is built, so that it is a real
+    list to everything that uses it, but the structs in it are again lazy, so
+    that subtrees under structs that are never touched are never built.
+
+    The whole stream is still parsed up front, without the GIL, and kept alive
+    by the proxies. NOTE: this option only has an effect when the C extension
+    is enabled.
+    """
+
 
 def load(fp, catalog=None, single_value=True, parse_eagerly=True,
-         text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY):
+         text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY, fields=None, read_size=None,
+         max_read_size=None, batch_size=None, compression=None):
     """Deserialize Ion values from ``fp``, a file-handle to an Ion stream, as Python object(s) using the
     conversion table described in the pydoc. Common examples are below, please refer to the
     [Ion Cookbook](https://amazon-ion.github.io/ion-docs/guides/cookbook.html) for detailed information.
@@ -239,10 +279,12 @@ def load(fp, catalog=None, single_value=True, parse_eagerly=True,
     Read an Ion value with 50k text_buffer_size_limit:
         ``simpleion.load(file_handle, text_buffer_size_limit=50000)``
 
+    Read only the ``id`` field and the ``c`` field of the ``b`` struct of a record:
+        ``simpleion.load(file_handle, fields=["id", "b.c"])``
+
     Args:
         fp: a file handle or other object that implements the buffer protocol.
         catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
-            NOTE: when present the pure python load is used, which will impact performance.
         single_value (Optional[True|False]): When True, the data in the ``fp`` is interpreted as a single Ion value,
             and will be returned without an enclosing container. If True and there are multiple top-level values in
             the Ion stream, IonException will be raised. NOTE: this means that when data is dumped using
@@ -255,32 +297,493 @@ def load(fp, catalog=None, single_value=True, parse_eagerly=True,
         value_model (IonPyValueModel): Controls the types of values that are emitted from load(s).
             Default: IonPyValueModel.ION_PY. See the IonPyValueModel class for more information.
             NOTE: this option only has an effect when the C extension is enabled (which is the default).
+        fields (Optional[Iterable[str]]): Paths of the struct fields to read, as dot-separated field names. The other
+            fields are left out of the structs that are loaded; with the C extension they are skipped without being
+            decoded. A path applies to the structs at the top level and inside lists and sexps along the way; values
+            that are not structs are loaded whole. Can't be combined with ``IonPyValueModel.LAZY``. Default: all fields.
+        read_size (Optional[int]): The number of bytes (characters for text files) the C extension asks ``fp`` for at
+            a time. Larger reads mean fewer calls to sources with a high per-call cost, like network streams.
+            Binary files with ``readinto`` are read straight into the C extension's buffer. Default: 32 KiB.
+        max_read_size (Optional[int]): When larger than ``read_size``, the read size doubles after each full read
+            that was faster than the previous one, up to this size, and settles once the throughput stops rising.
+        batch_size (Optional[int]): Used in conjunction with ``single_value=False`` and ``parse_eagerly=False`` to
+            iterate over lists of up to this many values rather than over the values, which the C extension fills in
+            a single call each. Default: None.
+        compression (Optional[str]): ``'gzip'`` or ``'zlib'`` when ``fp`` is compressed, e.g. a ``.10n.gz`` file or
+            the bytes of one; either format is detected from its header. The C extension decompresses it natively,
+            when it was built with zlib, asking ``fp`` for ``read_size`` compressed bytes at a time (default: 256 KiB).
+            Default: None.
     Returns (Any):
         if single_value is True:
             A Python object representing a single Ion value.
         else:
             A sequence of Python objects representing a stream of Ion values, may be a list or an iterator.
     """
-    if c_ext and __IS_C_EXTENSION_SUPPORTED and catalog is None:
-        return load_extension(fp, parse_eagerly=parse_eagerly, single_value=single_value,
-                              text_buffer_size_limit=text_buffer_size_limit, value_model=value_model)
+    if compression is not None:
+        if _native_compression(compression) and not value_model & IonPyValueModel.LAZY:
+            return load_extension(fp, catalog=catalog, parse_eagerly=parse_eagerly, single_value=single_value,
+                                  text_buffer_size_limit=text_buffer_size_limit, value_model=value_model,
+                                  fields=fields, read_size=read_size, batch_size=batch_size, compression=compression)
+        fp = _decompressing_reader(fp, compression)
+    if c_ext and __IS_C_EXTENSION_SUPPORTED and value_model & IonPyValueModel.LAZY:
+        # Lazy containers decode from the parsed buffer, so the whole stream is read up front.
+        return loads(fp.read(), catalog=catalog, single_value=single_value, parse_eagerly=parse_eagerly,
+                     text_buffer_size_limit=text_buffer_size_limit, value_model=value_model, fields=fields,
+                     batch_size=batch_size)
+    if c_ext and __IS_C_EXTENSION_SUPPORTED:
+        return load_extension(fp, catalog=catalog, parse_eagerly=parse_eagerly, single_value=single_value,
+                              text_buffer_size_limit=text_buffer_size_limit, value_model=value_model, fields=fields,
+                              read_size=read_size, max_read_size=max_read_size, batch_size=batch_size)
     else:
-        return load_python(fp, catalog=catalog, single_value=single_value, parse_eagerly=parse_eagerly)
+        return load_python(fp, catalog=catalog, single_value=single_value, parse_eagerly=parse_eagerly, fields=fields,
+                           batch_size=batch_size)
 
 
 def loads(ion_str: Union[bytes, str], catalog=None, single_value=True, parse_eagerly=True,
-          text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY):
-    """Deserialize Ion value(s) from the bytes or str object. Behavior is as described by load."""
+          text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY, fields=None, batch_size=None):
+    """Deserialize Ion value(s) from the str or bytes-like object (bytes, bytearray, memoryview or mmap). Behavior is
+    as described by load. With the C extension, bytes-like objects are read in place rather than copied.
+    """
 
-    if isinstance(ion_str, bytes):
+    if isinstance(ion_str, str) and c_ext and __IS_C_EXTENSION_SUPPORTED and value_model & IonPyValueModel.LAZY:
+        ion_str = ion_str.encode('utf-8')
+    if isinstance(ion_str, _BYTES_TYPES) and c_ext and __IS_C_EXTENSION_SUPPORTED:
+        if single_value or parse_eagerly or value_model & IonPyValueModel.LAZY:
+            values = loads_extension(ion_str, catalog=catalog, single_value=single_value,
+                                     text_buffer_size_limit=text_buffer_size_limit, value_model=value_model,
+                                     fields=fields)
+            if single_value or parse_eagerly:
+                return values
+            return _batched(values, batch_size) if batch_size else iter(values)
+        # The iterator keeps the buffer pinned and reads it without going through a file object.
+        return load_extension(ion_str, catalog=catalog, single_value=single_value, parse_eagerly=parse_eagerly,
+                              text_buffer_size_limit=text_buffer_size_limit, value_model=value_model, fields=fields,
+                              batch_size=batch_size)
+    if isinstance(ion_str, _BYTES_TYPES):
         ion_buffer = BytesIO(ion_str)
     elif isinstance(ion_str, str):
         ion_buffer = io.StringIO(ion_str)
     else:
         raise TypeError('Unsupported text: %r' % ion_str)
 
-    return load(ion_buffer, catalog=catalog, single_value=single_value,
-                parse_eagerly=parse_eagerly, text_buffer_size_limit=text_buffer_size_limit, value_model=value_model)
+    return load(ion_buffer, catalog=catalog, single_value=single_value, parse_eagerly=parse_eagerly,
+                text_buffer_size_limit=text_buffer_size_limit, value_model=value_model, fields=fields,
+                batch_size=batch_size)
+
+
+def load_parallel(fp, workers=None, catalog=None, text_buffer_size_limit=None,
+                  value_model=IonPyValueModel.ION_PY, executor=None):
+    """Deserialize a stream of top-level Ion values from ``fp``, decoding parts of the stream concurrently.
+
+    A binary stream is cut at top-level value boundaries into about as many shards as there are workers; each shard
+    carries the local symbol tables in effect where it starts, so the shards are decoded independently and the values
+    are returned in stream order. Only the ion-c parse of each shard runs without the GIL, so threads overlap the
+    parsing but build the Python values one shard at a time; when building the values dominates, an ``executor`` such
+    as a ``concurrent.futures.ProcessPoolExecutor`` may be given instead.
+
+    Text Ion, or any stream when the C extension is not available, is loaded as by ``load(fp, single_value=False)``.
+
+    Args:
+        fp: a file handle or other object that implements the buffer protocol.
+        workers (Optional[int]): The number of shards to decode concurrently. Default: ``os.cpu_count()``.
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
+        text_buffer_size_limit (int): As described by load.
+        value_model (IonPyValueModel): As described by load.
+        executor (Optional[concurrent.futures.Executor]): The executor to decode the shards on. Default: a thread pool
+            with ``workers`` threads, shut down before returning.
+    Returns (list):
+        The Python objects representing the stream of Ion values.
+    """
+    data = fp.read()
+    if isinstance(data, str) or not (c_ext and __IS_C_EXTENSION_SUPPORTED) or data[:len(_IVM)] != _IVM:
+        return loads(data, catalog=catalog, single_value=False,
+                     text_buffer_size_limit=text_buffer_size_limit, value_model=value_model)
+    workers = workers or os.cpu_count() or 1
+    shards = ionc.ionc_split_binary(data, workers)
+    load_shard = partial(loads_extension, catalog=catalog, single_value=False,
+                         text_buffer_size_limit=text_buffer_size_limit, value_model=value_model)
+    if len(shards) == 1:
+        return load_shard(shards[0])
+    if executor is None:
+        with ThreadPoolExecutor(max_workers=workers) as pool:
+            return list(chain.from_iterable(pool.map(load_shard, shards)))
+    return list(chain.from_iterable(executor.map(load_shard, shards)))
+
+
+class IonColumn(NamedTuple):
+    """A column loaded by ``load_columns``, laid out as an Apache Arrow array of its type.
+
+    Attributes:
+        type (str): The column's type, as given to ``load_columns``.
+        length (int): The number of rows.
+        validity (memoryview): A bitmap of the rows that have a value, least significant bit first.
+        values (memoryview): The row values, zero for nulls; for ``'string'`` columns, their concatenated UTF-8 text.
+            ``'bool'`` values are one byte each.
+        offsets (Optional[memoryview]): For ``'string'`` columns, the ``length + 1`` int64 offsets of each row's
+            text in ``values``.
+    """
+    type: str
+    length: int
+    validity: memoryview
+    values: memoryview
+    offsets: Optional[memoryview]
+
+
+def load_columns(fp, columns, catalog=None):
+    """Deserialize a stream of top-level Ion structs from ``fp`` into typed column buffers, a row per struct.
+
+    With the C extension no Python object is created per value: the stream is read straight into contiguous buffers,
+    without holding the GIL. The buffers can be wrapped without a copy, e.g. by
+    ``numpy.frombuffer(column.values, dtype=numpy.int64)`` or by ``pyarrow.Array.from_buffers``.
+
+    A value that is null or missing, or whose path runs through a value other than a struct, is null in its column;
+    of repeated fields, the first is used. ``'int64'`` columns take Ion ints, ``'float64'`` columns floats and ints,
+    ``'bool'`` columns bools, and ``'string'`` columns strings and symbols; any other type raises an IonException, as
+    does a top-level value that is not a struct.
+
+    Args:
+        fp: a file handle or other object that implements the buffer protocol, holding text or binary Ion.
+        columns (dict): Maps each column name to a ``(path, type)`` tuple, where ``path`` is a dot-separated field
+            path, as for ``fields`` in load, and ``type`` is one of ``'int64'``, ``'float64'``, ``'bool'`` or
+            ``'string'``. No path may be a prefix of another.
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
+    Returns (dict):
+        Each column name mapped to its IonColumn.
+    """
+    schema = _column_schema(columns)
+    data = fp if isinstance(fp, _BYTES_TYPES) else fp.read()
+    if isinstance(data, str):
+        data = data.encode('utf-8')
+    if c_ext and __IS_C_EXTENSION_SUPPORTED:
+        length, buffers = ionc.ionc_read_columns(data, schema, catalog=catalog)
+    else:
+        length, buffers = _load_columns_python(data, schema, catalog)
+    return {name: IonColumn(column_type, length, *(None if buffer is None else memoryview(buffer)
+                                                   for buffer in column_buffers))
+            for (name, (_, column_type)), column_buffers in zip(columns.items(), buffers)}
+
+
+def transcode(data, binary=True, indent=None, omit_version_marker=False, catalog=None):
+    """Re-encode a stream of Ion values as binary or text Ion, e.g. to convert a ``.10n`` file to ``.ion``.
+
+    With the C extension the values go straight from an ion-c reader to an ion-c writer: no Python object is created
+    per value, and the conversion runs without holding the GIL. Otherwise the stream is loaded and dumped again.
+
+    Args:
+        data (Union[bytes|str]): The text or binary Ion to re-encode.
+        binary (Optional[True|False]): When True, outputs binary Ion. When False, outputs text Ion.
+        indent (Str): As described by dump.
+        omit_version_marker (Optional[True|False]): As described by dump.
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports of ``data``.
+    Returns:
+         Union[str|bytes]: The same values as ``data``, as described by dumps.
+    """
+    if isinstance(data, str):
+        data = data.encode('utf-8')
+    if c_ext and __IS_C_EXTENSION_SUPPORTED and (binary or _is_native_indent(indent)):
+        out = ionc.ionc_transcode(data, binary=binary, indent=None if binary else indent,
+                                  omit_version_marker=omit_version_marker, catalog=catalog)
+        return out if binary else out.decode('utf-8')
+    values = loads(data, catalog=catalog, single_value=False)
+    return dumps(values, binary=binary, sequence_as_stream=True, indent=indent,
+                 omit_version_marker=omit_version_marker)
+
+
+def _c_extension_enabled():
+    return c_ext and __IS_C_EXTENSION_SUPPORTED
+
+
+class IonFeedParser:
+    """An incremental parser for Ion that arrives in pieces, e.g. from a non-blocking socket.
+
+    Data is pushed in with ``feed`` as it arrives, which returns the top-level values completed so far and keeps the
+    state of any partial value until the next feed; nothing ever blocks waiting for more data. ``close`` marks the end
+    of the stream.
+
+    Binary Ion is read by the C extension when it is available: the complete top-level values are found from their
+    type descriptors and decoded at once, and only the local symbol tables in effect are kept between feeds. Text Ion,
+    or any Ion without the C extension, is read with the pure-Python event reader.
+
+    Notes:
+        A text value at the end of the data that could still be continued (e.g. ``12``) is returned by the feed that
+        delimits it, or by ``close``.
+
+    Args:
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
+    """
+
+    def __init__(self, catalog=None):
+        self._catalog = catalog
+        self._buffer = bytearray()  # data not yet given to a reader
+        self._binary_context = None  # with the C extension: the IVM and local symbol tables in effect
+        self._reader = None  # otherwise: the event reader, and the state of its partial values
+        self._text_reader = False  # whether the event reader is the text reader
+        self._event = None
+        self._containers = []
+        self._closed = False
+
+    def feed(self, data):
+        """Push the next piece of the stream into the parser.
+
+        Args:
+            data (bytes): The data, which may end anywhere in a value.
+        Returns (list):
+            The top-level values completed by ``data``, in stream order.
+        """
+        if self._closed:
+            raise ValueError('feed to a closed IonFeedParser')
+        if not data:
+            return []
+        if self._reader is not None:
+            return self._read_events(read_data_event(bytes(data)))
+        self._buffer += data
+        if self._binary_context is None:
+            if len(self._buffer) < len(_IVM):
+                # Too soon to tell binary from text.
+                return []
+            if self._buffer[:len(_IVM)] != _IVM or not _c_extension_enabled():
+                return self._start_reader()
+            self._binary_context = b''
+        return self._read_binary()
+
+    def close(self):
+        """Mark the end of the stream.
+
+        Returns (list):
+            The top-level values the end of the stream completes.
+        Raises:
+            IonException: If the stream ends inside a value.
+        """
+        if self._closed:
+            return []
+        self._closed = True
+        if self._binary_context is not None:
+            if self._buffer:
+                raise IonException('Stream ended inside a value.')
+            return []
+        out = self._start_reader() if self._reader is None and self._buffer else []
+        if self._reader is None:
+            return out
+        if self._event.event_type is IonEventType.INCOMPLETE:
+            if not self._text_reader:
+                # Only the text reader may still complete a value at the end of the stream.
+                raise IonException('Stream ended inside a value.')
+            out += self._read_events(NEXT_EVENT)
+        if self._event.event_type is not IonEventType.STREAM_END or self._containers:
+            raise IonException('Stream ended inside a value.')
+        return out
+
+    def _read_binary(self):
+        end, reset, symbol_tables = ionc.ionc_scan_binary(self._buffer)
+        if end == 0:
+            return []
+        values = bytes(self._buffer[:end])
+        del self._buffer[:end]
+        out = loads_extension(self._binary_context + values if self._binary_context else values,
+                              catalog=self._catalog, single_value=False)
+        context = b''.join(values[start:table_end] for start, table_end in symbol_tables)
+        self._binary_context = (_IVM + context) if reset else (self._binary_context + context)
+        return out
+
+    def _start_reader(self):
+        data = bytes(self._buffer)
+        self._buffer = None
+        self._text_reader = data[:len(_IVM)] != _IVM
+        raw_reader = text_reader() if self._text_reader else binary_reader()
+        self._reader = managed_reader(raw_reader, self._catalog)
+        self._event = self._reader.send(NEXT_EVENT)
+        return self._read_events(read_data_event(data))
+
+    def _read_events(self, data_event):
+        out = []
+        event = self._reader.send(data_event)
+        while not event.event_type.is_stream_signal:
+            if event.event_type is IonEventType.CONTAINER_START:
+                container = _FROM_ION_TYPE[event.ion_type].from_event(event)
+                self._containers.append((container, event.ion_type is IonType.STRUCT, event.field_name))
+            elif event.event_type is IonEventType.CONTAINER_END:
+                container, _, field_name = self._containers.pop()
+                self._add(out, container, field_name)
+            else:
+                if event.value is None or event.ion_type is IonType.NULL or event.ion_type.is_container:
+                    scalar = IonPyNull.from_event(event)
+                else:
+                    scalar = _FROM_ION_TYPE[event.ion_type].from_event(event)
+                self._add(out, scalar, event.field_name)
+            event = self._reader.send(NEXT_EVENT)
+        self._event = event
+        return out
+
+    def _add(self, out, obj, field_name):
+        if not self._containers:
+            out.append(obj)
+            return
+        container, in_struct, _ = self._containers[-1]
+        if in_struct:
+            container.add_item(field_name.text, obj)
+        else:
+            container.append(obj)
+
+
+async def load_async(stream, catalog=None, chunk_size=64 * 1024):
+    """Deserialize the top-level Ion values of an ``asyncio.StreamReader`` as they arrive.
+
+    The stream is read ``chunk_size`` bytes at a time into an ``IonFeedParser``, so the event loop is never blocked
+    waiting for a whole value.
+
+    Args:
+        stream: An ``asyncio.StreamReader``, or any object with a coroutine ``read(n)`` returning b'' at the end.
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
+        chunk_size (int): The most bytes to read from ``stream`` at a time.
+    Returns:
+        An asynchronous iterator over the Python objects representing the stream of Ion values.
+    """
+    parser = IonFeedParser(catalog=catalog)
+    while True:
+        data = await stream.read(chunk_size)
+        if not data:
+            break
+        for value in parser.feed(data):
+            yield value
+    for value in parser.close():
+        yield value
+
+
+def scan(fp, validate=True, offsets=False, catalog=None):
+    """Check that a stream is well-formed Ion and summarize it, without creating a Python object for any value.
+
+    Args:
+        fp: A file-like object, or the bytes or str of the stream.
+        validate (bool): When True, every value is read as ``load`` would read it. When False, scalars are stepped over
+            without being read, which only checks the structure of binary Ion but is faster.
+        offsets (bool): When True, also return the byte offset of every top-level value.
+        catalog (Optional[SymbolTableCatalog]): The catalog to use for resolving symbol table imports.
+    Returns:
+        dict: ``values``, the number of top-level values; ``total_values``, the number at every depth; ``types``,
+        the number at every depth of each IonType; ``bytes``, the bytes of the top-level values of each IonType;
+        ``max_depth``, the deepest container nesting; ``error``, None if the stream is valid, otherwise a dict of
+        the ``message``, byte ``position`` and, for text, ``line`` and ``column`` of the first error, before which
+        everything is counted; and ``offsets``, the list of top-level offsets, or None.
+
+    Notes:
+        Without the C extension, the stream is read in full by the pure-Python event reader, whatever ``validate``,
+        one byte at a time so the offsets are known; that is far slower, and the error messages are the reader's.
+    """
+    if isinstance(fp, str):
+        fp = fp.encode('utf-8')
+    if not _c_extension_enabled():
+        return _scan_python(fp, offsets, catalog)
+    return ionc.ionc_scan(fp, validate=validate, offsets=offsets, catalog=catalog)
+
+
+# Whitespace and comments, which the text reader reports as the start of a value.
+_TEXT_SKIP = re.compile(br'(?:\s+|/\*.*?\*/|//[^\n]*)*', re.S)
+
+
+def _scan_python(fp, offsets, catalog):
+    """The ``scan`` of the pure-Python event reader.
+
+    The data is fed to the raw reader a byte at a time: a top-level value starts at the byte that first takes the raw
+    reader out of its end-of-stream state after the previous top-level value, and ends where the next one starts.
+    """
+    data = fp if isinstance(fp, _BYTES_TYPES) else fp.read()
+    data = data.encode('utf-8') if isinstance(data, str) else bytes(data)
+    is_text = data[:len(_IVM)] != _IVM
+    position = -1  # of the last byte fed
+    raw_start = None  # of the top-level raw value being read
+    completed_start = None  # of the last top-level raw value completed
+
+    @coroutine
+    def tap(raw_reader):
+        nonlocal raw_start, completed_start
+        raw_event = None
+        while True:
+            raw_event = raw_reader.send((yield raw_event))
+            event_type = raw_event.event_type
+            if raw_start is None and position >= 0 and event_type is not IonEventType.STREAM_END:
+                raw_start = _TEXT_SKIP.match(data, position).end() if is_text else position
+            if raw_event.depth == 0 and event_type in (IonEventType.SCALAR, IonEventType.CONTAINER_END,
+                                                       IonEventType.VERSION_MARKER):
+                completed_start, raw_start = raw_start, None
+
+    reader = managed_reader(tap(text_reader() if is_text else binary_reader()), catalog)
+    starts, top_level_types, types = [], [], {}
+    total_values = max_depth = depth = 0
+    error = None
+
+    def read(data_event):
+        nonlocal total_values, max_depth, depth
+        event = reader.send(data_event)
+        while not event.event_type.is_stream_signal:
+            if event.event_type is IonEventType.CONTAINER_END:
+                depth -= 1
+            else:
+                total_values += 1
+                types[event.ion_type] = types.get(event.ion_type, 0) + 1
+                if event.event_type is IonEventType.CONTAINER_START:
+                    depth += 1
+                    max_depth = max(max_depth, depth)
+            if depth == 0:
+                starts.append(completed_start)
+                top_level_types.append(event.ion_type)
+            event = reader.send(NEXT_EVENT)
+        return event
+
+    try:
+        event = reader.send(NEXT_EVENT)
+        for position in range(len(data)):
+            event = read(read_data_event(data[position:position + 1]))
+        position = len(data)
+        if event.event_type is IonEventType.INCOMPLETE and is_text:
+            # The text reader completes (or rejects) a value at the end of the stream.
+            event = read(NEXT_EVENT)
+        if event.event_type is IonEventType.INCOMPLETE or depth > 0:
+            raise IonException('Stream ended inside a value.')
+    except IonException as e:
+        position = max(position, 0)
+        error = {'message': str(e), 'position': position, 'line': None, 'column': None}
+        if is_text:
+            error['line'] = data.count(b'\n', 0, position) + 1
+            error['column'] = position - data.rfind(b'\n', 0, position)
+    else:
+        position = len(data)
+
+    type_bytes = {}
+    for ion_type, start, end in zip(top_level_types, starts, starts[1:] + [position]):
+        type_bytes[ion_type] = type_bytes.get(ion_type, 0) + end - start
+    return {'values': len(starts), 'total_values': total_values, 'types': types, 'bytes': type_bytes,
+            'max_depth': max_depth, 'error': error, 'offsets': starts if offsets else None}
+
+
+def enable_c_extension_stats(enabled=True):
+    """Turn on (or off) the C extension's counters of the work done by its loads and dumps, see c_extension_stats.
+
+    They are off by default, as they cost a clock read per timed call.
+
+    Returns:
+        bool: Whether they were enabled before.
+    """
+    if not _c_extension_enabled():
+        raise IonException('The counters are only kept by the C extension.')
+    return ionc.ionc_stats_enable(enabled)
+
+
+def c_extension_stats(reset=False):
+    """Return the counters kept by the C extension since they were enabled, or last reset, across all threads.
+
+    The ``refill*`` counters cover the reads from file-like objects passed to ``load``, and ``flush*`` the writes to
+    those passed to ``dump``. ``values`` maps each IonType to the number of values of that type loaded, ``wrappers``
+    counts the IonPy objects built around them, and ``decimal_nanos`` and ``timestamp_nanos`` are the time spent
+    converting them. ``allocations`` counts the heap allocations of read buffers and temporaries.
+
+    Args:
+        reset (bool): When True, the counters are zeroed after they are read.
+    Returns:
+        dict: The counters, or None without the C extension.
+    """
+    if not _c_extension_enabled():
+        return None
+    return ionc.ionc_stats(reset=reset)
 
 
 # ... implementation from here down ...
@@ -289,6 +792,7 @@ def loads(ion_str: Union[bytes, str], catalog=None, single_value=True, parse_eag
 _ION_CONTAINER_END_EVENT = IonEvent(IonEventType.CONTAINER_END)
 _IVM = b'\xe0\x01\x00\xea'
 _TEXT_TYPES = (TextIOBase, io.StringIO)
+_BYTES_TYPES = (bytes, bytearray, memoryview, mmap.mmap)
 
 
 def dump_python(obj, fp, imports=None, binary=True, sequence_as_stream=False,
@@ -380,8 +884,19 @@ def _dump(obj, writer, from_type, field=None, in_struct=False, depth=0):
     writer.send(event)
 
 
-def load_python(fp, catalog=None, single_value=True, parse_eagerly=True):
+def load_python(fp, catalog=None, single_value=True, parse_eagerly=True, fields=None, batch_size=None):
     """'pure' Python implementation. Users should prefer to call ``load``."""
+    if batch_size and not single_value and not parse_eagerly:
+        return _batched(load_python(fp, catalog=catalog, single_value=False, parse_eagerly=False, fields=fields),
+                        batch_size)
+    if fields is not None:
+        projection = _field_projection(fields)
+        values = load_python(fp, catalog=catalog, single_value=single_value, parse_eagerly=parse_eagerly)
+        if single_value:
+            return _project(values, projection)
+        if parse_eagerly:
+            return [_project(value, projection) for value in values]
+        return (_project(value, projection) for value in values)
     if isinstance(fp, _TEXT_TYPES):
         raw_reader = text_reader(is_unicode=True)
     else:
@@ -413,6 +928,128 @@ def load_python(fp, catalog=None, single_value=True, parse_eagerly=True):
         return out
 
 
+_COLUMN_FORMATS = {'int64': 'q', 'float64': 'd', 'bool': 'B', 'string': 'B'}
+_MISSING = object()
+
+
+def _column_schema(columns):
+    """Checks the columns given to load_columns and turns them into the (path tuple, type) tuples of the C
+    extension."""
+    schema = []
+    for name, (path, column_type) in columns.items():
+        if column_type not in _COLUMN_FORMATS:
+            raise ValueError('Column %s has type %r; expected one of %s.' % (name, column_type,
+                                                                             ', '.join(_COLUMN_FORMATS)))
+        schema.append((tuple(path.split('.')), column_type))
+    paths = sorted(path for path, _ in schema)
+    for shorter, longer in zip(paths, paths[1:]):
+        if longer[:len(shorter)] == shorter:
+            raise ValueError('Column path %s is a prefix of %s.' % ('.'.join(shorter), '.'.join(longer)))
+    return schema
+
+
+def _column_lookup(value, path):
+    """Returns the first value at the path, or _MISSING."""
+    if not path:
+        return value
+    if not isinstance(value, IonPyDict):
+        return _MISSING
+    try:
+        children = value.get_all_values(path[0])
+    except KeyError:
+        return _MISSING
+    for child in children:
+        found = _column_lookup(child, path[1:])
+        if found is not _MISSING:
+            return found
+    return _MISSING
+
+
+def _column_value(column_type, value, index):
+    """Returns what a column stores for a value, None for a null, the way the C extension's ionc_column_read does."""
+    if value is _MISSING or isinstance(value, IonPyNull):
+        return None
+    ion_type = value.ion_type
+    if column_type == 'int64' and ion_type is IonType.INT:
+        if not -2 ** 63 <= value < 2 ** 63:
+            raise IonException('Column %d value %d does not fit an int64.' % (index, value))
+        return int(value)
+    if column_type == 'float64' and ion_type in (IonType.FLOAT, IonType.INT):
+        return float(value)
+    if column_type == 'bool' and ion_type is IonType.BOOL:
+        return int(value)
+    if column_type == 'string' and ion_type in (IonType.STRING, IonType.SYMBOL):
+        text = value.text if ion_type is IonType.SYMBOL else value
+        return None if text is None else text.encode('utf-8')
+    raise IonException('Column %d expects %s values.' % (index, column_type))
+
+
+def _load_columns_python(data, schema, catalog):
+    """'pure' Python implementation of ionc_read_columns, building the same buffers from loaded values."""
+    buffers = [(bytearray(), bytearray() if column_type == 'string' else array(_COLUMN_FORMATS[column_type]),
+                array('q', [0]) if column_type == 'string' else None) for _, column_type in schema]
+    length = 0
+    for row in load_python(BytesIO(bytes(data)), catalog=catalog, single_value=False, parse_eagerly=False):
+        if row.ion_type is not IonType.STRUCT:
+            raise IonException('Columns can only be read from a stream of structs.')
+        for index, ((path, column_type), (validity, values, offsets)) in enumerate(zip(schema, buffers)):
+            value = _column_value(column_type, _column_lookup(row, path), index)
+            if length % 8 == 0:
+                validity.append(0)
+            if value is not None:
+                validity[-1] |= 1 << (length % 8)
+            if offsets is not None:
+                if value is not None:
+                    values.extend(value)
+                offsets.append(len(values))
+            else:
+                values.append(0 if value is None else value)
+        length += 1
+    return length, buffers
+
+
+def _batched(values, batch_size):
+    """Groups an iterator of values into lists of up to ``batch_size`` values."""
+    values = iter(values)
+    return iter(lambda: list(islice(values, batch_size)), [])
+
+
+def _field_projection(fields):
+    """Turns dot-separated field paths into nested dicts of each field name to the projection of its value, where
+    None keeps the whole value. This is the form the C extension takes.
+    """
+    if fields is None:
+        return None
+    if isinstance(fields, str):
+        raise TypeError('fields must be an iterable of field paths, not a str')
+    projection = {}
+    for path in fields:
+        level = projection
+        names = path.split('.')
+        for name in names[:-1]:
+            if name in level and level[name] is None:
+                break  # an enclosing field is already read whole
+            level = level.setdefault(name, {})
+        else:
+            level[names[-1]] = None
+    return projection
+
+
+def _project(value, projection):
+    """Removes the fields that are not in the projection from a loaded value, the way the C extension skips them."""
+    if isinstance(value, IonPyDict):
+        for key in list(value):
+            if key not in projection:
+                del value[key]
+            elif projection[key] is not None:
+                for field_value in value.get_all_values(key):
+                    _project(field_value, projection[key])
+    elif isinstance(value, list):
+        for element in value:
+            _project(element, projection)
+    return value
+
+
 _FROM_ION_TYPE = [
     IonPyNull,
     IonPyBool,
@@ -470,21 +1107,91 @@ def _load(out, reader, end_type=IonEventType.STREAM_END, in_struct=False):
         event = reader.send(NEXT_EVENT)
 
 
-def dump_extension(obj, fp, binary=True, sequence_as_stream=False, tuple_as_sexp=False, omit_version_marker=False):
+def _is_native_indent(indent):
+    """Whether the C extension's text writer can produce ``indent``.
+
+    The C extension re-indents ion-c's text the way the Python writer pretty-prints, so it takes any indent the Python
+    writer accepts; anything else is left to the Python implementation, which raises the error.
+    """
+    return indent is None or (isinstance(indent, str) and re.search(r'\A\s*\Z', indent, re.M) is not None)
+
+
+def _native_compression(compression):
+    """Whether the C extension can compress or decompress natively; raises ValueError for an unknown compression."""
+    if compression not in ('gzip', 'zlib'):
+        raise ValueError("compression must be None, 'gzip' or 'zlib', not %r" % (compression,))
+    return c_ext and __IS_C_EXTENSION_SUPPORTED and bool(getattr(ionc, 'IONC_ZLIB', 0))
+
+
+def _decompressing_reader(fp, compression):
+    if isinstance(fp, _BYTES_TYPES):
+        fp = BytesIO(fp)
+    if compression == 'gzip':
+        return gzip.GzipFile(fileobj=fp, mode='rb')
+    return BytesIO(zlib.decompress(fp.read()))
+
+
+def _dump_compressed(obj, fp, compression, **kwargs):
+    if compression == 'gzip':
+        with gzip.GzipFile(fileobj=fp, mode='wb') as gzip_fp:
+            dump(obj, gzip_fp, **kwargs)
+    else:
+        data = BytesIO()
+        dump(obj, data, **kwargs)
+        fp.write(zlib.compress(data.getvalue()))
+
+
+def dump_extension(obj, fp, imports=None, binary=True, sequence_as_stream=False, indent=None, tuple_as_sexp=False,
+                   omit_version_marker=False, compression=None):
     """C-extension implementation. Users should prefer to call ``dump``."""
 
-    res = ionc.ionc_write(obj, binary, sequence_as_stream, tuple_as_sexp)
+    # The output is streamed to fp in fixed-size chunks as it is produced rather than buffered in full.
+    ionc.ionc_write(obj, binary, sequence_as_stream, tuple_as_sexp, fp=fp, imports=imports,
+                    indent=None if binary else indent, omit_version_marker=omit_version_marker,
+                    compression=compression)
+
+
+def dumps_extension(obj, imports=None, binary=True, sequence_as_stream=False, indent=None, tuple_as_sexp=False,
+                    omit_version_marker=False):
+    """C-extension implementation. Users should prefer to call ``dumps``.
+
+    The output is produced in memory, which lets the final encoding step run without holding the GIL.
+    """
+    data = ionc.ionc_write(obj, binary, sequence_as_stream, tuple_as_sexp, imports=imports,
+                           indent=None if binary else indent, omit_version_marker=omit_version_marker)
+    if not binary:
+        data = data.decode('utf-8')
+    return data
 
-    # TODO support "omit_version_marker" rather than hacking.
-    if not binary and not omit_version_marker:
-        res = b'$ion_1_0 ' + res
-    fp.write(res)
 
+def loads_extension(ion_bytes, catalog=None, single_value=True,
+                    text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY, fields=None):
+    """C-extension implementation. Users should prefer to call ``loads``.
 
-def load_extension(fp, single_value=True, parse_eagerly=True,
-                   text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY):
-    """C-extension implementation. Users should prefer to call ``load``."""
-    iterator = ionc.ionc_read(fp, value_model=value_model.value, text_buffer_size_limit=text_buffer_size_limit)
+    The whole buffer is parsed without holding the GIL, so other threads run while it is being read.
+    """
+    values = ionc.ionc_read_buffer(ion_bytes, value_model=value_model.value,
+                                   text_buffer_size_limit=text_buffer_size_limit, catalog=catalog,
+                                   fields=_field_projection(fields))
+    if single_value:
+        if not values:
+            return None
+        if len(values) > 1:
+            raise IonException('Stream contained more than 1 values; expected a single value.')
+        return values[0]
+    return values
+
+
+def load_extension(fp, catalog=None, single_value=True, parse_eagerly=True,
+                   text_buffer_size_limit=None, value_model=IonPyValueModel.ION_PY, fields=None, read_size=None,
+                   max_read_size=None, batch_size=None, compression=None):
+    """C-extension implementation. Users should prefer to call ``load``.
+
+    ``fp`` may also be a bytes-like object, which is read in place.
+    """
+    iterator = ionc.ionc_read(fp, value_model=value_model.value, text_buffer_size_limit=text_buffer_size_limit,
+                              catalog=catalog, fields=_field_projection(fields), read_size=read_size or 0,
+                              max_read_size=max_read_size or 0, compression=compression)
     if single_value:
         try:
             value = next(iterator)
@@ -497,5 +1204,7 @@ def load_extension(fp, single_value=True, parse_eagerly=True,
             pass
         return value
     if parse_eagerly:
-        return list(iterator)
+        return iterator.next_batch(-1)
+    if batch_size:
+        return iter(partial(iterator.next_batch, batch_size), [])
     return iterator
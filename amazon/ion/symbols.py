@@ -492,6 +492,8 @@ class SymbolTableCatalog(object):
     """
     def __init__(self):
         self.__tables = {}
+        # The C extension's copy of this catalog, built on first use.
+        self._ionc_catalog = None
 
     def register(self, table):
         """Adds a shared table to the catalog.
@@ -511,6 +513,18 @@ class SymbolTableCatalog(object):
             versions = {}
             self.__tables[table.name] = versions
         versions[table.version] = table
+        self._ionc_catalog = None
+
+    def __getstate__(self):
+        # The C extension's copy can't be pickled, e.g. to send the catalog to worker processes; it is rebuilt on use.
+        state = self.__dict__.copy()
+        state['_ionc_catalog'] = None
+        return state
+
+    def __iter__(self):
+        """Iterator over every registered table, across names and versions."""
+        for versions in self.__tables.values():
+            yield from versions.values()
 
     def resolve(self, name, version, max_id):
         """Resolves the table for a given name and version.
@@ -2,9 +2,12 @@
 # SPDX-License-Identifier: Apache-2.0
 
 import gc
+import multiprocessing
 import os
 import platform
+import sys
 import tempfile
+import threading
 import time
 import timeit
 
@@ -16,6 +19,29 @@ _pypy = platform.python_implementation() == 'PyPy'
 if not _pypy:
     import tracemalloc
 
+try:
+    import resource
+except ImportError:
+    # Not available on Windows
+    resource = None
+
+try:
+    import amazon.ion.ionc as _ionc
+except ImportError:
+    _ionc = None
+
+# Whether benchmarks that ask for the C extension actually get it.
+C_EXTENSION_AVAILABLE = _ionc is not None
+
+# The passes timed by `run_native_benchmark`, in the order the C extension runs them. `tape` and `materialize` together
+# are what a load does: reading the values into the C extension's intermediate representation, then building the Python
+# values from the last one read. Neither pass repeats the other's work.
+NATIVE_BENCHMARK_PHASES = ['parse', 'tape', 'materialize', 'serialize']
+
+# How long `_repeat_concurrently` waits at a barrier for the workers, which covers their warm-ups or one sample, before
+# it gives up on them, e.g. because a worker process was killed without breaking the barrier.
+BARRIER_TIMEOUT_SECONDS = 600
+
 
 class BenchmarkResult:
     """
@@ -24,11 +50,15 @@ class BenchmarkResult:
     nanos_per_op: SampleDist = None
     ops_per_second: SampleDist = None
     peak_memory_usage = None  # measured in bytes
+    latency_nanos: SampleDist = None  # the time of single invocations, if any were measured
+    peak_rss = None  # measured in bytes
 
-    def __init__(self, nanos_per_op, ops_per_second, peak_memory_usage):
+    def __init__(self, nanos_per_op, ops_per_second, peak_memory_usage, latency_nanos=None, peak_rss=None):
         self.nanos_per_op = SampleDist(nanos_per_op)
         self.ops_per_second = SampleDist(ops_per_second)
         self.peak_memory_usage = peak_memory_usage
+        self.latency_nanos = SampleDist(latency_nanos) if latency_nanos and len(latency_nanos) > 1 else None
+        self.peak_rss = peak_rss
 
 
 def run_benchmark(benchmark_spec: BenchmarkSpec):
@@ -48,10 +78,22 @@ def run_benchmark(benchmark_spec: BenchmarkSpec):
     differences in memory locations or other small differences from one sample to the next. This runner uses the `Timer`
     utility's `autorange()` function to determine the number of times the function must be invoked for it to run for
     at least 1 second. That number is then used as the number of invocations for _every_ sample in the set.
+
+    When the spec has more than one thread or process, each sample is the wall clock time for every worker to make
+    that many invocations at once, so `nanos_per_op` is the time per invocation seen by each worker and
+    `ops_per_second` is the throughput of all the workers together. Comparing the results for different worker counts
+    shows how well the API scales.
+
+    The samples say nothing about the spread of the time of single invocations, which matters most for small inputs.
+    If the spec asks for `latency_samples`, that many single invocations are also timed, in one thread, for the latency
+    percentiles.
     """
     test_fun = _create_test_fun(benchmark_spec)
 
     # memory profiling
+    # The peak RSS is measured first, so that it doesn't include the overhead of tracemalloc. Unlike tracemalloc, it
+    # includes the memory allocated by the C extension and ion-c.
+    peak_rss = _measure_peak_rss(test_fun)
     if _pypy:
         peak_memory_usage = None
     else:
@@ -81,13 +123,182 @@ def run_benchmark(benchmark_spec: BenchmarkSpec):
         batch_size *= 5  # ~1-2 seconds
 
     # sample collection (iterations)
-    raw_timings = timer.repeat(benchmark_spec.get_iterations(), batch_size)
+    workers = benchmark_spec.get_workers()
+    if workers == 1:
+        raw_timings = timer.repeat(benchmark_spec.get_iterations(), batch_size)
+    else:
+        raw_timings = _repeat_concurrently(benchmark_spec, test_fun, batch_size)
 
     # Normalize the samples (i.e. remove the effect of the batch size) before returning the results
     nanos_per_op = [t / batch_size for t in raw_timings]
-    ops_per_sec = [1000000000.0 / t for t in nanos_per_op]
+    ops_per_sec = [workers * 1000000000.0 / t for t in nanos_per_op]
+
+    latency_nanos = _time_invocations(test_fun, benchmark_spec.get_latency_samples(),
+                                      benchmark_spec["py_gc_disabled"])
+
+    return BenchmarkResult(nanos_per_op, ops_per_sec, peak_memory_usage, latency_nanos, peak_rss)
+
+
+def run_native_benchmark(data: bytes, iterations: int, warmups: int = 0, binary: bool = True):
+    """
+    Run the C extension's own benchmark harness over the Ion `data`.
+
+    Where `run_benchmark` times `simpleion.loads`/`dumps` as a whole, the harness times the passes they are made of
+    separately, entirely in C: the ion-c parse without any Python objects (`parse`), reading the values into the
+    intermediate representation a load builds from (`tape`), building the Python values from it (`materialize`) and
+    writing them back out (`serialize`, as Ion binary unless `binary` is False). Each pass is run `iterations` times
+    after `warmups` untimed round trips.
+
+    Returns one row per pass with the mean time per pass, cycles per input byte (None where the platform has no cycle
+    counter), values per second and the allocations the benchmarking thread made through the Python allocators per
+    pass; the allocations of other threads running at the same time are not counted.
+    """
+    if _ionc is None:
+        raise NotImplementedError("The native benchmark requires the ion-python C extension.")
+    if warmups > 0:
+        _ionc.ionc_benchmark(data, iterations=warmups, binary=binary)
+    gc.disable()
+    try:
+        result = _ionc.ionc_benchmark(data, iterations=iterations, binary=binary)
+    finally:
+        gc.enable()
+
+    rows = []
+    for phase in NATIVE_BENCHMARK_PHASES:
+        stats = result[phase]
+        nanos_per_op = stats['nanos'] / iterations
+        rows.append({
+            'phase': phase,
+            'file_size(B)': result['bytes'],
+            'values': result['values'],
+            'time_mean(ns)': nanos_per_op,
+            'cycles/B': None if stats['cycles'] is None or not result['bytes']
+            else stats['cycles'] / iterations / result['bytes'],
+            'values/s': result['values'] * 1000000000.0 / nanos_per_op if nanos_per_op else None,
+            'allocations': stats['allocations'] / iterations,
+            'allocated(B)': stats['allocated_bytes'] / iterations,
+        })
+    return rows
+
+
+def _repeat_concurrently(benchmark_spec: BenchmarkSpec, test_fun, batch_size):
+    """
+    Time `iterations` samples of `batch_size` invocations of the benchmark function in each of the spec's threads or
+    processes, and return the wall clock time in nanoseconds of each sample.
 
-    return BenchmarkResult(nanos_per_op, ops_per_sec, peak_memory_usage)
+    The workers and this thread meet at a barrier before and after every sample, so the samples don't overlap and the
+    setup and warm-ups of the workers aren't timed. Threads are timed by the barrier itself, when the last of them
+    arrives, because this thread may not get the GIL back until the workers have finished the sample. A worker that
+    fails, or that doesn't reach the barrier within BARRIER_TIMEOUT_SECONDS, stops the benchmark with an error.
+    """
+    iterations = benchmark_spec.get_iterations()
+    warmups = benchmark_spec.get_warmups()
+    gc_disabled = bool(benchmark_spec["py_gc_disabled"])
+    if benchmark_spec.get_threads() > 1:
+        workers = benchmark_spec.get_threads()
+        stamps = []
+        barrier = threading.Barrier(workers + 1, action=lambda: stamps.append(time.perf_counter_ns()))
+        errors = []
+
+        def thread_worker():
+            try:
+                _worker_loop(test_fun, barrier, warmups, batch_size, iterations)
+            except BaseException as e:
+                errors.append(e)
+                barrier.abort()
+
+        pool = [threading.Thread(target=thread_worker, daemon=True) for _ in range(workers)]
+    else:
+        workers = benchmark_spec.get_processes()
+        context = multiprocessing.get_context()
+        barrier = context.Barrier(workers + 1)
+        stamps = None
+        errors = None
+        # The test function can't be pickled, so each process creates its own from the spec.
+        pool = [context.Process(target=_process_worker, daemon=True,
+                                args=(dict(benchmark_spec), barrier, warmups, batch_size, iterations, gc_disabled))
+                for _ in range(workers)]
+
+    if gc_disabled:
+        gc.disable()
+    for worker in pool:
+        worker.start()
+    raw_timings = []
+    try:
+        for _ in range(iterations):
+            barrier.wait(BARRIER_TIMEOUT_SECONDS)
+            start = time.perf_counter_ns()
+            barrier.wait(BARRIER_TIMEOUT_SECONDS)
+            raw_timings.append(time.perf_counter_ns() - start)
+    except threading.BrokenBarrierError:
+        if errors:
+            raise errors[0]
+        raise RuntimeError(_worker_failure(pool)) from None
+    finally:
+        gc.enable()
+        for worker in pool:
+            worker.join()
+    if stamps is not None:
+        raw_timings = [end - start for (start, end) in zip(stamps[::2], stamps[1::2])]
+    return raw_timings
+
+
+def _worker_failure(pool):
+    """
+    Describe why the barrier broke without a worker thread reporting an error: the worker processes that exited, or
+    else the timeout. Worker processes that are still running are terminated, since they may never reach the barrier.
+    """
+    exited = []
+    for index, worker in enumerate(pool):
+        if isinstance(worker, threading.Thread):
+            continue
+        # A worker that raised aborts the barrier just before it exits.
+        worker.join(1)
+        if worker.exitcode is None:
+            worker.terminate()
+        elif worker.exitcode != 0:
+            exited.append("worker process %d exited with code %d" % (index, worker.exitcode))
+    if exited:
+        return "A benchmark worker failed: %s." % ", ".join(exited)
+    return "The benchmark workers did not reach the barrier within %d seconds." % BARRIER_TIMEOUT_SECONDS
+
+
+def _worker_loop(test_fun, barrier, warmups, batch_size, iterations):
+    for _ in range(warmups):
+        test_fun()
+    for _ in range(iterations):
+        barrier.wait()
+        for _ in range(batch_size):
+            test_fun()
+        barrier.wait()
+
+
+def _process_worker(spec_params, barrier, warmups, batch_size, iterations, gc_disabled):
+    try:
+        test_fun = _create_test_fun(BenchmarkSpec(spec_params))
+        if gc_disabled:
+            gc.disable()
+        _worker_loop(test_fun, barrier, warmups, batch_size, iterations)
+    except BaseException:
+        barrier.abort()
+        raise
+
+
+def _time_invocations(test_fn, count, gc_disabled):
+    """
+    Return the time in nanoseconds of each of `count` single invocations of test_fn.
+    """
+    if gc_disabled:
+        gc.disable()
+    try:
+        timings = []
+        for _ in range(count):
+            start = time.perf_counter_ns()
+            test_fn()
+            timings.append(time.perf_counter_ns() - start)
+        return timings
+    finally:
+        gc.enable()
 
 
 def _create_test_fun(benchmark_spec: BenchmarkSpec, return_obj=False, custom_file=False):
@@ -165,6 +376,43 @@ def _create_test_fun(benchmark_spec: BenchmarkSpec, return_obj=False, custom_fil
     return test_fn
 
 
+def _peak_rss():
+    """
+    Return the peak resident set size of this process in bytes, or None if the platform doesn't report it.
+    """
+    try:
+        with open('/proc/self/status') as f:
+            for line in f:
+                if line.startswith('VmHWM:'):
+                    return int(line.split()[1]) * 1024
+    except OSError:
+        pass
+    if resource is None:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # Linux reports kilobytes and macOS reports bytes
+    return peak if sys.platform == 'darwin' else peak * 1024
+
+
+def _measure_peak_rss(test_fn, *args, **kwargs):
+    """
+    Measure the peak resident set size in bytes of the process during a single invocation of test_fn.
+
+    Linux lets a process reset its peak, so there the result covers only the invocation (and what the process already
+    held). Elsewhere the peak can't be reset, so the result is the peak of the whole process so far.
+    """
+    try:
+        with open('/proc/self/clear_refs', 'w') as f:
+            f.write('5')
+    except OSError:
+        pass
+    gc.disable()
+    test_fn(*args, **kwargs)
+    peak_rss = _peak_rss()
+    gc.enable()
+    return peak_rss
+
+
 def _trace_memory_allocation(test_fn, *args, **kwargs):
     """
     Measure the memory allocations in bytes for a single invocation of test_fn
@@ -20,6 +20,9 @@ _tool_defaults = {
     'io_type': 'buffer',
     'command': 'read',
     'api': 'load_dump',
+    'threads': 1,
+    'processes': 1,
+    'latency_samples': 0,
 }
 
 
@@ -33,7 +36,7 @@ class BenchmarkSpec(dict):
     Benchmark spec files are a stream of one or more Ion structs that describe a benchmark to be run.
     
     Cross-implementation, cross-format fields include `format`, `input_file`, `command`, `api`, `iterations`, `warmups`,
-    `name`, and `io_type`.
+    `name`, `io_type`, `threads`, `processes`, and `latency_samples`.
     Implementation-specific benchmark fields should include a language prefix. For ion-python, the prefix is 'py'.
     Fields that are cross-format but specific to ion-python include `py_c_extension` and `py_gc_disabled`.
     Some data formats have format-specific fields. For example, protobuf has `protobuf_descriptor_file` and 
@@ -59,6 +62,11 @@ class BenchmarkSpec(dict):
        benchmark statistics.
      * `warmups` – the number of times the API should be invoked in order to warm up the runtime environment before
        measuring any sample runs.
+     * `threads` – the number of threads that invoke the API concurrently for each sample. Default: 1.
+     * `processes` – the number of processes that invoke the API concurrently for each sample. Default: 1. Only one of
+       `threads` and `processes` may be greater than 1.
+     * `latency_samples` – the number of single invocations of the API to time, in addition to the samples, for the
+       latency percentiles. Default: 0, which skips them.
      * `py_c_extension` – whether the C-extension should be used. (This may be ignored if C extensions are not supported
        by the currently running Python interpreter.) Default: true.
      * `py_gc_disabled` – whether garbage collection should be disabled (paused) for the duration of each benchmark
@@ -117,8 +125,17 @@ class BenchmarkSpec(dict):
             if self[k] is None:
                 raise ValueError(f"Missing required parameter '{k}'")
 
+        if self.get_threads() > 1 and self.get_processes() > 1:
+            raise ValueError("Only one of 'threads' and 'processes' may be greater than 1")
+
         if 'name' not in self:
-            self['name'] = f'({self.get_format()},{self.derive_operation_name()},{path.basename(self.get_input_file())})'
+            concurrency = ''
+            if self.get_threads() > 1:
+                concurrency = f',threads={self.get_threads()}'
+            elif self.get_processes() > 1:
+                concurrency = f',processes={self.get_processes()}'
+            self['name'] = f'({self.get_format()},{self.derive_operation_name()},{path.basename(self.get_input_file())}' \
+                           f'{concurrency})'
 
     def __missing__(self, key):
         # Instead of raising a KeyError like a usual dict, just return None.
@@ -162,6 +179,21 @@ class BenchmarkSpec(dict):
     def get_warmups(self):
         return self["warmups"]
 
+    def get_threads(self):
+        return self["threads"]
+
+    def get_processes(self):
+        return self["processes"]
+
+    def get_workers(self):
+        """
+        Get the number of concurrent invocations of the API per sample, whether they run in threads or processes.
+        """
+        return max(self.get_threads(), self.get_processes())
+
+    def get_latency_samples(self):
+        return self["latency_samples"]
+
     def derive_operation_name(self):
         match_arg = [self.get_io_type(), self.get_command(), self.get_api()]
         if match_arg == ['buffer', 'read', 'load_dump']:
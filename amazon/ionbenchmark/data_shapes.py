@@ -0,0 +1,103 @@
+# Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+A standard corpus of synthetic Ion data, one file per data shape.
+
+Each shape stresses a different part of the reader and writer: container bookkeeping (`deep_nesting`), field name
+handling (`wide_struct`), decimal conversion (`decimal_heavy`), annotation handling (`annotation_heavy`) and the fixed
+per-value overhead of many small top-level values (`small_records`). The data is generated from a fixed seed, so the
+same shape and size always produce the same values and runs against different commits stay comparable.
+"""
+import os
+import random
+from decimal import Decimal
+
+import amazon.ion.simpleion as ion
+from amazon.ion.core import IonType
+from amazon.ion.simple_types import IonPyDict, IonPyInt, IonPyList, IonPyText
+
+# ion-c limits readers to a container depth of 10 by default, so stay within it.
+_NESTING_DEPTH = 8
+_WIDE_STRUCT_FIELDS = 200
+_DECIMALS_PER_VALUE = 50
+_ANNOTATIONS_PER_VALUE = 4
+
+
+def _deep_nesting(rng, index):
+    value = {'id': index, 'leaf': rng.random()}
+    for depth in range(_NESTING_DEPTH - 1, 0, -1):
+        if depth % 2:
+            value = [depth, value]
+        else:
+            value = {'depth': depth, 'child': value}
+    return value
+
+
+def _wide_struct(rng, index):
+    value = {'id': index}
+    for i in range(_WIDE_STRUCT_FIELDS):
+        value[f'field_{i}'] = rng.randint(-1000, 1000) if i % 2 else f'value_{rng.randint(0, 1000)}'
+    return value
+
+
+def _decimal_heavy(rng, index):
+    return {
+        'id': index,
+        'amounts': [Decimal(rng.randint(-10 ** 12, 10 ** 12)).scaleb(-rng.randint(0, 12))
+                    for _ in range(_DECIMALS_PER_VALUE)],
+    }
+
+
+def _annotation_heavy(rng, index):
+    def annotations():
+        return tuple(f'tag_{rng.randint(0, 20)}' for _ in range(_ANNOTATIONS_PER_VALUE))
+
+    items = IonPyList.from_value(IonType.LIST, [
+        IonPyInt.from_value(IonType.INT, rng.randint(0, 1000), annotations()) for _ in range(10)
+    ], annotations())
+    return IonPyDict.from_value(IonType.STRUCT, {
+        'id': IonPyInt.from_value(IonType.INT, index, annotations()),
+        'name': IonPyText.from_value(IonType.STRING, f'name_{index}', annotations()),
+        'items': items,
+    }, annotations())
+
+
+def _small_records(rng, index):
+    return {'id': index, 'name': f'user_{rng.randint(0, 10 ** 6)}', 'active': rng.random() < 0.5}
+
+
+DATA_SHAPES = {
+    'deep_nesting': _deep_nesting,
+    'wide_struct': _wide_struct,
+    'decimal_heavy': _decimal_heavy,
+    'annotation_heavy': _annotation_heavy,
+    'small_records': _small_records,
+}
+
+
+def generate_data_shape(shape: str, size: int):
+    """
+    Return a list of `size` top-level values of the given data `shape`, which must be one of `DATA_SHAPES`.
+    """
+    if shape not in DATA_SHAPES:
+        raise ValueError(f"Unknown data shape '{shape}', expected one of {', '.join(DATA_SHAPES)}.")
+    rng = random.Random(shape)
+    generate = DATA_SHAPES[shape]
+    return [generate(rng, i) for i in range(size)]
+
+
+def write_corpus(output_dir: str, shapes=None, size: int = 100):
+    """
+    Write `size` top-level values of each of the given `shapes` (by default, all of them) as Ion binary to
+    `<output_dir>/<shape>.10n`, and return the paths of the files that were written, keyed by shape.
+    """
+    if not os.path.exists(output_dir):
+        os.makedirs(output_dir)
+    paths = {}
+    for shape in shapes or DATA_SHAPES:
+        file = os.path.join(output_dir, f'{shape}.10n')
+        with open(file, 'bw') as fp:
+            ion.dump(generate_data_shape(shape, size), fp, binary=True, sequence_as_stream=True)
+        paths[shape] = file
+    return paths
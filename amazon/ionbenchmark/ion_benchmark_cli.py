@@ -6,7 +6,7 @@
 """A repeatable benchmark tool for ion-python implementation.
 
 Usage:
-    ion_python_benchmark_cli.py (spec|read|write|compare) [<args>]...
+    ion_python_benchmark_cli.py (spec|read|write|compare|native|corpus) [<args>]...
     ion_python_benchmark_cli.py (-v | --version)
     ion_python_benchmark_cli.py (-h | --help)
 
@@ -23,6 +23,12 @@ Command:
     compare     Compare the benchmark results generated by benchmarking ion-python from different commits. After the
                 comparison process, relative changes of speed will be calculated and written into an Ion Struct.
 
+    native      Benchmark the C extension's parse, tape, materialize and serialize passes separately, with a harness
+                that runs in C rather than through timeit.
+
+    corpus      Generate the standard synthetic data-shape corpus and benchmark reading and writing it with and without
+                the C extension.
+
 Options:
      -h, --help                         Show this screen.
      -v, --version                      Display the tool version
@@ -35,10 +41,11 @@ import amazon.ion.simpleion as ion
 from docopt import docopt
 from tabulate import tabulate
 
-from amazon.ionbenchmark.Format import format_is_ion, rewrite_file_to_format
-from amazon.ionbenchmark.benchmark_runner import run_benchmark
+from amazon.ionbenchmark.Format import format_is_ion, format_is_binary, rewrite_file_to_format
+from amazon.ionbenchmark.benchmark_runner import run_benchmark, run_native_benchmark
 from amazon.ionbenchmark.report import report_stats, get_report_field_by_name
 from amazon.ionbenchmark.benchmark_spec import BenchmarkSpec
+from amazon.ionbenchmark.data_shapes import DATA_SHAPES, write_corpus
 
 # Relate pypy incompatible issue - https://github.com/amazon-ion/ion-python/issues/227
 pypy = platform.python_implementation() == 'PyPy'
@@ -127,7 +134,7 @@ def read_write_command(read_or_write: str):
     Run a benchmark that <read_or_write>s data.
 
     Usage:
-        ion_python_benchmark_cli.py <read_or_write> [--report <fields>] [--results-file <path>] [--api <api>]... [--iterator] [--no-c-extension] [--warmups <int>] [--iterations <int>] [--format <format>]... [--io-type <io_type>]... <input_file>
+        ion_python_benchmark_cli.py <read_or_write> [--report <fields>] [--results-file <path>] [--api <api>]... [--iterator] [--no-c-extension] [--warmups <int>] [--iterations <int>] [--threads <int> | --processes <int>] [--latency-samples <int>] [--format <format>]... [--io-type <io_type>]... <input_file>
 
     Options:
          -h, --help                         Show this screen.
@@ -145,6 +152,13 @@ def read_write_command(read_or_write: str):
 
          -i, --iterations <int>             Number of benchmark iterations. [default: 100]
 
+         --threads <int>                    Number of threads that run the benchmark concurrently. [default: 1]
+
+         --processes <int>                  Number of processes that run the benchmark concurrently. [default: 1]
+
+         --latency-samples <int>            Number of single invocations to time for the latency percentiles
+                                            (time_p50, time_p99, time_p999). [default: 0]
+
          --no-c-extension                   Disables the C extension, note that it only applies to simpleIon module.
                                             [default: False]
 
@@ -174,7 +188,10 @@ def read_write_command(read_or_write: str):
         command=read_or_write,
         iterations=iterations,
         warmups=warmups,
-        c_extension=c_extension,
+        threads=int(arguments['--threads']),
+        processes=int(arguments['--processes']),
+        latency_samples=int(arguments['--latency-samples']),
+        py_c_extension=c_extension,
         iterator=iterator,
         input_file=file,
     )
@@ -263,6 +280,142 @@ def run_spec_command():
     _run_benchmarks(specs, report_fields, output)
 
 
+def native_command():
+    """
+    Benchmark the passes of an ion-python C extension load/dump round trip separately.
+
+    The parse pass runs ion-c over the input without building any Python objects, the tape pass reads the values into
+    the C extension's intermediate representation, the materialize pass builds the Python values from it and the
+    serialize pass writes them back out. Each pass reports its mean time, cycles per input byte, values per second and
+    the allocations it makes through the Python allocators.
+
+    Usage:
+        ion_python_benchmark_cli.py native [--results-file <path>] [--warmups <int>] [--iterations <int>] [--format <format>] <input_file>
+
+    Options:
+         -h, --help                         Show this screen.
+
+         -o, --results-file <path>          Destination for the benchmark results. By default, results will be written to
+                                            stdout. Otherwise the results will be written to a file with the path <path>.
+
+         -w, --warmups <int>                Number of benchmark warm-up iterations. [default: 1]
+
+         -i, --iterations <int>             Number of benchmark iterations. [default: 100]
+
+         -f, --format <format>              Format to benchmark, from the set (ion_binary | ion_text).
+                                            [default: ion_binary]
+    """
+    arguments = docopt(native_command.__doc__, help=True)
+    format_option = arguments['--format']
+    if not format_is_ion(format_option):
+        exit(f"The native benchmark only supports ion_binary and ion_text, not {format_option}.")
+    if pypy:
+        exit("The native benchmark requires the C extension, which is not supported on PyPy.")
+
+    file = rewrite_file_to_format(arguments['<input_file>'], format_option)
+    with open(file, 'rb') as f:
+        data = f.read()
+    report = run_native_benchmark(data, int(arguments['--iterations']), int(arguments['--warmups']),
+                                  binary=format_is_binary(format_option))
+    for row in report:
+        row['format'] = format_option
+
+    print(tabulate(report, tablefmt='pipe', headers='keys', floatfmt='.2f'))
+
+    output_file = arguments['--results-file']
+    if output_file:
+        des_dir = os.path.dirname(output_file)
+        if des_dir != '' and des_dir is not None and not os.path.exists(des_dir):
+            os.makedirs(des_dir)
+        with open(output_file, 'bw') as fp:
+            ion.dump(report, fp, binary=False)
+
+
+def corpus_command():
+    """
+    Benchmark reading and writing the standard synthetic data-shape corpus, with and without the C extension.
+
+    Each data shape is written as Ion binary to <output_dir>/<shape>.10n and then benchmarked for every combination of
+    format and command, once with the C extension (where it is available) and once with the pure Python implementation,
+    so that the two can be compared side by side.
+
+    Usage:
+        ion_python_benchmark_cli.py corpus [--generate-only] [--size <int>] [--shape <shape>]... [--format <format>]... [--command <command>]... [--report <fields>] [--results-file <path>] [--warmups <int>] [--iterations <int>] [--threads <int> | --processes <int>] [--latency-samples <int>] <output_dir>
+
+    Options:
+         -h, --help                         Show this screen.
+
+         -g, --generate-only                Only write the corpus files, without running any benchmarks.
+
+         -s, --size <int>                   Number of top-level values in each file. [default: 100]
+
+         --shape <shape>                    Data shape to generate, from the set (deep_nesting | wide_struct |
+                                            decimal_heavy | annotation_heavy | small_records). May be specified multiple
+                                            times. Defaults to all of them.
+
+         -f, --format <format>              Format to benchmark, from the set (ion_binary | ion_text). May be specified
+                                            multiple times. Defaults to both.
+
+         -c, --command <command>            Command to benchmark, from the set (read | write). May be specified multiple
+                                            times. Defaults to both.
+
+         -o, --results-file <path>          Destination for the benchmark results. By default, results will be written to
+                                            stdout. Otherwise the results will be written to a file with the path <path>.
+
+         -w, --warmups <int>                Number of benchmark warm-up iterations. [default: 1]
+
+         -i, --iterations <int>             Number of benchmark iterations. [default: 100]
+
+         --threads <int>                    Number of threads that run the benchmark concurrently. [default: 1]
+
+         --processes <int>                  Number of processes that run the benchmark concurrently. [default: 1]
+
+         --latency-samples <int>            Number of single invocations to time for the latency percentiles.
+                                            [default: 100]
+
+        -r --report FIELDS      Comma-separated list of fields to include in the report. [default: c_extension,file_size,time_mean,time_p50,time_p99,time_p999,ops/s_mean,memory_usage_peak,rss_peak]
+    """
+    arguments = docopt(corpus_command.__doc__, help=True)
+    shapes = [*dict.fromkeys(arguments['--shape'])] or list(DATA_SHAPES)
+    for shape in shapes:
+        if shape not in DATA_SHAPES:
+            exit(f"Unknown data shape '{shape}'. See help for usage.")
+
+    paths = write_corpus(arguments['<output_dir>'], shapes, int(arguments['--size']))
+    if arguments['--generate-only']:
+        return
+
+    formats = [*dict.fromkeys(arguments['--format'])] or ['ion_binary', 'ion_text']
+    for format_option in formats:
+        if not format_is_ion(format_option):
+            exit(f"The corpus benchmark only supports ion_binary and ion_text, not {format_option}.")
+    commands = [*dict.fromkeys(arguments['--command'])] or ['read', 'write']
+    implementations = [False] if pypy else [True, False]
+
+    applies_to_all = dict(
+        iterations=int(arguments['--iterations']),
+        warmups=int(arguments['--warmups']),
+        threads=int(arguments['--threads']),
+        processes=int(arguments['--processes']),
+        latency_samples=int(arguments['--latency-samples']),
+    )
+
+    specs = []
+    for (shape, format_option, command, c_extension) in itertools.product(shapes, formats, commands, implementations):
+        spec = {
+            'format': format_option,
+            'command': command,
+            'input_file': paths[shape],
+            'py_c_extension': c_extension,
+        }
+        spec = BenchmarkSpec(spec, user_overrides=applies_to_all)
+        spec['name'] = f'({format_option},{spec.derive_operation_name()},{shape},' \
+                       f'{"c_extension" if c_extension else "python"})'
+        specs.append(spec)
+
+    _run_benchmarks(specs, arguments['--report'], arguments['--results-file'])
+
+
 def _run_benchmarks(specs: list, report_fields, output_file):
     """
     Run benchmarks for the `read`, `write`, and `run` commands.
@@ -323,6 +476,10 @@ def _main():
         run_spec_command()
     elif args['compare']:
         compare_command()
+    elif args['native']:
+        native_command()
+    elif args['corpus']:
+        corpus_command()
     else:
         exit(f"Invalid command. See help for usage.")
 
@@ -5,7 +5,7 @@ from collections.abc import Callable
 
 from dataclasses import dataclass
 
-from amazon.ionbenchmark.benchmark_runner import BenchmarkResult
+from amazon.ionbenchmark.benchmark_runner import BenchmarkResult, C_EXTENSION_AVAILABLE
 from amazon.ionbenchmark.benchmark_spec import BenchmarkSpec
 
 
@@ -21,6 +21,10 @@ class ReportField:
     doi: int = None
 
 
+def _latency_percentile(result: BenchmarkResult, p: float):
+    return result.latency_nanos.percentile(p) if result.latency_nanos else None
+
+
 REPORT_FIELDS = [
     # TODO: Make sure we have the fields we need to perform a statistically meaningful comparison
     # I.e. if we end up needing to use ANOVA or Independent Samples T Test, do we have the fields we need?
@@ -32,8 +36,16 @@ REPORT_FIELDS = [
                 compute_fn=lambda spec, _: spec.derive_operation_name()),
     ReportField(name="file_size", units="B", doi=-1,
                 compute_fn=lambda spec, _: spec.get_input_file_size()),
+    ReportField(name="c_extension",
+                compute_fn=lambda spec, _: C_EXTENSION_AVAILABLE and spec['py_c_extension'] is not False),
+    ReportField(name="threads",
+                compute_fn=lambda spec, _: spec.get_threads()),
+    ReportField(name="processes",
+                compute_fn=lambda spec, _: spec.get_processes()),
     ReportField(name="memory_usage_peak", units="B", doi=-1,
                 compute_fn=lambda _, result: result.peak_memory_usage),
+    ReportField(name="rss_peak", units="B", doi=-1,
+                compute_fn=lambda _, result: result.peak_rss),
     ReportField(name="time_mean", units="ns", doi=-1,
                 compute_fn=lambda _, result: result.nanos_per_op.mean),
     ReportField(name="time_min", units="ns", doi=-1,
@@ -46,6 +58,12 @@ REPORT_FIELDS = [
                 compute_fn=lambda _, result: result.nanos_per_op.rstdev * 100),
     ReportField(name="time_error", units="ns",
                 compute_fn=lambda _, result: result.nanos_per_op.margin_of_error(confidence=0.999)),
+    ReportField(name="time_p50", units="ns", doi=-1,
+                compute_fn=lambda _, result: _latency_percentile(result, 50)),
+    ReportField(name="time_p99", units="ns", doi=-1,
+                compute_fn=lambda _, result: _latency_percentile(result, 99)),
+    ReportField(name="time_p999", units="ns", doi=-1,
+                compute_fn=lambda _, result: _latency_percentile(result, 99.9)),
     ReportField(name="ops/s_mean", doi=+1,
                 compute_fn=lambda _, result: result.ops_per_second.mean),
     ReportField(name="ops/s_min", doi=+1,
@@ -78,8 +96,14 @@ def report_stats(benchmark_spec: BenchmarkSpec, benchmark_result: BenchmarkResul
      * `file_size` – the size of the input data used in this benchmark
      * `input_file` – the file used for this benchmark
      * `format` – the format used for this benchmark
-     * `memory_usage_peak` – the peak amount of memory allocated while running the benchmark function
+     * `c_extension` – whether the benchmark used the simpleion C extension
+     * `threads`, `processes` – the number of threads or processes that ran the benchmark function concurrently
+     * `memory_usage_peak` – the peak amount of memory allocated while running the benchmark function, as seen by
+       tracemalloc (which does not see allocations made by the C extension)
+     * `rss_peak` – the peak resident set size of the process while running the benchmark function
      * `time_<stat>` – time statistic for the benchmark
+     * `time_p50`, `time_p99`, `time_p999` – latency percentiles of single invocations of the benchmark function, if
+       the spec has `latency_samples`
      * `ops/s_<stat>` – number of operations (invocations of the benchmark function) per second
 
     `<stat>` can be `mean`, `min`, `max`, `median`, `error`, `stdev`, or `rstdev`
@@ -58,3 +58,13 @@ class SampleDist(list):
         """
         z_score = _unit_normal.inv_cdf((1 + confidence) / 2.)
         return z_score * self.stdev / (len(self) ** .5)
+
+    def percentile(self, p: float):
+        """
+        Return the `p`th percentile (0 to 100) of the sample set, interpolating linearly between the closest ranks.
+        """
+        ordered = sorted(self)
+        rank = (len(ordered) - 1) * p / 100.
+        lower = int(rank)
+        upper = min(lower + 1, len(ordered) - 1)
+        return ordered[lower] + (ordered[upper] - ordered[lower]) * (rank - lower)
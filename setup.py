@@ -12,16 +12,26 @@
 # specific language governing permissions and limitations under the
 # License.
 
+import os
 import sys
+import sysconfig
 from setuptools import setup, find_packages, Extension
 from install import _install_ionc
 
 C_EXT = True if not hasattr(sys, 'pypy_translation_info') else False
 
 
+def _zlib_available():
+    # Compressed streams are read and written natively when the zlib headers are installed; otherwise the pure
+    # python gzip and zlib modules are used instead.
+    include_dirs = [sysconfig.get_paths()['include'], '/usr/include', '/usr/local/include', '/opt/homebrew/include']
+    return sys.platform != 'win32' and any(os.path.exists(os.path.join(d, 'zlib.h')) for d in include_dirs)
+
+
 def run_setup():
     if C_EXT and _install_ionc():
         print('C extension is enabled!')
+        zlib = _zlib_available()
         kw = dict(
             ext_modules=[
                 Extension(
@@ -30,7 +40,8 @@ def run_setup():
                     include_dirs=['amazon/ion/ion-c-build/include',
                                   'amazon/ion/ion-c-build/include/ionc',
                                   'amazon/ion/ion-c-build/include/decNumber'],
-                    libraries=['ionc', 'decNumber'],
+                    libraries=['ionc', 'decNumber'] + (['z'] if zlib else []),
+                    define_macros=[('IONC_WITH_ZLIB', '1')] if zlib else [],
                     library_dirs=['amazon/ion/ion-c-build/lib'],
                     extra_link_args=['-Wl,-rpath,%s' % '$ORIGIN/ion-c-build/lib',  # LINUX
                                      '-Wl,-rpath,%s' % '@loader_path/ion-c-build/lib'  # MAC
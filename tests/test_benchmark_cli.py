@@ -1,4 +1,5 @@
 import os
+import threading
 import time
 from os.path import abspath, join, dirname
 
@@ -7,6 +8,7 @@ from amazon.ion.equivalence import ion_equals
 from amazon.ionbenchmark import Format, benchmark_spec
 from amazon.ionbenchmark.Format import format_is_ion, format_is_cbor, format_is_json, rewrite_file_to_format
 from amazon.ionbenchmark.benchmark_spec import BenchmarkSpec
+from amazon.ionbenchmark.data_shapes import DATA_SHAPES, generate_data_shape, write_corpus
 from amazon.ionbenchmark.ion_benchmark_cli import TOOL_VERSION
 from tests import parametrize
 
@@ -78,6 +80,75 @@ def test_option_write_iterations(file=generate_test_path('integers.ion')):
     assert not error_code
 
 
+@parametrize('ion_binary', 'ion_text')
+def test_option_native(f):
+    # This function only tests c extension
+    if not simpleion.c_ext:
+        return
+    (error_code, out, _) = run_cli(['native', generate_test_path('integers.ion'), '--format', f, '--iterations', '3'])
+    assert not error_code
+    for phase in ('parse', 'tape', 'materialize', 'serialize'):
+        assert phase in out
+
+
+def test_native_benchmark_counts_own_allocations():
+    # This function only tests c extension
+    if not simpleion.c_ext:
+        return
+    data = simpleion.dumps([{'a': [1, 'b', 2.5]}] * 100, binary=True, sequence_as_stream=True)
+    alone = simpleion.ionc.ionc_benchmark(data, iterations=3)
+    stop = threading.Event()
+
+    def allocate():
+        while not stop.is_set():
+            [str(i) for i in range(100)]
+
+    thread = threading.Thread(target=allocate)
+    thread.start()
+    try:
+        busy = simpleion.ionc.ionc_benchmark(data, iterations=3)
+    finally:
+        stop.set()
+        thread.join()
+    assert busy['values'] == alone['values'] == 100
+    # The tape is read through the raw allocator only, which has no free lists to make its counts vary.
+    assert busy['tape']['allocations'] == alone['tape']['allocations'] > 0
+    assert busy['tape']['allocated_bytes'] == alone['tape']['allocated_bytes']
+    assert alone['materialize']['allocations'] > 0
+
+
+@parametrize(
+    ('read', '--threads'),
+    ('read', '--processes'),
+    ('write', '--threads'),
+    ('write', '--processes'),
+)
+def test_option_concurrency(args):
+    (command, option) = args
+    (error_code, out, _) = run_cli([command, generate_test_path('integers.ion'), option, '2', '--iterations', '3',
+                                    '--latency-samples', '10', '-r', 'time_mean,time_p50,time_p99,time_p999,rss_peak'])
+    assert not error_code
+    assert f"{option[2:]}=2" in out
+
+
+def test_option_corpus(tmp_path):
+    (error_code, out, _) = run_cli(['corpus', str(tmp_path), '--size', '3', '--iterations', '3', '--latency-samples',
+                                    '3', '--shape', 'decimal_heavy', '--shape', 'annotation_heavy'])
+    assert not error_code
+    assert sorted(os.listdir(tmp_path)) == ['annotation_heavy.10n', 'decimal_heavy.10n']
+    assert 'python' in out
+    if simpleion.c_ext:
+        assert 'c_extension' in out
+
+
+def test_data_shapes_roundtrip(tmp_path):
+    paths = write_corpus(str(tmp_path), size=5)
+    assert sorted(paths) == sorted(DATA_SHAPES)
+    for shape, path in paths.items():
+        with open(path, 'rb') as fp:
+            assert ion_equals(simpleion.load(fp, single_value=False), generate_data_shape(shape, 5))
+
+
 # Streaming not supported yet
 # def test_read_multi_api(file=generate_test_path('integers.ion')):
 #     execution_with_command(['read', file, '--api', 'load_dump', '--api', 'streaming'])
@@ -30,7 +30,6 @@ from amazon.ion.symbols import shared_symbol_table, SymbolTableCatalog
 from amazon.ion.writer import WriteEventType, blocking_writer
 from amazon.ion.writer_binary import binary_writer
 from amazon.ion.writer_text import text_writer
-from amazon.ion.simpleion import c_ext
 
 # Tests for the Python examples in the cookbook (https://amazon-ion.github.io/ion-docs/guides/cookbook.html).
 # Changes to these tests should only be made in conjunction with changes to the cookbook examples.
@@ -190,8 +189,6 @@ def test_writing_events_blocking():
 
 
 def test_pretty_print_simpleion():
-    if c_ext:
-        return
     # https://amazon-ion.github.io/ion-docs/guides/cookbook.html#pretty-printing
     unformatted = u'{level1: {level2: {level3: "foo"}, x: 2}, y: [a,b,c]}'
     value = simpleion.loads(unformatted)
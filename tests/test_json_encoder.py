@@ -31,7 +31,7 @@ if is_pypy:
     with pytest.raises(ImportError):
         from amazon.ion.json_encoder import IonToJSONEncoder
 else:
-    from amazon.ion.json_encoder import IonToJSONEncoder
+    from amazon.ion.json_encoder import IonToJSONEncoder, ion_to_json
 
 
 def test_null():
@@ -258,3 +258,39 @@ def test_annotation_suppression():
     assert isinstance(ion_value, IonPyInt) and ion_value.ion_type == IonType.INT
     json_string = json.dumps(ion_value, cls=IonToJSONEncoder)
     assert json_string == '123'
+
+
+def test_ion_to_json():
+    if is_pypy:
+        return
+
+    ion_texts = [
+        'null.int',
+        'true',
+        '-123',
+        '123456789012345678901234567890',
+        '123.456e0',
+        'nan',
+        '-inf',
+        '123.456e34',
+        '123.456d34',
+        '-0.0',
+        '-0d0',
+        '2010-06-15T03:30:45Z',
+        '2010-06-15T03:30:45.123456789-05:30',
+        '2010T',
+        'Symbol',
+        '"tab\\t quote\\" caf\\u00e9 \\U0001F600"',
+        '{{"\\x06Ion\\x06"}}',
+        '{{SW9u}}',
+        'annotation::[a, (b 1), {c: {d: null}, "e f": [], g: {}}]',
+        '{a:1, a:2}',
+        '{a:1, b:{c:2, c:3}, a:[4], d:5, b:6}',
+    ]
+    for ion_text in ion_texts:
+        expected = json.dumps(loads(ion_text), cls=IonToJSONEncoder)
+        assert ion_to_json(ion_text) == expected
+        assert ion_to_json(dumps(loads(ion_text))) == expected
+    assert ion_to_json('1 two', single_value=False) == '[1, "two"]'
+    assert ion_to_json('', single_value=False) == '[]'
+    assert ion_to_json('') == 'null'
@@ -11,6 +11,7 @@
 # OF ANY KIND, either express or implied. See the License for the
 # specific language governing permissions and limitations under the
 # License.
+from copy import copy
 from datetime import datetime, timedelta
 from functools import partial
 from io import BytesIO, StringIO
@@ -19,21 +20,26 @@ from decimal import Decimal
 from itertools import chain
 from math import isnan
 
+import json
+import pickle
 import re
+import sys
+import zlib
 from typing import NamedTuple, Any, Sequence, Optional
 
 from pytest import raises
 
 from amazon.ion import simpleion
 from amazon.ion.exceptions import IonException
-from amazon.ion.symbols import SymbolToken, SYSTEM_SYMBOL_TABLE
+from amazon.ion.symbols import SymbolToken, SYSTEM_SYMBOL_TABLE, SymbolTableCatalog, shared_symbol_table
 from amazon.ion.writer_binary import _IVM
 from amazon.ion.core import IonType, IonEvent, IonEventType, OffsetTZInfo, Multimap, TimestampPrecision, Timestamp
 from amazon.ion.simple_types import IonPyDict, IonPyText, IonPyList, IonPyNull, IonPyBool, IonPyInt, IonPyFloat, \
-    IonPyDecimal, IonPyTimestamp, IonPyBytes, IonPySymbol, IonPyStdDict
+    IonPyDecimal, IonPyTimestamp, IonPyBytes, IonPySymbol, IonPyStdDict, IonPyLazyDict, IonPyLazyList
 from amazon.ion.equivalence import ion_equals, obj_has_ion_type_and_annotation
 from amazon.ion.simpleion import dump, dumps, load, loads, _ion_type, _FROM_ION_TYPE, _FROM_TYPE_TUPLE_AS_SEXP, \
-    _FROM_TYPE, IonPyValueModel
+    _FROM_TYPE, IonPyValueModel, load_columns, transcode, IonFeedParser, load_async, \
+    enable_c_extension_stats, c_extension_stats, scan
 from amazon.ion.writer_binary_raw import _serialize_symbol, _write_length
 from tests.writer_util import VARUINT_END_BYTE, ION_ENCODED_INT_ZERO, SIMPLE_SCALARS_MAP_BINARY, SIMPLE_SCALARS_MAP_TEXT
 from tests import parametrize
@@ -655,6 +661,8 @@ class PrettyPrintParams(NamedTuple):
             exact_text="$ion_1_0 [a,b,chair::2008-08-08T]"),
         PrettyPrintParams(ion_text='[apple, {roof: false}]', indent='\t',
             exact_text="$ion_1_0\n[\n\tapple,\n\t{\n\t\troof: false\n\t}\n]"),
+        PrettyPrintParams(ion_text='[apple, {roof: false}]', indent='\t\t',
+            exact_text="$ion_1_0\n[\n\t\tapple,\n\t\t{\n\t\t\t\troof: false\n\t\t}\n]"),
         PrettyPrintParams(ion_text='[apple, "banana", {roof: false}]', indent='\t',
             exact_text="$ion_1_0\n[\n\tapple,\n\t\"banana\",\n\t{\n\t\troof: false\n\t}\n]"),
         PrettyPrintParams(ion_text='[apple, {roof: false, walls:4, door: wood::large::true}]', indent='\t',
@@ -662,9 +670,6 @@ class PrettyPrintParams(NamedTuple):
                 "\n\t\troof: false,?\n", "\n\t\twalls: 4,?\n", "\n\t\\}\n\\]\\Z"])
         )
 def test_pretty_print(p):
-    if c_ext:
-        # TODO support pretty print for C extension.
-        return
     ion_text, indent, exact_text, regexes = p
     ion_value = loads(ion_text)
     actual_pretty_ion_text = dumps(ion_value, binary=False, indent=indent)
@@ -856,6 +861,640 @@ def test_loads_large_string():
         assert False
 
 
+@parametrize(True, False)
+def test_dump_extension_streams_to_file(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    class RecordingIO(BytesIO):
+        def __init__(self):
+            super().__init__()
+            self.write_count = 0
+
+        def write(self, b):
+            self.write_count += 1
+            return super().write(b)
+
+    data = [{"name": "value%d" % i, "blob": b"x" * 100} for i in range(5000)]
+    out = RecordingIO()
+    assert simpleion.dump_extension(data, out, binary=binary, sequence_as_stream=True) is None
+
+    # The output is larger than a single write chunk, so it must have been handed over in several writes.
+    assert out.write_count > 2
+    out.seek(0)
+    assert ion_equals(simpleion.load_extension(out, single_value=False), data)
+
+
+def test_dump_extension_propagates_write_error():
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    class FailingIO:
+        def write(self, b):
+            raise OSError("disk full")
+
+    with raises(OSError, match="disk full"):
+        simpleion.dump_extension(["a" * 100000], FailingIO(), binary=True, sequence_as_stream=True)
+
+
+@parametrize(True, False)
+def test_dump_extension_stops_writing_after_an_error(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    class RecordingIO:
+        def __init__(self, fail):
+            self.fail = fail
+            self.writes = []
+
+        def write(self, b):
+            self.writes.append(bytes(b))
+            if self.fail:
+                raise OSError("disk full")
+
+    # Once fp.write has raised, closing the writer must not hand it what ion-c still buffers.
+    out = RecordingIO(fail=True)
+    with raises(OSError, match="disk full"):
+        simpleion.dump_extension(["a" * 100000, "b"], out, binary=binary, sequence_as_stream=True)
+    assert len(out.writes) == 1
+
+    # Nor is the partial output of a value that fails to serialize written out.
+    out = RecordingIO(fail=False)
+    with raises(TypeError):
+        simpleion.dump_extension(["a", object()], out, binary=binary, sequence_as_stream=True)
+    assert out.writes == []
+
+
+@parametrize(True, False)
+def test_ionc_writer_reuse(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    writer = simpleion.ionc.Writer(binary=binary)
+    writer.write({"field": 1})
+    first = writer.flush()
+    writer.write({"field": 2})
+    writer.write((1, 2))
+    second = writer.flush()
+    rest = writer.close()
+    assert writer.close() == b''
+
+    # The symbol table context is kept across flushes, e.g. "field" is not redeclared.
+    assert len(second) < len(first) * 2
+    values = loads(first + second + rest, single_value=False)
+    assert ion_equals(values, [{"field": 1}, {"field": 2}, [1, 2]])
+
+    with raises(ValueError):
+        writer.write(1)
+
+
+def test_ionc_writer_init_once():
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    tuple_as_sexp = object()
+    writer = simpleion.ionc.Writer(binary=True, tuple_as_sexp=tuple_as_sexp)
+    refcount = sys.getrefcount(tuple_as_sexp)
+    writer.write(1)
+    with raises(TypeError):
+        writer.__init__(binary=False, tuple_as_sexp=tuple_as_sexp)
+    # Nor can a closed writer be reopened.
+    writer.close()
+    with raises(TypeError):
+        writer.__init__(binary=False, tuple_as_sexp=tuple_as_sexp)
+    assert sys.getrefcount(tuple_as_sexp) == refcount
+    with raises(ValueError):
+        writer.write(2)
+
+
+@parametrize(True, False)
+def test_ionc_writer_fails_closed(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    writer = simpleion.ionc.Writer(binary=binary)
+    writer.write({"field": 1})
+    # The value fails inside its list, where ion-c is left, so the writer can't be used after it.
+    with raises(TypeError):
+        writer.write({"field": [1, object()]})
+    with raises(ValueError, match="failed"):
+        writer.write(2)
+    with raises(ValueError, match="failed"):
+        writer.flush()
+    assert writer.close() == b''
+
+
+@parametrize(
+    ("a::null.int", IonPyNull, IonType.INT),
+    ("a::true", IonPyBool, IonType.BOOL),
+    ("a::31", IonPyInt, IonType.INT),
+    ("a::1.5e0", IonPyFloat, IonType.FLOAT),
+    ("a::1.5", IonPyDecimal, IonType.DECIMAL),
+    ("a::\"text\"", IonPyText, IonType.STRING),
+    ("a::sym", IonPySymbol, IonType.SYMBOL),
+    ("a::{{ YQ== }}", IonPyBytes, IonType.BLOB),
+    ("a::[1]", IonPyList, IonType.LIST),
+    ("a::(1)", IonPyList, IonType.SEXP),
+    ("a::{b: 1}", IonPyDict, IonType.STRUCT),
+)
+def test_ionpy_values_built_natively(params):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    ion_text, expected_type, expected_ion_type = params
+    value = simpleion.load_extension(StringIO(ion_text))
+    assert type(value) is expected_type
+    assert value.ion_type is expected_ion_type
+    assert value.ion_annotations == (SymbolToken(u'a', None),)
+    assert ion_equals(value, copy(value))
+    assert ion_equals(value, simpleion.load_python(StringIO(ion_text)))
+
+
+def test_symbol_text_reused_across_values():
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    values = simpleion.load_extension(StringIO("{abc: foo::bar} {abc: foo::bar}"), single_value=False)
+    first, second = values
+    assert next(iter(first.keys())) is next(iter(second.keys()))
+    assert first["abc"].ion_annotations[0] is second["abc"].ion_annotations[0]
+    assert ion_equals(first, second)
+
+
+@parametrize(True, False)
+def test_loads_bytes_in_threads(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    from concurrent.futures import ThreadPoolExecutor
+
+    value = [{u'id': i, u'name': u'name%d' % i, u'tags': [u'a', IonPySymbol.from_value(IonType.SYMBOL, u'b', ())],
+              u'score': Decimal('1.5'), u'big': 2 ** 70 + i, u'data': b'\x00\x01'} for i in range(200)]
+    data = dumps(value, binary=binary, sequence_as_stream=True)
+    if not binary:
+        data = data.encode('utf-8')
+
+    with ThreadPoolExecutor(max_workers=4) as executor:
+        results = list(executor.map(lambda _: loads(data, single_value=False), range(8)))
+    for result in results:
+        assert ion_equals(result, value)
+
+    assert loads(b'') is None
+    with raises(IonException):
+        loads(data)
+    with raises(IonException):
+        loads(b'{a: 1')
+
+
+def test_shared_symbol_table_round_trip():
+    table = shared_symbol_table(u'test.shared', 1, [u'shared_field', u'shared_value'])
+    catalog = SymbolTableCatalog()
+    catalog.register(table)
+    value = {u'shared_field': IonPySymbol.from_value(IonType.SYMBOL, u'shared_value', ())}
+
+    data = dumps(value, imports=[table], binary=True)
+    # Both symbols come from the import, so their text is not part of the output.
+    assert b'shared_field' not in data
+    assert ion_equals(loads(data, catalog=catalog), value)
+    # The catalog's cached native form is reused by subsequent loads.
+    assert ion_equals(loads(data, catalog=catalog), value)
+    assert ion_equals(simpleion.load_python(BytesIO(data), catalog=catalog), value)
+
+
+@parametrize(True, False)
+def test_load_parallel(binary):
+    # Concatenated streams carry different symbol tables, so each shard must pick up the context it starts in.
+    first = [{u'a%d' % i: IonPySymbol.from_value(IonType.SYMBOL, u's%d' % i, ()), u'n': [i]} for i in range(100)]
+    second = [{u'b%d' % i: i} for i in range(100)]
+    data = dumps(first, binary=binary, sequence_as_stream=True) + dumps(second, binary=binary, sequence_as_stream=True)
+    make_stream = BytesIO if binary else StringIO
+
+    for workers in (1, 3, 16):
+        assert ion_equals(simpleion.load_parallel(make_stream(data), workers=workers), first + second)
+    assert simpleion.load_parallel(make_stream(data[:0])) == []
+
+
+@parametrize(True, False)
+def test_lazy_value_model(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    ion_text = 'a::{ id: 1, id: 2, name: "x", nested: { deep: [1, (2 3), { d: 4 }] }, tags: [a, b] } [5, {e: 6}]'
+    data = dumps(loads(ion_text, single_value=False), binary=binary, sequence_as_stream=True)
+    expected = loads(data, single_value=False)
+    record, sequence = loads(data, single_value=False, value_model=IonPyValueModel.LAZY)
+
+    assert type(record) is IonPyLazyDict and type(sequence) is IonPyLazyList
+    assert record.ion_annotations[0].text == u'a' and sequence.ion_type is IonType.LIST
+    # Looked up fields are decoded on their own, and only once.
+    assert record[u'id'] == 2 and u'name' in record and u'missing' not in record and len(record) == 5
+    nested = record[u'nested']
+    assert type(nested) is IonPyLazyDict and nested is record[u'nested']
+    nested[u'deep'].append(7)
+    assert ion_equals(nested[u'deep'][1], expected[0][u'nested'][u'deep'][1])
+    assert record.get_all_values(u'id') == [1, 2]
+
+    expected[0][u'nested'][u'deep'].append(7)
+    assert ion_equals([record, sequence], expected)
+    assert ion_equals(loads(dumps([record, sequence], binary=binary, sequence_as_stream=True), single_value=False),
+                      expected)
+    assert ion_equals(pickle.loads(pickle.dumps(sequence)), expected[1])
+
+
+def test_lazy_list_is_filled():
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    lazy = loads('[1, "b", [2.5, c]]', value_model=IonPyValueModel.LAZY)
+    assert type(lazy) is IonPyLazyList and type(lazy[2]) is IonPyLazyList
+    # C code that reads the list storage directly sees the items.
+    assert json.dumps(lazy) == '[1, "b", [2.5, "c"]]'
+    assert [0] + lazy == [0, 1, u'b', [2.5, u'c']]
+    assert ','.join(loads('[a, b]', value_model=IonPyValueModel.LAZY)) == 'a,b'
+
+
+@parametrize(True, False)
+def test_load_fields(binary):
+    ion_text = 'a::{ id: 1, id: 2, skip: { x: [1, 2] }, b: { c: "c", d: true }, rows: [{ c: 1, e: 2 }, { e: 3 }] } 5'
+    data = dumps(loads(ion_text, single_value=False), binary=binary, sequence_as_stream=True)
+    expected = loads('a::{ id: 1, id: 2, b: { c: "c" }, rows: [{ c: 1 }, {}] } 5', single_value=False)
+
+    assert ion_equals(loads(data, single_value=False, fields=['id', 'b.c', 'rows.c']), expected)
+    make_stream = BytesIO if binary else StringIO
+    assert ion_equals(load(make_stream(data), single_value=False, fields=['id', 'b.c', 'rows.c']), expected)
+    assert ion_equals(list(load(make_stream(data), single_value=False, parse_eagerly=False, fields=['b', 'b.c'])),
+                      loads('a::{ b: { c: "c", d: true } } 5', single_value=False))
+
+
+@parametrize(bytearray, memoryview, 'mmap')
+def test_loads_bytes_like(bytes_type):
+    value = [{u'a': [1, u'x']}, 2, b'\x00']
+    data = dumps(value, sequence_as_stream=True)
+    if bytes_type == 'mmap':
+        import mmap
+        ion_bytes = mmap.mmap(-1, len(data))
+        ion_bytes.write(data)
+    else:
+        ion_bytes = bytes_type(data)
+
+    assert ion_equals(loads(ion_bytes, single_value=False), value)
+    assert ion_equals(list(loads(ion_bytes, single_value=False, parse_eagerly=False)), value)
+
+
+@parametrize(True, False)
+def test_loads_buffer_in_chunks(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    # Buffers longer than ion-c can read at once (2 GiB) are streamed to it in chunks. Lowering the limit reads small
+    # buffers the same way, in chunks that split values.
+    value = [{u'id': i, u'name': u'name%d' % i, u'data': b'\x01' * i, u'd': Decimal('1.5')} for i in range(50)]
+    data = dumps(value, binary=binary, sequence_as_stream=True)
+    if not binary:
+        data = data.encode('utf-8')
+    previous = simpleion.ionc.ionc_set_max_buffer_len(7)
+    try:
+        assert ion_equals(loads(data, single_value=False), value)
+        assert ion_equals(list(loads(data, single_value=False, parse_eagerly=False)), value)
+        assert ion_equals(loads(transcode(data, binary=not binary), single_value=False), value)
+        assert scan(data)[u'values'] == len(value)
+        assert load_columns(data, {u'id': (u'id', u'int64')})[u'id'].length == len(value)
+        with raises(IonException):
+            loads(data[:-3], single_value=False)
+    finally:
+        simpleion.ionc.ionc_set_max_buffer_len(previous)
+
+
+@parametrize(True, False)
+def test_load_read_size(binary):
+    # This function only tests c extension
+    if not c_ext:
+        return
+
+    value = [{u'id': i, u'name': u'néme%d' % i, u'data': b'\x01' * i} for i in range(300)]
+    data = dumps(value, binary=binary, sequence_as_stream=True)
+    make_stream = BytesIO if binary else StringIO
+
+    for read_size, max_read_size in ((7, None), (1024, None), (16, 1024 * 1024)):
+        assert ion_equals(load(make_stream(data), single_value=False, read_size=read_size,
+                               max_read_size=max_read_size), value)
+    if not binary:
+        # A binary file of text Ion is read with readinto as well.
+        assert ion_equals(load(BytesIO(data.encode('utf-8')), single_value=False, read_size=5), value)
+
+
+@parametrize(True, False)
+def test_load_batch_size(binary):
+    value = [{u'id': i} for i in range(10)] + [u'last']
+    data = dumps(value, binary=binary, sequence_as_stream=True)
+    make_stream = BytesIO if binary else StringIO
+
+    batches = list(load(make_stream(data), single_value=False, parse_eagerly=False, batch_size=4))
+    assert [len(batch) for batch in batches] == [4, 4, 3]
+    assert ion_equals(list(chain.from_iterable(batches)), value)
+    if c_ext:
+        iterator = simpleion.load_extension(make_stream(data), single_value=False, parse_eagerly=False)
+        assert ion_equals(next(iterator), value[0])
+        assert ion_equals(iterator.next_batch(2), value[1:3])
+        assert ion_equals(iterator.next_batch(-1), value[3:])
+        assert iterator.next_batch(2) == []
+
+
+@parametrize(True, False)
+def test_decimal_round_trip(binary):
+    # Covers both the decQuad fast path and the string fallback for wide coefficients and out of range exponents.
+    values = [Decimal('-0'), Decimal('0E+100'), Decimal('1.000'), Decimal('-123.456e-20'), Decimal('9' * 34),
+              Decimal('-' + '1' * 40 + 'E-3'), Decimal('1E-6176'), Decimal('1E+6111'), Decimal('1E+7000')]
+    for value in values:
+        loaded = loads(dumps(value, binary=binary))
+        assert loaded.as_tuple() == value.as_tuple()
+        loaded = loads(dumps([value], binary=binary), parse_eagerly=True, value_model=IonPyValueModel.MAY_BE_BARE)
+        assert loaded[0].as_tuple() == value.as_tuple()
+
+
+@parametrize(True, False)
+def test_timestamp_fields(binary):
+    data = u'2019-10-01T12:45:01.123456789-05:30 2019-10-01T12:45:01.100-05:30 2019-10-01T12:45:01+00:00 ' \
+           u'2019-10-01T12:45-00:00 2019-10-01T'
+    if binary:
+        data = dumps(loads(data, single_value=False), sequence_as_stream=True)
+    first, second, third, fourth, fifth = loads(data, single_value=False)
+    assert (first.microsecond, first.fractional_precision, first.fractional_seconds) == \
+           (123456, 6, Decimal('0.123456789'))
+    assert (second.microsecond, second.fractional_precision, second.fractional_seconds) == (100000, 3, Decimal('0.100'))
+    assert (third.microsecond, third.fractional_precision, third.fractional_seconds) == (0, 0, Decimal(0))
+    assert first.utcoffset() == second.utcoffset() == timedelta(hours=-5, minutes=-30)
+    assert third.utcoffset() == timedelta()
+    assert fourth.tzinfo is None and fourth.precision == TimestampPrecision.MINUTE
+    assert fifth.precision == TimestampPrecision.DAY
+    assert ion_equals(loads(dumps([first, second, third, fourth, fifth], binary=binary)),
+                      [first, second, third, fourth, fifth])
+
+
+@parametrize(True, False)
+def test_load_columns(binary):
+    data = u'{id: 1, score: 1.5e0, ok: true, user: {name: "a"}} {id: 2, score: 2, user: {name: b, name: "c"}} ' \
+           u'{id: null, ok: false, user: null} null.struct {id: 5, extra: [1], user: {name: null.string}}'
+    if binary:
+        data = dumps(loads(data, single_value=False), sequence_as_stream=True)
+    columns = load_columns(BytesIO(data) if binary else StringIO(data),
+                           {u'id': (u'id', u'int64'), u'score': (u'score', u'float64'), u'ok': (u'ok', u'bool'),
+                            u'name': (u'user.name', u'string')})
+    assert [column.length for column in columns.values()] == [5] * 4
+    assert columns[u'id'].type == u'int64'
+    assert columns[u'id'].values.tolist() == [1, 2, 0, 0, 5]
+    assert columns[u'id'].validity.tobytes() == bytes([0b10011])
+    assert columns[u'score'].values.tolist() == [1.5, 2.0, 0, 0, 0]
+    assert columns[u'score'].validity.tobytes() == bytes([0b00011])
+    assert columns[u'ok'].values.tolist() == [1, 0, 0, 0, 0]
+    assert columns[u'ok'].validity.tobytes() == bytes([0b00101])
+    name = columns[u'name']
+    assert name.offsets.tolist() == [0, 1, 2, 2, 2, 2]
+    assert name.values.tobytes() == b'ab'
+    assert name.validity.tobytes() == bytes([0b00011])
+
+    with raises(IonException):
+        load_columns(BytesIO(dumps([1], sequence_as_stream=True)), {u'id': (u'id', u'int64')})
+    with raises(IonException):
+        load_columns(BytesIO(dumps({u'id': u'x'})), {u'id': (u'id', u'int64')})
+    with raises(ValueError):
+        load_columns(BytesIO(), {u'a': (u'user', u'string'), u'b': (u'user.name', u'string')})
+    with raises(ValueError):
+        load_columns(BytesIO(), {u'id': (u'id', u'int32')})
+
+
+@parametrize(True, False)
+def test_dump_repeated_field_names(binary):
+    # Repeated field names are written by SID once the writer has assigned them one, also across periodic flushes.
+    names = [u'field%d' % i for i in range(40)]
+    record = IonPyDict()
+    record.add_item(u'id', 1)
+    record.add_item(u'id', 2)
+    record.add_item(u''.join([u'field', u'0']), u'same text, another str')
+    value = [{name: i for name in names[i % 20:i % 20 + 20]} for i in range(600)] + [record] * 3
+    out = BytesIO()
+    dump(value, out, binary=binary, sequence_as_stream=True)
+    assert ion_equals(loads(out.getvalue(), single_value=False), value)
+    assert ion_equals(loads(dumps(value, binary=binary, sequence_as_stream=True), single_value=False), value)
+
+
+@parametrize(True, False)
+def test_load_annotated_and_lob_values(binary):
+    # Annotations, lobs, big ints and wide decimals share the reader's temporary memory from value to value.
+    annotations = tuple(u'a%d' % i for i in range(20))
+    value = [IonPyBytes.from_value(IonType.BLOB, b'\x01' * 100000, annotations),
+             IonPyBytes.from_value(IonType.CLOB, b'', annotations[:1]),
+             IonPyInt.from_value(IonType.INT, 2 ** 200, annotations[:3]),
+             IonPyDecimal.from_value(IonType.DECIMAL, Decimal('1' * 50), annotations),
+             IonPyBytes.from_value(IonType.BLOB, b'\x02' * 10, annotations[:2])] * 3
+    data = dumps(value, binary=binary, sequence_as_stream=True)
+    make_stream = BytesIO if binary else StringIO
+    assert ion_equals(load(make_stream(data), single_value=False), value)
+    assert ion_equals(list(load(make_stream(data), single_value=False, parse_eagerly=False)), value)
+
+
+@parametrize('  ', '\t', '    ', '', ' \n')
+def test_pretty_print_native(indent):
+    # This function only tests c extension
+    if not c_ext:
+        return
+    value = loads('[apple, {roof: false, e: {}, l: [], s: (), walls: height::4}, (a (b "c")), {{ZmFy}}, "banana"]')
+    pretty = dumps(value, binary=False, indent=indent)
+    was_c_ext = simpleion.c_ext
+    try:
+        simpleion.c_ext = False
+        assert pretty == dumps(value, binary=False, indent=indent)
+    finally:
+        simpleion.c_ext = was_c_ext
+    assert pretty.startswith('$ion_1_0\n')
+    assert '\n' + indent + 'apple' in pretty
+    assert '\n' + indent * 2 + 'roof' in pretty
+    assert ion_equals(loads(pretty), value)
+    assert transcode(dumps(value, binary=True), binary=False, indent=indent) == pretty
+    assert not dumps(value, binary=False, indent=indent, omit_version_marker=True).startswith('$ion_1_0')
+
+    out = BytesIO()
+    dump(value, out, binary=False, indent=indent, omit_version_marker=True)
+    assert out.getvalue().decode('utf-8') == dumps(value, binary=False, indent=indent, omit_version_marker=True)
+
+
+@parametrize(True, False)
+def test_transcode(is_binary):
+    ion_text = '$ion_1_0 a::1 {b: [2.5, 3e0, "c", d::e], f: {{ZmFy}}} null.struct 2024-01-02T03:04:05.678Z'
+    expected = loads(ion_text, single_value=False)
+    for source in (ion_text, dumps(expected, binary=True, sequence_as_stream=True)):
+        out = transcode(source, binary=is_binary)
+        assert isinstance(out, bytes if is_binary else str)
+        assert ion_equals(loads(out, single_value=False), expected)
+    assert transcode(ion_text, binary=False, omit_version_marker=True)[:len('$ion_1_0')] != '$ion_1_0'
+    assert ion_equals(loads(transcode(ion_text, binary=False, indent='  '), single_value=False), expected)
+
+
+@parametrize(True, False)
+def test_feed_parser(is_binary):
+    ion_text = '$ion_1_0 a::1 {b: [2.5, 3e0, "c", d::e], f: {{ZmFy}}} null.struct 2024-01-02T03:04:05.678Z 12 (x y)'
+    expected = loads(ion_text, single_value=False)
+    data = dumps(expected, binary=True, sequence_as_stream=True) if is_binary else ion_text.encode('utf-8')
+    # A second IVM resets the symbol table context kept between feeds.
+    data += data
+    expected += expected
+    for chunk_size in (1, 3, 7, len(data)):
+        parser = IonFeedParser()
+        values = []
+        for i in range(0, len(data), chunk_size):
+            values += parser.feed(data[i:i + chunk_size])
+        values += parser.close()
+        assert ion_equals(values, expected)
+
+    parser = IonFeedParser()
+    assert parser.feed(data[:len(data) - 1]) is not None
+    with raises(IonException):
+        parser.close()
+
+    # The event readers hold the partial value themselves, and only the text reader may complete it at the end.
+    was_c_ext = simpleion.c_ext
+    try:
+        simpleion.c_ext = False
+        parser = IonFeedParser()
+        parser.feed(data[:len(data) - 1])
+        with raises(IonException):
+            parser.close()
+    finally:
+        simpleion.c_ext = was_c_ext
+
+
+def test_load_async():
+    import asyncio
+
+    class ChunkedStream:
+        def __init__(self, data):
+            self.data = data
+
+        async def read(self, n):
+            chunk, self.data = self.data[:min(n, 5)], self.data[min(n, 5):]
+            return chunk
+
+    async def load_all(data):
+        return [value async for value in load_async(ChunkedStream(data))]
+
+    expected = loads('1 two {three: [4]}', single_value=False)
+    assert ion_equals(asyncio.run(load_all(b'1 two {three: [4]}')), expected)
+    binary = dumps(expected, binary=True, sequence_as_stream=True)
+    assert ion_equals(asyncio.run(load_all(binary)), expected)
+
+
+@parametrize(True, False)
+def test_big_int_roundtrip(is_binary):
+    # Around the int64 boundary, and up to magnitudes too large for the writer's stack buffer.
+    ints = [2 ** 63 - 1, 2 ** 63, -2 ** 63, -2 ** 63 - 1, 2 ** 64, 2 ** 128 - 1, -2 ** 255 + 12345, 7 ** 400,
+            -7 ** 400]
+    data = dumps(ints, binary=is_binary)
+    assert loads(data) == ints
+    assert load(BytesIO(data) if is_binary else StringIO(data)) == ints
+    assert loads(dumps(ints, binary=is_binary, indent='  ' if not is_binary else None)) == ints
+
+
+@parametrize(True, False)
+def test_scan(is_binary):
+    values = [1, 'a', [2, {'b': Decimal('1.5')}], None]
+    data = dumps(values, binary=is_binary, sequence_as_stream=True)
+    # Without the C extension, the event reader scans the stream.
+    was_c_ext = simpleion.c_ext
+    try:
+        for use_c_ext in {was_c_ext, False}:
+            simpleion.c_ext = use_c_ext
+            for validate in (True, False):
+                for source in (data, BytesIO(data) if is_binary else StringIO(data)):
+                    result = scan(source, validate=validate, offsets=True)
+                    assert result['error'] is None
+                    assert result['values'] == 4
+                    assert result['total_values'] == 7
+                    assert result['types'] == {IonType.INT: 2, IonType.STRING: 1, IonType.LIST: 1,
+                                               IonType.STRUCT: 1, IonType.DECIMAL: 1, IonType.NULL: 1}
+                    assert result['max_depth'] == 2
+                    assert len(result['offsets']) == 4
+                    assert result['offsets'] == sorted(result['offsets'])
+                    assert set(result['bytes']) == {IonType.INT, IonType.STRING, IonType.LIST, IonType.NULL}
+            assert scan(data)['offsets'] is None
+
+            # A list that ends before its declared length, or its closing bracket.
+            truncated = scan(data + b'\xb4\x21' if is_binary else data + ' [1, 2')
+            assert truncated['error'] is not None
+            assert truncated['error']['position'] > 0
+            assert truncated['values'] >= 4
+    finally:
+        simpleion.c_ext = was_c_ext
+
+
+@parametrize(
+    (True, 'gzip'),
+    (True, 'zlib'),
+    (False, 'gzip'),
+    (False, 'zlib'),
+)
+def test_compression(params):
+    is_binary, compression = params
+    values = [1, 'a', [2, {'b': Decimal('1.5')}], None] * 100
+    out = BytesIO()
+    dump(values, out, binary=is_binary, sequence_as_stream=True, compression=compression)
+    data = out.getvalue()
+    assert data[:2] == (b'\x1f\x8b' if compression == 'gzip' else b'\x78\x9c')
+    assert ion_equals(load(BytesIO(data), single_value=False, compression=compression), values)
+    assert ion_equals(load(data, single_value=False, compression=compression), values)
+    assert ion_equals(load(BytesIO(data), single_value=False, compression=compression, read_size=7), values)
+    if compression == 'gzip' and is_binary:
+        # Appending to a .gz file adds a member.
+        assert ion_equals(load(BytesIO(data + data), single_value=False, compression=compression), values + values)
+    if not is_binary:
+        # Pretty-printed text is indented before it is compressed.
+        out = BytesIO()
+        dump(values, out, binary=False, sequence_as_stream=True, indent='  ', compression=compression)
+        pretty = dumps(values, binary=False, sequence_as_stream=True, indent='  ')
+        assert zlib.decompress(out.getvalue(), zlib.MAX_WBITS | 32).decode('utf-8') == pretty
+    # The pure python fallback raises the errors of the gzip and zlib modules.
+    with raises((IonException, EOFError, zlib.error)):
+        load(BytesIO(data[:len(data) // 2]), single_value=False, compression=compression)
+    with raises(ValueError):
+        load(BytesIO(data), compression='zstd')
+
+
+def test_c_extension_stats():
+    # This function only tests c extension
+    if not c_ext:
+        assert c_extension_stats() is None
+        return
+
+    was_enabled = enable_c_extension_stats()
+    try:
+        c_extension_stats(reset=True)
+        data = dumps([1, 2, Decimal('1.5'), loads('2024-01-02T03:04:05.678Z')], binary=True)
+        load(BytesIO(data))
+        stats = c_extension_stats(reset=True)
+        assert stats['enabled']
+        assert stats['refills'] > 0 and stats['refill_bytes'] == len(data)
+        assert stats['values'] == {IonType.LIST: 1, IonType.INT: 2, IonType.DECIMAL: 1, IonType.TIMESTAMP: 1}
+        assert stats['wrappers'] == 5
+        assert c_extension_stats()['refills'] == 0
+
+        enable_c_extension_stats(False)
+        load(BytesIO(data))
+        assert c_extension_stats()['refills'] == 0
+    finally:
+        enable_c_extension_stats(was_enabled)
+
+
 # This test ensures that the c_ext flag does not override whether the extension is actually supported.
 def test_setting_c_ext_flag():
     if not simpleion.c_ext: